@@ -5,6 +5,12 @@
 #include "Utility/ImageFile.h"
 #include "Utility/FileExplorer.h"
 #include "Compiler/ShaderCompiler.h"
+#include "Compiler/ShaderCache.h"
+#include "Compiler/ShaderCompileClient.h"
+#include "Compiler/ShaderCompileProtocol.h"
+#include "Compiler/ShaderCompileWorker.h"
+#include "Compiler/ShaderVariantCompiler.h"
+#include "Compiler/ShaderFileIncluder.h"
 #include "Core/Device.h"
 #include "Core/Swapchain.h"
 #include "Core/Shader.h"
@@ -27,9 +33,17 @@ struct Config
 	bool EnableBindingsWindow;
 	bool EnableOutputWindow;
 	bool ShowWhiteSpaces;
+	std::vector<std::string> ShaderIncludeDirectories;
+	std::string CompileServerSocket;
+	uint32_t MaxPipelineBundleCount;
 };
 
 static const std::string ConfigFilePath = GetAbsolutePath("foton.ini");
+static const std::string ShaderCacheDirectoryPath = GetAbsolutePath("ShaderCache");
+static const uint64_t ShaderCacheMaxSize = 256ull * 1024ull * 1024ull;
+static const uint32_t DefaultMaxPipelineBundleCount = 16;
+static const double IncludeCheckInterval = 1.0;
+static const uint32_t MaxShaderVariantCount = 256;
 
 static bool LoadConfig(Config& outConfig)
 {
@@ -89,6 +103,55 @@ static bool LoadConfig(Config& outConfig)
 	}
 	outConfig.ShowWhiteSpaces = showWhiteSpacesJson.GetBool();
 
+	// Optional, since it was added after the rest of the config.
+	if (documentJson.HasMember("ShaderIncludeDirectories"))
+	{
+		const rapidjson::Value& shaderIncludeDirectoriesJson = documentJson["ShaderIncludeDirectories"];
+		if (!shaderIncludeDirectoriesJson.IsArray())
+		{
+			FT_LOG("Failed parsing ShaderIncludeDirectories from config json file %s.\n", ConfigFilePath.c_str());
+			return false;
+		}
+
+		for (rapidjson::SizeType directoryIndex = 0; directoryIndex < shaderIncludeDirectoriesJson.Size(); ++directoryIndex)
+		{
+			const rapidjson::Value& directoryJson = shaderIncludeDirectoriesJson[directoryIndex];
+			if (!directoryJson.IsString())
+			{
+				FT_LOG("Failed parsing ShaderIncludeDirectories from config json file %s.\n", ConfigFilePath.c_str());
+				return false;
+			}
+
+			outConfig.ShaderIncludeDirectories.push_back(GetAbsolutePath(directoryJson.GetString()));
+		}
+	}
+
+	// Optional, empty means the default socket path of the compile server.
+	if (documentJson.HasMember("CompileServerSocket"))
+	{
+		const rapidjson::Value& compileServerSocketJson = documentJson["CompileServerSocket"];
+		if (!compileServerSocketJson.IsString())
+		{
+			FT_LOG("Failed parsing CompileServerSocket from config json file %s.\n", ConfigFilePath.c_str());
+			return false;
+		}
+
+		outConfig.CompileServerSocket = compileServerSocketJson.GetString();
+	}
+
+	// Optional, the default count is used when it's missing.
+	if (documentJson.HasMember("MaxPipelineBundleCount"))
+	{
+		const rapidjson::Value& maxPipelineBundleCountJson = documentJson["MaxPipelineBundleCount"];
+		if (!maxPipelineBundleCountJson.IsUint())
+		{
+			FT_LOG("Failed parsing MaxPipelineBundleCount from config json file %s.\n", ConfigFilePath.c_str());
+			return false;
+		}
+
+		outConfig.MaxPipelineBundleCount = maxPipelineBundleCountJson.GetUint();
+	}
+
 	return true;
 }
 
@@ -104,6 +167,19 @@ static void SaveConfig(const Config& inConfig)
 	documentJson.AddMember("EnableOutputWindow", inConfig.EnableOutputWindow, documentJson.GetAllocator());
 	documentJson.AddMember("ShowWhiteSpaces", inConfig.ShowWhiteSpaces, documentJson.GetAllocator());
 
+	rapidjson::Value shaderIncludeDirectoriesJson(rapidjson::kArrayType);
+	for (const std::string& shaderIncludeDirectory : inConfig.ShaderIncludeDirectories)
+	{
+		const std::string directoryRelativePath = GetRelativePath(shaderIncludeDirectory);
+		rapidjson::Value directoryJson(directoryRelativePath.c_str(), documentJson.GetAllocator());
+		shaderIncludeDirectoriesJson.PushBack(directoryJson, documentJson.GetAllocator());
+	}
+	documentJson.AddMember("ShaderIncludeDirectories", shaderIncludeDirectoriesJson, documentJson.GetAllocator());
+
+	rapidjson::Value compileServerSocketJson(inConfig.CompileServerSocket.c_str(), documentJson.GetAllocator());
+	documentJson.AddMember("CompileServerSocket", compileServerSocketJson, documentJson.GetAllocator());
+	documentJson.AddMember("MaxPipelineBundleCount", inConfig.MaxPipelineBundleCount, documentJson.GetAllocator());
+
 	rapidjson::StringBuffer buffer;
 	rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
 	documentJson.Accept(writer);
@@ -113,11 +189,61 @@ static void SaveConfig(const Config& inConfig)
 	WriteFile(ConfigFilePath, configJson);
 }
 
+static ShaderCompileOptions GetCompileOptions(const ShaderFile* inShaderFile)
+{
+	const std::vector<ShaderVariantDefine>& variantDefines = inShaderFile->GetVariantDefines();
+
+	ShaderCompileOptions compileOptions;
+	compileOptions.SourcePath = inShaderFile->GetPath();
+	compileOptions.OptimizationLevel = inShaderFile->GetOptimizationLevel();
+	compileOptions.Defines = ShaderVariants::GetPermutationDefines(variantDefines, ShaderVariants::GetSelectedPermutation(variantDefines));
+	return compileOptions;
+}
+
+// Precompiled shaders skip the compiler, their module only has to be validated and reflected.
+static ShaderCompileResult CompileShaderFile(const ShaderFile* inShaderFile)
+{
+	if (inShaderFile->IsPrecompiled())
+	{
+		return ShaderCompiler::LoadPrecompiled(ShaderStage::Fragment, inShaderFile->GetSpvCode());
+	}
+
+	return ShaderCompileClient::Compile(inShaderFile->GetLanguage(), ShaderStage::Fragment, inShaderFile->GetSourceCode(), GetCompileOptions(inShaderFile));
+}
+
+static void LogShaderRebuild(const Renderer* inRenderer, const ShaderRebuild inShaderRebuild)
+{
+	static const char* ShaderRebuildTexts[] = { "nothing was rebuilt", "only the pipeline was rebuilt", "descriptors and pipeline were rebuilt", "cached pipeline was restored" };
+	static_assert(sizeof(ShaderRebuildTexts) / sizeof(ShaderRebuildTexts[0]) == static_cast<size_t>(ShaderRebuild::Count), "Missing shader rebuild text.");
+
+	const ShaderRebuildStatistics statistics = inRenderer->GetShaderRebuildStatistics();
+	FT_LOG("Shader %s applied, %s (unchanged %llu, pipeline only %llu, full %llu, restored %llu).\n", inRenderer->GetFragmentShaderFile()->GetName().c_str(),
+		ShaderRebuildTexts[static_cast<size_t>(inShaderRebuild)], static_cast<unsigned long long>(statistics.Unchanged),
+		static_cast<unsigned long long>(statistics.PipelineRebuilds), static_cast<unsigned long long>(statistics.FullRebuilds),
+		static_cast<unsigned long long>(statistics.Restored));
+}
+
+static std::string GetDefinesText(const std::vector<ShaderDefine>& inDefines)
+{
+	std::string definesText;
+	for (const ShaderDefine& define : inDefines)
+	{
+		definesText += (definesText.empty() ? "" : " ") + define.Name + "=" + define.Value;
+	}
+
+	return definesText;
+}
+
 void Application::Run()
 {
 	FileExplorer::Initialize();
 	ShaderCompiler::Initialize();
+	ShaderCache::Initialize(ShaderCacheDirectoryPath, ShaderCacheMaxSize);
 
+	m_CompileWorker = new ShaderCompileWorker();
+	m_VariantCompiler = new ShaderVariantCompiler(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	m_LastIncludeCheckTime = 0.0;
+	m_MetaDataSavePending = false;
 	m_Window = new Window(this);
 	m_Renderer = nullptr;
 	m_UserInterface = nullptr;
@@ -125,17 +251,22 @@ void Application::Run()
 	std::string fragmentShaderPath;
 
 	Config loadConfig{};
+	loadConfig.MaxPipelineBundleCount = DefaultMaxPipelineBundleCount;
 	const bool configSuccessfullyLoaded = LoadConfig(loadConfig);
 	fragmentShaderPath = loadConfig.PreviousOpenShaderFile;
+	ShaderIncludes::SetSearchPaths(loadConfig.ShaderIncludeDirectories);
+	ShaderCompileClient::Initialize(loadConfig.CompileServerSocket.empty() ? ShaderCompileProtocol::GetDefaultSocketPath() : loadConfig.CompileServerSocket);
 
 	if (configSuccessfullyLoaded || FileExplorer::SaveShaderDialog(fragmentShaderPath))
 	{
 		ShaderFile* fragmentShaderFile = new ShaderFile(fragmentShaderPath);
 
 		m_Renderer = new Renderer(m_Window, fragmentShaderFile);
+		m_Renderer->SetMaxPipelineBundleCount(loadConfig.MaxPipelineBundleCount);
 		m_Renderer->TryApplyMetaData();
 
 		m_UserInterface = new UserInterface(this);
+		CompileShaderVariants(fragmentShaderFile->GetSourceCode());
 		m_UserInterface->SetEditorText(fragmentShaderFile->GetSourceCode());
 		m_UserInterface->SetEditorLanguage(fragmentShaderFile->GetLanguage());
 
@@ -167,6 +298,9 @@ void Application::Run()
 		saveConfig.EnableBindingsWindow = m_UserInterface->IsShowBindings();
 		saveConfig.EnableOutputWindow = m_UserInterface->IsShowOutput();
 		saveConfig.ShowWhiteSpaces = m_UserInterface->IsShowWhiteSpaces();
+		saveConfig.ShaderIncludeDirectories = ShaderIncludes::GetSearchPaths();
+		saveConfig.CompileServerSocket = loadConfig.CompileServerSocket;
+		saveConfig.MaxPipelineBundleCount = loadConfig.MaxPipelineBundleCount;
 
 		SaveConfig(saveConfig);
 	}
@@ -177,39 +311,228 @@ void Application::Run()
 void Application::SaveFragmentShader()
 {
 	ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
-	fragmentShaderFile->UpdateSourceCode(m_UserInterface->GetEditorText());
-	m_Renderer->SaveMetaData();
+	if (!fragmentShaderFile->IsPrecompiled())
+	{
+		fragmentShaderFile->UpdateSourceCode(m_UserInterface->GetEditorText());
+	}
+
 	FT_LOG("Shader saved to file %s.\n", fragmentShaderFile->GetPath().c_str());
 }
 
-bool Application::RecompileFragmentShader()
+void Application::RecompileFragmentShader()
 {
-	m_UserInterface->ClearErrorMarkers();
+	ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
+	if (fragmentShaderFile->IsPrecompiled())
+	{
+		ReloadPrecompiledFragmentShader();
+		return;
+	}
+
+	m_SubmittedSourceCode = m_UserInterface->GetEditorText();
 
+	// Variants of the previous source code are stale, they are compiled again once the selected one succeeds.
+	m_VariantCompiler->Cancel();
+
+	// Compilation happens in the background, while the last successfully compiled shader keeps rendering.
+	m_CompileWorker->Submit(fragmentShaderFile->GetLanguage(), ShaderStage::Fragment, m_SubmittedSourceCode, GetCompileOptions(fragmentShaderFile));
+}
+
+void Application::ReloadPrecompiledFragmentShader()
+{
 	ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
-	const std::string& fragmentShaderSourceCode = m_UserInterface->GetEditorText();
+	if (!fragmentShaderFile->ReloadSpvCode())
+	{
+		return;
+	}
 
-	const ShaderCompileResult compileResult = ShaderCompiler::Compile(fragmentShaderFile->GetLanguage(), ShaderStage::Fragment, fragmentShaderSourceCode);
+	m_UserInterface->SetEditorText(fragmentShaderFile->GetSourceCode());
 
-	if (compileResult.Status != ShaderCompileStatus::Success)
+	// Loading a module takes a fraction of a compilation, so it isn't worth a trip through the compile worker.
+	ApplyFragmentShaderCompileResult(CompileShaderFile(fragmentShaderFile));
+}
+
+void Application::SetOptimizationLevel(const ShaderOptimizationLevel inOptimizationLevel)
+{
+	ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
+	if (fragmentShaderFile->GetOptimizationLevel() == inOptimizationLevel)
 	{
-		FT_LOG("Failed %s shader %s.\n", ShaderCompiler::GetStatusText(compileResult.Status), fragmentShaderFile->GetName().c_str());
-		if (!compileResult.InfoLog.empty())
+		return;
+	}
+
+	fragmentShaderFile->SetOptimizationLevel(inOptimizationLevel);
+	FT_LOG("Shader %s optimization level set to %s.\n", fragmentShaderFile->GetName().c_str(), ShaderOptimizer::GetLevelText(inOptimizationLevel));
+
+	RecompileFragmentShader();
+}
+
+void Application::SelectShaderVariant(const uint32_t inDefineIndex, const uint32_t inValueIndex)
+{
+	ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
+	fragmentShaderFile->SelectVariantValue(inDefineIndex, inValueIndex);
+
+	const uint32_t permutationIndex = ShaderVariants::GetSelectedPermutation(fragmentShaderFile->GetVariantDefines());
+	if (!m_Renderer->SelectShaderVariant(permutationIndex))
+	{
+		// Variant is either still compiling or it failed, compiling it on its own also reports its errors.
+		RecompileFragmentShader();
+	}
+}
+
+void Application::CheckModifiedIncludes()
+{
+	const double currentTime = glfwGetTime();
+	if (currentTime - m_LastIncludeCheckTime < IncludeCheckInterval)
+	{
+		return;
+	}
+
+	m_LastIncludeCheckTime = currentTime;
+
+	const std::string fragmentShaderPath = NormalizePath(m_Renderer->GetFragmentShaderFile()->GetPath());
+	for (const std::string& modifiedFile : ShaderIncludes::GetModifiedFiles())
+	{
+		const std::vector<std::string> affectedShaders = ShaderIncludes::GetAffectedShaders(modifiedFile);
+		if (std::find(affectedShaders.begin(), affectedShaders.end(), fragmentShaderPath) != affectedShaders.end())
 		{
-			FT_LOG(compileResult.InfoLog.c_str());
-			m_UserInterface->DisplayErrorMarkers(compileResult.InfoLog);
+			FT_LOG("Included file %s changed, recompiling.\n", modifiedFile.c_str());
+			RecompileFragmentShader();
+			return;
+		}
+	}
+}
+
+void Application::ProcessCompiledFragmentShader()
+{
+	ShaderCompileResult compileResult{};
+	if (!m_CompileWorker->TryGetResult(compileResult))
+	{
+		return;
+	}
+
+	if (ApplyFragmentShaderCompileResult(compileResult))
+	{
+		CompileShaderVariants(m_SubmittedSourceCode);
+	}
+
+	// Failed compilations keep the previous shader, so its bindings are the ones saved.
+	SavePendingMetaData();
+}
+
+void Application::SavePendingMetaData()
+{
+	if (m_MetaDataSavePending)
+	{
+		m_MetaDataSavePending = false;
+		m_Renderer->SaveMetaData();
+	}
+}
+
+bool Application::ApplyFragmentShaderCompileResult(const ShaderCompileResult& inCompileResult)
+{
+	m_UserInterface->ClearErrorMarkers();
+
+	ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
+
+	if (inCompileResult.Status != ShaderCompileStatus::Success)
+	{
+		FT_LOG("Failed %s shader %s.\n", ShaderCompiler::GetStatusText(inCompileResult.Status), fragmentShaderFile->GetName().c_str());
+		if (!inCompileResult.InfoLog.empty())
+		{
+			FT_LOG(inCompileResult.InfoLog.c_str());
+
+			// Reflection and loading errors don't point to a line in the source code.
+			if (inCompileResult.Status != ShaderCompileStatus::ReflectionFailed && inCompileResult.Status != ShaderCompileStatus::LoadingFailed)
+			{
+				m_UserInterface->DisplayErrorMarkers(inCompileResult.InfoLog);
+			}
 		}
 
 		return false;
 	}
 
-	FT_LOG("Successfully compiled shader %s.\n", fragmentShaderFile->GetName().c_str());
+	if (fragmentShaderFile->IsPrecompiled())
+	{
+		FT_LOG("Successfully loaded precompiled shader %s (%llu bytes).\n", fragmentShaderFile->GetName().c_str(),
+			static_cast<unsigned long long>(sizeof(uint32_t) * inCompileResult.SpvCode.size()));
 
-	m_Renderer->OnFragmentShaderRecompiled(compileResult.SpvCode);
+		LogShaderRebuild(m_Renderer, m_Renderer->OnFragmentShaderRecompiled(inCompileResult.SpvCode));
+		return true;
+	}
+
+	const ShaderCacheStatistics cacheStatistics = ShaderCache::GetStatistics();
+	FT_LOG("Successfully compiled shader %s%s (shader cache hits %llu, misses %llu).\n", fragmentShaderFile->GetName().c_str(), inCompileResult.CacheHit ? " from cache" : "",
+		static_cast<unsigned long long>(cacheStatistics.Hits), static_cast<unsigned long long>(cacheStatistics.Misses));
+
+	if (!inCompileResult.CacheHit && fragmentShaderFile->GetOptimizationLevel() != ShaderOptimizationLevel::None)
+	{
+		FT_LOG("Optimized shader %s for %s from %llu to %llu bytes in %.2f ms.\n", fragmentShaderFile->GetName().c_str(), ShaderOptimizer::GetLevelText(fragmentShaderFile->GetOptimizationLevel()),
+			static_cast<unsigned long long>(inCompileResult.UnoptimizedSize), static_cast<unsigned long long>(sizeof(uint32_t) * inCompileResult.SpvCode.size()), inCompileResult.OptimizationTime);
+	}
+
+	if (!inCompileResult.DebugInfoPath.empty())
+	{
+		FT_LOG("Shader debug info is stored separately in %s.\n", inCompileResult.DebugInfoPath.c_str());
+	}
+
+	LogShaderRebuild(m_Renderer, m_Renderer->OnFragmentShaderRecompiled(inCompileResult.SpvCode));
 
 	return true;
 }
 
+void Application::CompileShaderVariants(const std::string& inSourceCode)
+{
+	const ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
+	const std::vector<ShaderVariantDefine>& variantDefines = fragmentShaderFile->GetVariantDefines();
+
+	if (variantDefines.empty())
+	{
+		m_VariantCompiler->Cancel();
+		return;
+	}
+
+	const uint32_t permutationCount = ShaderVariants::GetPermutationCount(variantDefines);
+	if (permutationCount > MaxShaderVariantCount)
+	{
+		FT_LOG("Shader %s has %u variants, which is more than the supported %u, variants won't be compiled.\n",
+			fragmentShaderFile->GetName().c_str(), permutationCount, MaxShaderVariantCount);
+		m_VariantCompiler->Cancel();
+		return;
+	}
+
+	// Every permutation adds its own defines on top of these options.
+	ShaderCompileOptions compileOptions = GetCompileOptions(fragmentShaderFile);
+	compileOptions.Defines.clear();
+
+	m_VariantCompiler->Submit(fragmentShaderFile->GetLanguage(), ShaderStage::Fragment, inSourceCode, compileOptions, variantDefines);
+}
+
+void Application::ProcessCompiledShaderVariants()
+{
+	std::vector<ShaderVariantResult> variantResults;
+	if (!m_VariantCompiler->TryGetResults(variantResults))
+	{
+		return;
+	}
+
+	const ShaderFile* fragmentShaderFile = m_Renderer->GetFragmentShaderFile();
+
+	uint32_t failedVariantCount = 0;
+	for (const ShaderVariantResult& variantResult : variantResults)
+	{
+		if (variantResult.CompileResult.Status != ShaderCompileStatus::Success)
+		{
+			FT_LOG("Failed %s variant %s of shader %s.\n", ShaderCompiler::GetStatusText(variantResult.CompileResult.Status),
+				GetDefinesText(variantResult.Defines).c_str(), fragmentShaderFile->GetName().c_str());
+			++failedVariantCount;
+		}
+	}
+
+	m_Renderer->UpdateShaderVariants(variantResults);
+
+	FT_LOG("Compiled %u variants of shader %s into %u unique modules, %u failed.\n", static_cast<uint32_t>(variantResults.size()),
+		fragmentShaderFile->GetName().c_str(), m_Renderer->GetUniqueShaderVariantCount(), failedVariantCount);
+}
+
 void Application::NewShader(const std::string& inPath)
 {
 	ShaderFile* newShaderFile = new ShaderFile(inPath);
@@ -217,11 +540,23 @@ void Application::NewShader(const std::string& inPath)
 	const char* defaultFragmentShader = GetDefaultFragmentShader(newShaderFile->GetLanguage());
 	newShaderFile->UpdateSourceCode(defaultFragmentShader);
 
+	// Save which is still waiting for its compilation belongs to the current file, so it's written before the file is replaced.
+	SavePendingMetaData();
+
 	m_Renderer->UpdateFragmentShaderFile(newShaderFile);
 	m_UserInterface->SetEditorText(newShaderFile->GetSourceCode());
 	m_UserInterface->SetEditorLanguage(newShaderFile->GetLanguage());
 
-	RecompileFragmentShader();
+	// Meta data is saved right away, so the new shader has to be compiled synchronously and any pending result dropped.
+	m_CompileWorker->Cancel();
+	m_VariantCompiler->Cancel();
+
+	const ShaderCompileResult compileResult = CompileShaderFile(newShaderFile);
+	if (ApplyFragmentShaderCompileResult(compileResult))
+	{
+		CompileShaderVariants(newShaderFile->GetSourceCode());
+	}
+
 	m_Renderer->SaveMetaData();
 
 	FT_LOG("New shader file %s created.\n", inPath.c_str());
@@ -229,27 +564,46 @@ void Application::NewShader(const std::string& inPath)
 
 void Application::LoadShader(const std::string& inPath)
 {
+	const auto loadStartTime = std::chrono::high_resolution_clock::now();
+
 	ShaderFile* loadedShaderFile = new ShaderFile(inPath);
-	const ShaderCompileResult compileResult = ShaderCompiler::Compile(loadedShaderFile->GetLanguage(), ShaderStage::Fragment, loadedShaderFile->GetSourceCode());
+
+	const ShaderCompileResult compileResult = CompileShaderFile(loadedShaderFile);
 
 	if (compileResult.Status != ShaderCompileStatus::Success)
 	{
 		FT_LOG("Failed %s for loaded shader %s.\n", ShaderCompiler::GetStatusText(compileResult.Status), loadedShaderFile->GetName().c_str());
+		if (!compileResult.InfoLog.empty())
+		{
+			FT_LOG(compileResult.InfoLog.c_str());
+		}
+
+		delete(loadedShaderFile);
 		return;
 	}
 
+	// Results which are still compiling belong to the previous shader.
+	m_CompileWorker->Cancel();
+	m_VariantCompiler->Cancel();
+	SavePendingMetaData();
+
 	m_Renderer->UpdateFragmentShaderFile(loadedShaderFile);
 	m_UserInterface->SetEditorText(loadedShaderFile->GetSourceCode());
 	m_UserInterface->SetEditorLanguage(loadedShaderFile->GetLanguage());
+	m_UserInterface->ClearErrorMarkers();
 
-	RecompileFragmentShader();
+	// Source was already compiled above, so there is no need to run it through the compiler again.
+	m_Renderer->OnFragmentShaderRecompiled(compileResult.SpvCode);
 
 	if (!m_Renderer->TryApplyMetaData())
 	{
 		FT_LOG("Failed parsing meta data.");
 	}
 
-	FT_LOG("Shader file %s loaded.\n", inPath.c_str());
+	CompileShaderVariants(loadedShaderFile->GetSourceCode());
+
+	const auto loadEndTime = std::chrono::high_resolution_clock::now();
+	FT_LOG("Shader file %s loaded in %.2f ms.\n", inPath.c_str(), std::chrono::duration<double, std::milli>(loadEndTime - loadStartTime).count());
 }
 
 void Application::UpdateCodeFontSize(float inOffset) const
@@ -282,12 +636,29 @@ void Application::OpenShaderMenuItem()
 
 void Application::SaveShaderMenuItem()
 {
-	RecompileFragmentShader();
 	SaveFragmentShader();
+	RecompileFragmentShader();
+
+	// Meta data describes the bindings of the saved shader, so it's written once the recompiled shader is applied.
+	// Precompiled modules are applied right away, source code is compiled in the background.
+	if (m_Renderer->GetFragmentShaderFile()->IsPrecompiled())
+	{
+		m_Renderer->SaveMetaData();
+	}
+	else
+	{
+		m_MetaDataSavePending = true;
+	}
 }
 
 void Application::SaveAsShaderMenuItem()
 {
+	if (m_Renderer->GetFragmentShaderFile()->IsPrecompiled())
+	{
+		FT_LOG("Precompiled SPIR-V shaders can't be saved as a new file.\n");
+		return;
+	}
+
 	ShaderFileExtension currentShaderFileExtension;
 	ShaderLanguage currentShaderLanguage = m_Renderer->GetFragmentShaderFile()->GetLanguage();
 	for (const auto& supportedShaderFileExtension : g_SupportedShaderFileExtensions)
@@ -319,6 +690,11 @@ void Application::MainLoop()
 	{
 		glfwPollEvents();
 
+		// Swapping the shader between frames, so a frame is never recorded with a half updated pipeline.
+		CheckModifiedIncludes();
+		ProcessCompiledFragmentShader();
+		ProcessCompiledShaderVariants();
+
 		m_UserInterface->ImguiNewFrame();
 
 		m_Renderer->DrawFrame();
@@ -332,6 +708,10 @@ void Application::Cleanup()
 	delete(m_UserInterface);
 	delete(m_Renderer);
 	delete(m_Window);
+	delete(m_VariantCompiler);
+	delete(m_CompileWorker);
+	ShaderCompileClient::Finalize();
+	ShaderCache::Finalize();
 	ShaderCompiler::Finalize();
 	FileExplorer::Terminate();
 }
@@ -6,6 +6,10 @@ class Window;
 class FileExplorer;
 class Renderer;
 class UserInterface;
+class ShaderCompileWorker;
+class ShaderVariantCompiler;
+struct ShaderCompileResult;
+enum class ShaderOptimizationLevel : uint8_t;
 
 class Application
 {
@@ -18,7 +22,9 @@ public:
 
 public:
 	void SaveFragmentShader();
-	bool RecompileFragmentShader();
+	void RecompileFragmentShader();
+	void SetOptimizationLevel(const ShaderOptimizationLevel inOptimizationLevel);
+	void SelectShaderVariant(const uint32_t inDefineIndex, const uint32_t inValueIndex);
 	void NewShader(const std::string& inPath);
 	void LoadShader(const std::string& inPath);
 	void UpdateCodeFontSize(float inOffset) const;
@@ -38,11 +44,23 @@ public:
 private:
 	void MainLoop();
 	void Cleanup();
+	void CheckModifiedIncludes();
+	void ProcessCompiledFragmentShader();
+	void SavePendingMetaData();
+	void ReloadPrecompiledFragmentShader();
+	bool ApplyFragmentShaderCompileResult(const ShaderCompileResult& inCompileResult);
+	void CompileShaderVariants(const std::string& inSourceCode);
+	void ProcessCompiledShaderVariants();
 
 private:
 	Window* m_Window;
 	Renderer* m_Renderer;
 	UserInterface* m_UserInterface;
+	ShaderCompileWorker* m_CompileWorker;
+	ShaderVariantCompiler* m_VariantCompiler;
+	std::string m_SubmittedSourceCode;
+	double m_LastIncludeCheckTime;
+	bool m_MetaDataSavePending;
 };
 
 FT_END_NAMESPACE
@@ -0,0 +1,477 @@
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "Utility/Hash.hpp"
+#include "Utility/BinaryStream.hpp"
+
+FT_BEGIN_NAMESPACE
+
+namespace ShaderCache
+{
+	static const uint32_t CacheFileMagic = 0x43535446; // "FTSC"
+	static const uint32_t CacheFileVersion = 2;
+	static const std::string CacheFileExtension = "spvcache";
+	static const std::string DebugInfoFileExtension = "spvdebug";
+	static const std::string TemporaryFileExtension = "tmp";
+	static const int64_t StaleTemporaryFileAge = 60 * 60;
+
+	struct CacheFileHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint64_t Key;
+		uint64_t PayloadSize;
+		uint64_t PayloadHash;
+	};
+
+	static std::string s_Directory;
+	static uint64_t s_MaxSize = 0;
+	static bool s_Enabled = false;
+	static std::mutex s_TrimMutex;
+	static uint64_t s_EstimatedSize = 0;
+	static std::atomic<uint64_t> s_Hits(0);
+	static std::atomic<uint64_t> s_Misses(0);
+	static std::atomic<uint64_t> s_Stores(0);
+	static std::atomic<uint64_t> s_Evictions(0);
+	static std::atomic<uint64_t> s_MemoryHits(0);
+
+	struct MemoryEntry
+	{
+		std::string KeySource;
+		ShaderCompileResult Result;
+		uint64_t Size = 0;
+		std::list<uint64_t>::iterator RecentIterator;
+	};
+
+	static std::mutex s_MemoryMutex;
+	static uint64_t s_MemoryBudget = 0;
+	static uint64_t s_MemorySize = 0;
+	static std::map<uint64_t, MemoryEntry> s_MemoryEntries;
+	static std::list<uint64_t> s_RecentMemoryEntries;
+
+	static std::string SerializeEntry(const uint64_t inKey, const std::string& inKeySource, const ShaderCompileResult& inResult)
+	{
+		std::string payload;
+
+		WriteBinaryString(payload, inKeySource);
+
+		WriteBinaryValue(payload, static_cast<uint32_t>(inResult.SpvCode.size()));
+		payload.append(reinterpret_cast<const char*>(inResult.SpvCode.data()), sizeof(uint32_t) * inResult.SpvCode.size());
+
+		WriteBinaryValue(payload, static_cast<uint32_t>(inResult.BindingLayouts.size()));
+		for (const BindingLayout& bindingLayout : inResult.BindingLayouts)
+		{
+			WriteBinaryValue(payload, bindingLayout.Set);
+			WriteBinaryValue(payload, bindingLayout.Binding);
+			WriteBinaryValue(payload, static_cast<uint32_t>(bindingLayout.DescriptorType));
+			WriteBinaryValue(payload, bindingLayout.DescriptorCount);
+			WriteBinaryString(payload, bindingLayout.Name);
+		}
+
+		WriteBinaryString(payload, inResult.InfoLog);
+
+		CacheFileHeader header{};
+		header.Magic = CacheFileMagic;
+		header.Version = CacheFileVersion;
+		header.Key = inKey;
+		header.PayloadSize = payload.size();
+		header.PayloadHash = HashString(payload);
+
+		std::string fileBuffer;
+		fileBuffer.reserve(sizeof(CacheFileHeader) + payload.size());
+		WriteBinaryValue(fileBuffer, header);
+		fileBuffer.append(payload);
+
+		return fileBuffer;
+	}
+
+	static bool DeserializeEntry(const uint64_t inKey, const std::string& inKeySource, const std::string& inFileBuffer, ShaderCompileResult& outResult)
+	{
+		size_t offset = 0;
+
+		CacheFileHeader header{};
+		if (!ReadBinaryValue(inFileBuffer, offset, header) ||
+			header.Magic != CacheFileMagic ||
+			header.Version != CacheFileVersion ||
+			header.Key != inKey ||
+			header.PayloadSize != inFileBuffer.size() - offset)
+		{
+			return false;
+		}
+
+		// Protects against entries which were truncated or corrupted outside of the rename protocol.
+		const std::string payload = inFileBuffer.substr(offset);
+		if (HashString(payload) != header.PayloadHash)
+		{
+			return false;
+		}
+
+		offset = 0;
+
+		std::string keySource;
+		if (!ReadBinaryString(payload, offset, keySource) || keySource != inKeySource)
+		{
+			return false;
+		}
+
+		uint32_t spvWordCount = 0;
+		if (!ReadBinaryValue(payload, offset, spvWordCount) || offset + sizeof(uint32_t) * spvWordCount > payload.size())
+		{
+			return false;
+		}
+
+		outResult.SpvCode.resize(spvWordCount);
+		memcpy(outResult.SpvCode.data(), payload.data() + offset, sizeof(uint32_t) * spvWordCount);
+		offset += sizeof(uint32_t) * spvWordCount;
+
+		uint32_t bindingCount = 0;
+		if (!ReadBinaryValue(payload, offset, bindingCount))
+		{
+			return false;
+		}
+
+		outResult.BindingLayouts.resize(bindingCount);
+		for (BindingLayout& bindingLayout : outResult.BindingLayouts)
+		{
+			uint32_t descriptorType = 0;
+			if (!ReadBinaryValue(payload, offset, bindingLayout.Set) ||
+				!ReadBinaryValue(payload, offset, bindingLayout.Binding) ||
+				!ReadBinaryValue(payload, offset, descriptorType) ||
+				!ReadBinaryValue(payload, offset, bindingLayout.DescriptorCount) ||
+				!ReadBinaryString(payload, offset, bindingLayout.Name))
+			{
+				return false;
+			}
+
+			bindingLayout.DescriptorType = static_cast<VkDescriptorType>(descriptorType);
+		}
+
+		return ReadBinaryString(payload, offset, outResult.InfoLog);
+	}
+
+	static uint64_t GetMemoryEntrySize(const std::string& inKeySource, const ShaderCompileResult& inResult)
+	{
+		uint64_t size = inKeySource.size() + sizeof(uint32_t) * inResult.SpvCode.size() + inResult.InfoLog.size();
+		for (const BindingLayout& bindingLayout : inResult.BindingLayouts)
+		{
+			size += sizeof(BindingLayout) + bindingLayout.Name.size();
+		}
+
+		return size;
+	}
+
+	static void EvictMemoryEntries()
+	{
+		while (s_MemorySize > s_MemoryBudget && !s_RecentMemoryEntries.empty())
+		{
+			const auto memoryEntryIterator = s_MemoryEntries.find(s_RecentMemoryEntries.back());
+			s_MemorySize -= memoryEntryIterator->second.Size;
+			s_MemoryEntries.erase(memoryEntryIterator);
+			s_RecentMemoryEntries.pop_back();
+		}
+	}
+
+	static bool LoadFromMemory(const uint64_t inKey, const std::string& inKeySource, ShaderCompileResult& outResult)
+	{
+		std::lock_guard<std::mutex> lock(s_MemoryMutex);
+
+		const auto memoryEntryIterator = s_MemoryEntries.find(inKey);
+		if (memoryEntryIterator == s_MemoryEntries.end() || memoryEntryIterator->second.KeySource != inKeySource)
+		{
+			return false;
+		}
+
+		MemoryEntry& memoryEntry = memoryEntryIterator->second;
+		s_RecentMemoryEntries.splice(s_RecentMemoryEntries.begin(), s_RecentMemoryEntries, memoryEntry.RecentIterator);
+		outResult = memoryEntry.Result;
+
+		return true;
+	}
+
+	static void StoreToMemory(const uint64_t inKey, const std::string& inKeySource, const ShaderCompileResult& inResult)
+	{
+		std::lock_guard<std::mutex> lock(s_MemoryMutex);
+
+		const uint64_t size = GetMemoryEntrySize(inKeySource, inResult);
+		if (size > s_MemoryBudget || s_MemoryEntries.count(inKey) != 0)
+		{
+			return;
+		}
+
+		// Only the data stored on disk is kept, so memory and disk hits look the same to callers.
+		MemoryEntry& memoryEntry = s_MemoryEntries[inKey];
+		memoryEntry.KeySource = inKeySource;
+		memoryEntry.Result.SpvCode = inResult.SpvCode;
+		memoryEntry.Result.BindingLayouts = inResult.BindingLayouts;
+		memoryEntry.Result.InfoLog = inResult.InfoLog;
+		memoryEntry.Size = size;
+		memoryEntry.RecentIterator = s_RecentMemoryEntries.insert(s_RecentMemoryEntries.begin(), inKey);
+		s_MemorySize += size;
+
+		EvictMemoryEntries();
+	}
+
+	static std::string GetEntryPath(const uint64_t inKey)
+	{
+		return CombinePath(s_Directory, HashToString(inKey) + "." + CacheFileExtension);
+	}
+
+	static std::string GetDebugInfoPath(const uint64_t inKey)
+	{
+		return CombinePath(s_Directory, HashToString(inKey) + "." + DebugInfoFileExtension);
+	}
+
+	static std::string GetUniqueFileSuffix()
+	{
+		const uint64_t threadHash = std::hash<std::thread::id>()(std::this_thread::get_id());
+		const uint64_t time = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		return HashToString(HashValue(time, HashValue(threadHash)));
+	}
+
+	static void RemoveStaleTemporaryFiles()
+	{
+		std::vector<FileInfo> files;
+		if (!ListFiles(s_Directory, files))
+		{
+			return;
+		}
+
+		const int64_t currentTime = static_cast<int64_t>(std::time(nullptr));
+		for (const FileInfo& file : files)
+		{
+			// Leftovers of processes which crashed while storing an entry.
+			if (ExtractFileExtension(file.Path) == TemporaryFileExtension &&
+				currentTime - file.ModificationTime > StaleTemporaryFileAge)
+			{
+				RemoveFile(file.Path);
+			}
+		}
+	}
+
+	// Caller holds the trim mutex.
+	static void TrimFiles()
+	{
+		std::vector<FileInfo> files;
+		if (!ListFiles(s_Directory, files))
+		{
+			return;
+		}
+
+		std::vector<FileInfo> entries;
+		uint64_t totalSize = 0;
+		for (const FileInfo& file : files)
+		{
+			// Debug info artifacts are evicted on their own, nothing reads them back at runtime.
+			const std::string fileExtension = ExtractFileExtension(file.Path);
+			if (fileExtension == CacheFileExtension || fileExtension == DebugInfoFileExtension)
+			{
+				entries.push_back(file);
+				totalSize += file.Size;
+			}
+		}
+
+		if (totalSize <= s_MaxSize)
+		{
+			s_EstimatedSize = totalSize;
+			return;
+		}
+
+		// Entries are touched on every hit, so the oldest modification time is the least recently used entry.
+		std::sort(entries.begin(), entries.end(), [](const FileInfo& inLeft, const FileInfo& inRight)
+			{
+				return inLeft.ModificationTime < inRight.ModificationTime;
+			});
+
+		// Evicted a tenth below the budget, so the stores right after don't list the directory again.
+		const uint64_t trimmedSize = s_MaxSize - s_MaxSize / 10;
+		for (const FileInfo& entry : entries)
+		{
+			if (totalSize <= trimmedSize)
+			{
+				break;
+			}
+
+			// Another process might have evicted the same entry already.
+			if (RemoveFile(entry.Path))
+			{
+				++s_Evictions;
+			}
+
+			totalSize -= entry.Size;
+		}
+
+		s_EstimatedSize = totalSize;
+	}
+
+	static void Trim()
+	{
+		std::lock_guard<std::mutex> lock(s_TrimMutex);
+		TrimFiles();
+	}
+
+	// Size is estimated from the last listing and what this process stored since, so a store only lists the directory once
+	// the estimate exceeds the budget. Entries stored by other processes are accounted for by the next listing.
+	static void AddStoredSize(const uint64_t inSize)
+	{
+		std::lock_guard<std::mutex> lock(s_TrimMutex);
+
+		s_EstimatedSize += inSize;
+		if (s_EstimatedSize > s_MaxSize)
+		{
+			TrimFiles();
+		}
+	}
+
+	void Initialize(const std::string& inDirectory, const uint64_t inMaxSize)
+	{
+		s_Directory = inDirectory;
+		s_MaxSize = inMaxSize;
+		s_Enabled = MakeDirectory(s_Directory);
+
+		if (!s_Enabled)
+		{
+			FT_LOG("Failed creating shader cache directory %s, shader cache is disabled.\n", s_Directory.c_str());
+			return;
+		}
+
+		RemoveStaleTemporaryFiles();
+		Trim();
+	}
+
+	void SetMemoryBudget(const uint64_t inMemoryBudget)
+	{
+		std::lock_guard<std::mutex> lock(s_MemoryMutex);
+
+		s_MemoryBudget = inMemoryBudget;
+		EvictMemoryEntries();
+	}
+
+	void Finalize()
+	{
+		s_Enabled = false;
+		SetMemoryBudget(0);
+	}
+
+	bool Load(const uint64_t inKey, const std::string& inKeySource, ShaderCompileResult& outResult)
+	{
+		if (LoadFromMemory(inKey, inKeySource, outResult))
+		{
+			++s_MemoryHits;
+			++s_Hits;
+			return true;
+		}
+
+		if (!s_Enabled)
+		{
+			return false;
+		}
+
+		const std::string entryPath = GetEntryPath(inKey);
+
+		std::string fileBuffer;
+		if (!ReadBinaryFile(entryPath, fileBuffer) || !DeserializeEntry(inKey, inKeySource, fileBuffer, outResult))
+		{
+			++s_Misses;
+			return false;
+		}
+
+		TouchFile(entryPath);
+		++s_Hits;
+
+		StoreToMemory(inKey, inKeySource, outResult);
+
+		return true;
+	}
+
+	void Store(const uint64_t inKey, const std::string& inKeySource, const ShaderCompileResult& inResult)
+	{
+		StoreToMemory(inKey, inKeySource, inResult);
+
+		if (!s_Enabled)
+		{
+			return;
+		}
+
+		const std::string entryPath = GetEntryPath(inKey);
+		const std::string temporaryPath = entryPath + "." + GetUniqueFileSuffix() + "." + TemporaryFileExtension;
+
+		// Readers either see the complete previous entry or the complete new one, never a partially written file.
+		const std::string fileBuffer = SerializeEntry(inKey, inKeySource, inResult);
+		if (!WriteBinaryFile(temporaryPath, fileBuffer) || !RenameFile(temporaryPath, entryPath))
+		{
+			RemoveFile(temporaryPath);
+			FT_LOG("Failed storing shader cache entry %s.\n", entryPath.c_str());
+			return;
+		}
+
+		++s_Stores;
+
+		AddStoredSize(fileBuffer.size());
+	}
+
+	std::string StoreDebugInfo(const uint64_t inKey, const std::vector<uint32_t>& inDebugSpvCode)
+	{
+		if (!s_Enabled)
+		{
+			return "";
+		}
+
+		const std::string debugInfoPath = GetDebugInfoPath(inKey);
+		const std::string temporaryPath = debugInfoPath + "." + GetUniqueFileSuffix() + "." + TemporaryFileExtension;
+
+		const std::string debugInfoBuffer(reinterpret_cast<const char*>(inDebugSpvCode.data()), sizeof(uint32_t) * inDebugSpvCode.size());
+		if (!WriteBinaryFile(temporaryPath, debugInfoBuffer) || !RenameFile(temporaryPath, debugInfoPath))
+		{
+			RemoveFile(temporaryPath);
+			FT_LOG("Failed storing shader debug info %s.\n", debugInfoPath.c_str());
+			return "";
+		}
+
+		AddStoredSize(debugInfoBuffer.size());
+
+		return debugInfoPath;
+	}
+
+	std::string FindDebugInfo(const uint64_t inKey)
+	{
+		if (!s_Enabled)
+		{
+			return "";
+		}
+
+		const std::string debugInfoPath = GetDebugInfoPath(inKey);
+
+		FileInfo fileInfo;
+		if (!QueryFileInfo(debugInfoPath, fileInfo))
+		{
+			return "";
+		}
+
+		TouchFile(debugInfoPath);
+
+		return debugInfoPath;
+	}
+
+	bool IsEnabled()
+	{
+		return s_Enabled;
+	}
+
+	ShaderCacheStatistics GetStatistics()
+	{
+		ShaderCacheStatistics statistics;
+		statistics.Hits = s_Hits;
+		statistics.Misses = s_Misses;
+		statistics.Stores = s_Stores;
+		statistics.Evictions = s_Evictions;
+		statistics.MemoryHits = s_MemoryHits;
+
+		{
+			std::lock_guard<std::mutex> lock(s_MemoryMutex);
+			statistics.MemorySize = s_MemorySize;
+		}
+
+		return statistics;
+	}
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,34 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+struct ShaderCompileResult;
+
+struct ShaderCacheStatistics
+{
+	uint64_t Hits = 0;
+	uint64_t Misses = 0;
+	uint64_t Stores = 0;
+	uint64_t Evictions = 0;
+	uint64_t MemoryHits = 0;
+	uint64_t MemorySize = 0;
+};
+
+// Persistent content addressed cache of compiled SPIR-V and its reflected binding layout.
+// Keys are hashes of the key source, which is stored with the entry and compared on load, so colliding keys are misses.
+// Entries are written to a temporary file and renamed into place, so several processes can share one cache directory.
+// Optionally the most recently used entries are additionally kept in memory, up to the given budget.
+namespace ShaderCache
+{
+	extern void Initialize(const std::string& inDirectory, const uint64_t inMaxSize);
+	extern void SetMemoryBudget(const uint64_t inMemoryBudget);
+	extern void Finalize();
+	extern bool Load(const uint64_t inKey, const std::string& inKeySource, ShaderCompileResult& outResult);
+	extern void Store(const uint64_t inKey, const std::string& inKeySource, const ShaderCompileResult& inResult);
+	extern std::string StoreDebugInfo(const uint64_t inKey, const std::vector<uint32_t>& inDebugSpvCode);
+	extern std::string FindDebugInfo(const uint64_t inKey);
+	extern bool IsEnabled();
+	extern ShaderCacheStatistics GetStatistics();
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,180 @@
+#include "ShaderCompileClient.h"
+#include "ShaderCompileProtocol.h"
+#include "ShaderFileIncluder.h"
+#include "Utility/LocalSocket.h"
+
+FT_BEGIN_NAMESPACE
+
+namespace ShaderCompileClient
+{
+	static const int64_t ReconnectInterval = 5;
+
+	// Long enough for optimized compilations of large shaders, a server which doesn't answer in time is treated as unavailable.
+	static const uint32_t ServerTimeout = 10000;
+
+	struct ClientConnection
+	{
+		std::unique_ptr<LocalSocket> Socket;
+		uint64_t NextRequestId = 0;
+	};
+
+	static std::mutex s_Mutex;
+	static std::string s_SocketPath;
+	static std::atomic<bool> s_Enabled(false);
+	static std::atomic<bool> s_ServerAvailable(false);
+	static std::atomic<int64_t> s_LastConnectFailureTime(0);
+	static std::atomic<uint64_t> s_RemoteCompilations(0);
+	static std::atomic<uint64_t> s_LocalCompilations(0);
+	static thread_local ClientConnection s_ThreadConnection;
+
+	static bool TryConnect(ClientConnection& inOutConnection)
+	{
+		if (inOutConnection.Socket && inOutConnection.Socket->IsValid())
+		{
+			return true;
+		}
+
+		// Connecting to a missing server is cheap, but there's no point in trying on every compilation.
+		const int64_t currentTime = static_cast<int64_t>(std::time(nullptr));
+		if (currentTime - s_LastConnectFailureTime < ReconnectInterval)
+		{
+			return false;
+		}
+
+		std::string socketPath;
+
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			socketPath = s_SocketPath;
+		}
+
+		inOutConnection.Socket.reset(new LocalSocket());
+		if (!inOutConnection.Socket->Connect(socketPath) || !inOutConnection.Socket->SetTimeout(ServerTimeout))
+		{
+			inOutConnection.Socket.reset();
+			s_LastConnectFailureTime = currentTime;
+
+			if (s_ServerAvailable.exchange(false))
+			{
+				FT_LOG("Shader compile server %s isn't available anymore, compiling in process.\n", socketPath.c_str());
+			}
+
+			return false;
+		}
+
+		if (!s_ServerAvailable.exchange(true))
+		{
+			FT_LOG("Connected to shader compile server %s.\n", socketPath.c_str());
+		}
+
+		return true;
+	}
+
+	static bool TryCompileRemote(const ShaderCompileRequest& inRequest, ShaderCompileResult& outResult)
+	{
+		ClientConnection& connection = s_ThreadConnection;
+		if (!TryConnect(connection))
+		{
+			return false;
+		}
+
+		const uint64_t requestId = ++connection.NextRequestId;
+
+		ShaderCompileMessageType messageType = ShaderCompileMessageType::Count;
+		uint64_t resultRequestId = 0;
+		std::string resultPayload;
+		if (!ShaderCompileProtocol::WriteMessage(*connection.Socket, ShaderCompileMessageType::CompileRequest, requestId, ShaderCompileProtocol::SerializeRequest(inRequest)) ||
+			!ShaderCompileProtocol::ReadMessage(*connection.Socket, messageType, resultRequestId, resultPayload) ||
+			messageType != ShaderCompileMessageType::CompileResult ||
+			resultRequestId != requestId ||
+			!ShaderCompileProtocol::DeserializeResult(resultPayload, outResult))
+		{
+			// Connection is in an unknown state, the next compilation starts with a new one. Server might be hung, so it's
+			// treated like a failed connection and this compilation, along with the following ones for a while, runs in process.
+			connection.Socket.reset();
+			s_LastConnectFailureTime = static_cast<int64_t>(std::time(nullptr));
+
+			if (s_ServerAvailable.exchange(false))
+			{
+				FT_LOG("Shader compile server didn't respond, compiling in process.\n");
+			}
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void Initialize(const std::string& inSocketPath)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			s_SocketPath = inSocketPath;
+		}
+
+		s_LastConnectFailureTime = 0;
+		s_Enabled = true;
+	}
+
+	void Finalize()
+	{
+		s_Enabled = false;
+		s_ServerAvailable = false;
+	}
+
+	ShaderCompileResult Compile(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const ShaderCompileOptions& inOptions)
+	{
+		if (s_Enabled)
+		{
+			ShaderCompileRequest request{};
+			request.Language = inLanguage;
+			request.Stage = inStage;
+			request.SourceCode = inSourceCode;
+			request.Options = inOptions;
+
+			// Server doesn't know about search paths of this session.
+			if (request.Options.IncludeDirectories.empty())
+			{
+				request.Options.IncludeDirectories = ShaderIncludes::GetSearchPaths();
+			}
+
+			ShaderCompileResult result{};
+			if (TryCompileRemote(request, result))
+			{
+				// Server has no device, so limits of this one are checked here.
+				if (result.Status == ShaderCompileStatus::Success && !ShaderCompiler::CheckDeviceLimits(result.SpvCode, result.InfoLog))
+				{
+					result.Status = ShaderCompileStatus::ReflectionFailed;
+				}
+
+				// Includes were resolved by the server, the files still have to be watched here for changes.
+				if (!inOptions.SourcePath.empty())
+				{
+					ShaderIncludes::UpdateDependencies(inOptions.SourcePath, result.IncludedFiles);
+					ShaderIncludes::TrackFiles(result.IncludedFiles);
+				}
+
+				++s_RemoteCompilations;
+				return result;
+			}
+		}
+
+		++s_LocalCompilations;
+		return ShaderCompiler::Compile(inLanguage, inStage, inSourceCode, inOptions);
+	}
+
+	bool IsServerAvailable()
+	{
+		return s_ServerAvailable;
+	}
+
+	ShaderCompileClientStatistics GetStatistics()
+	{
+		ShaderCompileClientStatistics statistics;
+		statistics.RemoteCompilations = s_RemoteCompilations;
+		statistics.LocalCompilations = s_LocalCompilations;
+		return statistics;
+	}
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+
+FT_BEGIN_NAMESPACE
+
+struct ShaderCompileClientStatistics
+{
+	uint64_t RemoteCompilations = 0;
+	uint64_t LocalCompilations = 0;
+};
+
+// Forwards compilations to a running FotonCompileServer and falls back to compiling in process whenever the server
+// isn't reachable. Every thread gets its own connection, so concurrent callers don't wait on each other.
+namespace ShaderCompileClient
+{
+	extern void Initialize(const std::string& inSocketPath);
+	extern void Finalize();
+	extern ShaderCompileResult Compile(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const ShaderCompileOptions& inOptions = ShaderCompileOptions());
+	extern bool IsServerAvailable();
+	extern ShaderCompileClientStatistics GetStatistics();
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,259 @@
+#include "ShaderCompileProtocol.h"
+#include "Core/Shader.h"
+#include "Utility/ShaderFile.h"
+#include "Utility/LocalSocket.h"
+#include "Utility/BinaryStream.hpp"
+
+FT_BEGIN_NAMESPACE
+
+namespace ShaderCompileProtocol
+{
+	static const uint32_t MessageMagic = 0x50435446; // "FTCP"
+	static const uint32_t ProtocolVersion = 3;
+	static const uint32_t MaxPayloadSize = 64u * 1024u * 1024u;
+	static const char* SocketFileName = "foton-compile.sock";
+
+	struct MessageHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t Type;
+		uint32_t PayloadSize;
+		uint64_t RequestId;
+	};
+
+	static void WriteStrings(std::string& outBuffer, const std::vector<std::string>& inStrings)
+	{
+		WriteBinaryValue(outBuffer, static_cast<uint32_t>(inStrings.size()));
+		for (const std::string& string : inStrings)
+		{
+			WriteBinaryString(outBuffer, string);
+		}
+	}
+
+	static bool ReadStrings(const std::string& inBuffer, size_t& inOutOffset, std::vector<std::string>& outStrings)
+	{
+		uint32_t stringCount = 0;
+		if (!ReadBinaryValue(inBuffer, inOutOffset, stringCount) || stringCount > inBuffer.size())
+		{
+			return false;
+		}
+
+		outStrings.resize(stringCount);
+		for (std::string& string : outStrings)
+		{
+			if (!ReadBinaryString(inBuffer, inOutOffset, string))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::string GetDefaultSocketPath()
+	{
+		// Socket lives next to the per user temporary files, so every user gets their own server.
+#ifdef _WIN32
+		const char* directory = getenv("TEMP");
+#else
+		const char* directory = getenv("XDG_RUNTIME_DIR");
+		if (directory == nullptr)
+		{
+			directory = getenv("TMPDIR");
+		}
+#endif // _WIN32
+
+		return CombinePath(directory != nullptr ? directory : "/tmp", SocketFileName);
+	}
+
+	bool WriteMessage(LocalSocket& inSocket, const ShaderCompileMessageType inType, const uint64_t inRequestId, const std::string& inPayload)
+	{
+		if (inPayload.size() > MaxPayloadSize)
+		{
+			return false;
+		}
+
+		MessageHeader header{};
+		header.Magic = MessageMagic;
+		header.Version = ProtocolVersion;
+		header.Type = static_cast<uint32_t>(inType);
+		header.PayloadSize = static_cast<uint32_t>(inPayload.size());
+		header.RequestId = inRequestId;
+
+		// Single send per message, so messages of different threads never interleave on a shared connection.
+		std::string message;
+		message.reserve(sizeof(MessageHeader) + inPayload.size());
+		WriteBinaryValue(message, header);
+		message.append(inPayload);
+
+		return inSocket.SendAll(message.data(), message.size());
+	}
+
+	bool ReadMessage(LocalSocket& inSocket, ShaderCompileMessageType& outType, uint64_t& outRequestId, std::string& outPayload)
+	{
+		MessageHeader header{};
+		if (!inSocket.ReceiveAll(&header, sizeof(header)) ||
+			header.Magic != MessageMagic ||
+			header.Version != ProtocolVersion ||
+			header.Type >= static_cast<uint32_t>(ShaderCompileMessageType::Count) ||
+			header.PayloadSize > MaxPayloadSize)
+		{
+			return false;
+		}
+
+		outPayload.resize(header.PayloadSize);
+		if (header.PayloadSize > 0 && !inSocket.ReceiveAll(&outPayload[0], header.PayloadSize))
+		{
+			return false;
+		}
+
+		outType = static_cast<ShaderCompileMessageType>(header.Type);
+		outRequestId = header.RequestId;
+
+		return true;
+	}
+
+	std::string SerializeRequest(const ShaderCompileRequest& inRequest)
+	{
+		std::string payload;
+
+		WriteBinaryValue(payload, static_cast<uint8_t>(inRequest.Language));
+		WriteBinaryValue(payload, static_cast<uint8_t>(inRequest.Stage));
+		WriteBinaryValue(payload, static_cast<uint8_t>(inRequest.Options.OptimizationLevel));
+		WriteBinaryString(payload, inRequest.SourceCode);
+		WriteBinaryString(payload, inRequest.Options.SourcePath);
+		WriteBinaryString(payload, inRequest.Options.CodeEntry);
+
+		WriteBinaryValue(payload, static_cast<uint32_t>(inRequest.Options.Defines.size()));
+		for (const ShaderDefine& define : inRequest.Options.Defines)
+		{
+			WriteBinaryString(payload, define.Name);
+			WriteBinaryString(payload, define.Value);
+		}
+
+		WriteStrings(payload, inRequest.Options.IncludeDirectories);
+
+		return payload;
+	}
+
+	bool DeserializeRequest(const std::string& inPayload, ShaderCompileRequest& outRequest)
+	{
+		size_t offset = 0;
+
+		uint8_t language = 0;
+		uint8_t stage = 0;
+		uint8_t optimizationLevel = 0;
+		if (!ReadBinaryValue(inPayload, offset, language) || language >= static_cast<uint8_t>(ShaderLanguage::Count) ||
+			!ReadBinaryValue(inPayload, offset, stage) || stage >= static_cast<uint8_t>(ShaderStage::Count) ||
+			!ReadBinaryValue(inPayload, offset, optimizationLevel) || optimizationLevel >= static_cast<uint8_t>(ShaderOptimizationLevel::Count))
+		{
+			return false;
+		}
+
+		outRequest.Language = static_cast<ShaderLanguage>(language);
+		outRequest.Stage = static_cast<ShaderStage>(stage);
+		outRequest.Options.OptimizationLevel = static_cast<ShaderOptimizationLevel>(optimizationLevel);
+
+		uint32_t defineCount = 0;
+		if (!ReadBinaryString(inPayload, offset, outRequest.SourceCode) ||
+			!ReadBinaryString(inPayload, offset, outRequest.Options.SourcePath) ||
+			!ReadBinaryString(inPayload, offset, outRequest.Options.CodeEntry) ||
+			!ReadBinaryValue(inPayload, offset, defineCount) || defineCount > inPayload.size())
+		{
+			return false;
+		}
+
+		outRequest.Options.Defines.resize(defineCount);
+		for (ShaderDefine& define : outRequest.Options.Defines)
+		{
+			if (!ReadBinaryString(inPayload, offset, define.Name) || !ReadBinaryString(inPayload, offset, define.Value))
+			{
+				return false;
+			}
+		}
+
+		return ReadStrings(inPayload, offset, outRequest.Options.IncludeDirectories);
+	}
+
+	std::string SerializeResult(const ShaderCompileResult& inResult)
+	{
+		std::string payload;
+
+		WriteBinaryValue(payload, static_cast<uint8_t>(inResult.Status));
+		WriteBinaryValue(payload, static_cast<uint8_t>(inResult.CacheHit));
+		WriteBinaryValue(payload, inResult.UnoptimizedSize);
+		WriteBinaryValue(payload, inResult.OptimizationTime);
+
+		WriteBinaryValue(payload, static_cast<uint32_t>(inResult.SpvCode.size()));
+		payload.append(reinterpret_cast<const char*>(inResult.SpvCode.data()), sizeof(uint32_t) * inResult.SpvCode.size());
+
+		WriteBinaryValue(payload, static_cast<uint32_t>(inResult.BindingLayouts.size()));
+		for (const BindingLayout& bindingLayout : inResult.BindingLayouts)
+		{
+			WriteBinaryValue(payload, bindingLayout.Set);
+			WriteBinaryValue(payload, bindingLayout.Binding);
+			WriteBinaryValue(payload, static_cast<uint32_t>(bindingLayout.DescriptorType));
+			WriteBinaryValue(payload, bindingLayout.DescriptorCount);
+			WriteBinaryString(payload, bindingLayout.Name);
+		}
+
+		WriteStrings(payload, inResult.IncludedFiles);
+		WriteBinaryString(payload, inResult.DebugInfoPath);
+		WriteBinaryString(payload, inResult.InfoLog);
+
+		return payload;
+	}
+
+	bool DeserializeResult(const std::string& inPayload, ShaderCompileResult& outResult)
+	{
+		size_t offset = 0;
+
+		uint8_t status = 0;
+		uint8_t cacheHit = 0;
+		uint32_t spvWordCount = 0;
+		if (!ReadBinaryValue(inPayload, offset, status) || status >= static_cast<uint8_t>(ShaderCompileStatus::Count) ||
+			!ReadBinaryValue(inPayload, offset, cacheHit) ||
+			!ReadBinaryValue(inPayload, offset, outResult.UnoptimizedSize) ||
+			!ReadBinaryValue(inPayload, offset, outResult.OptimizationTime) ||
+			!ReadBinaryValue(inPayload, offset, spvWordCount) || offset + sizeof(uint32_t) * spvWordCount > inPayload.size())
+		{
+			return false;
+		}
+
+		outResult.Status = static_cast<ShaderCompileStatus>(status);
+		outResult.CacheHit = cacheHit != 0;
+
+		outResult.SpvCode.resize(spvWordCount);
+		memcpy(outResult.SpvCode.data(), inPayload.data() + offset, sizeof(uint32_t) * spvWordCount);
+		offset += sizeof(uint32_t) * spvWordCount;
+
+		uint32_t bindingCount = 0;
+		if (!ReadBinaryValue(inPayload, offset, bindingCount) || bindingCount > inPayload.size())
+		{
+			return false;
+		}
+
+		outResult.BindingLayouts.resize(bindingCount);
+		for (BindingLayout& bindingLayout : outResult.BindingLayouts)
+		{
+			uint32_t descriptorType = 0;
+			if (!ReadBinaryValue(inPayload, offset, bindingLayout.Set) ||
+				!ReadBinaryValue(inPayload, offset, bindingLayout.Binding) ||
+				!ReadBinaryValue(inPayload, offset, descriptorType) ||
+				!ReadBinaryValue(inPayload, offset, bindingLayout.DescriptorCount) ||
+				!ReadBinaryString(inPayload, offset, bindingLayout.Name))
+			{
+				return false;
+			}
+
+			bindingLayout.DescriptorType = static_cast<VkDescriptorType>(descriptorType);
+		}
+
+		return ReadStrings(inPayload, offset, outResult.IncludedFiles) &&
+			ReadBinaryString(inPayload, offset, outResult.DebugInfoPath) &&
+			ReadBinaryString(inPayload, offset, outResult.InfoLog);
+	}
+}
+
+FT_END_NAMESPACE
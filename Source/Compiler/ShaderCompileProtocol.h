@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+
+FT_BEGIN_NAMESPACE
+
+class LocalSocket;
+
+enum class ShaderCompileMessageType : uint32_t
+{
+	CompileRequest,
+	CompileResult,
+
+	Count
+};
+
+struct ShaderCompileRequest
+{
+	ShaderLanguage Language;
+	ShaderStage Stage;
+	std::string SourceCode;
+	ShaderCompileOptions Options;
+};
+
+// Every message is a fixed size header followed by a payload. Request ids let a client match results to requests,
+// results are sent back in the order compilations finish, not in the order requests were received.
+namespace ShaderCompileProtocol
+{
+	extern std::string GetDefaultSocketPath();
+	extern bool WriteMessage(LocalSocket& inSocket, const ShaderCompileMessageType inType, const uint64_t inRequestId, const std::string& inPayload);
+	extern bool ReadMessage(LocalSocket& inSocket, ShaderCompileMessageType& outType, uint64_t& outRequestId, std::string& outPayload);
+	extern std::string SerializeRequest(const ShaderCompileRequest& inRequest);
+	extern bool DeserializeRequest(const std::string& inPayload, ShaderCompileRequest& outRequest);
+	extern std::string SerializeResult(const ShaderCompileResult& inResult);
+	extern bool DeserializeResult(const std::string& inPayload, ShaderCompileResult& outResult);
+}
+
+FT_END_NAMESPACE
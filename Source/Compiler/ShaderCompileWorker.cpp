@@ -0,0 +1,111 @@
+#include "ShaderCompileWorker.h"
+#include "ShaderCompileClient.h"
+
+FT_BEGIN_NAMESPACE
+
+ShaderCompileWorker::ShaderCompileWorker()
+	: m_Generation(0)
+	, m_Busy(false)
+	, m_Quit(false)
+	, m_HasPendingRequest(false)
+	, m_HasResult(false)
+{
+	m_Thread = std::thread(&ShaderCompileWorker::Run, this);
+}
+
+ShaderCompileWorker::~ShaderCompileWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_Condition.notify_one();
+	m_Thread.join();
+}
+
+uint64_t ShaderCompileWorker::Submit(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const ShaderCompileOptions& inOptions)
+{
+	uint64_t generation = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		generation = ++m_Generation;
+
+		// Request which didn't start yet is simply replaced, the one in flight is discarded once it finishes.
+		m_PendingRequest.Generation = generation;
+		m_PendingRequest.Language = inLanguage;
+		m_PendingRequest.Stage = inStage;
+		m_PendingRequest.SourceCode = inSourceCode;
+		m_PendingRequest.Options = inOptions;
+		m_HasPendingRequest = true;
+		m_HasResult = false;
+	}
+
+	m_Condition.notify_one();
+
+	return generation;
+}
+
+void ShaderCompileWorker::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	++m_Generation;
+	m_HasPendingRequest = false;
+	m_HasResult = false;
+}
+
+bool ShaderCompileWorker::TryGetResult(ShaderCompileResult& outResult)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (!m_HasResult)
+	{
+		return false;
+	}
+
+	outResult = std::move(m_Result);
+	m_HasResult = false;
+
+	return true;
+}
+
+void ShaderCompileWorker::Run()
+{
+	while (true)
+	{
+		Request request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_Quit || m_HasPendingRequest; });
+
+			if (m_Quit)
+			{
+				return;
+			}
+
+			request = std::move(m_PendingRequest);
+			m_HasPendingRequest = false;
+			m_Busy = true;
+		}
+
+		ShaderCompileResult result = ShaderCompileClient::Compile(request.Language, request.Stage, request.SourceCode, request.Options);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (request.Generation == m_Generation)
+			{
+				m_Result = std::move(result);
+				m_HasResult = true;
+			}
+
+			m_Busy = false;
+		}
+	}
+}
+
+FT_END_NAMESPACE
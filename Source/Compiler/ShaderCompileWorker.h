@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+
+FT_BEGIN_NAMESPACE
+
+// Compiles shaders on a background thread. Every submit starts a new generation, which supersedes any request
+// that is still waiting or being compiled, and only the result of the latest generation is ever handed out.
+class ShaderCompileWorker
+{
+public:
+	ShaderCompileWorker();
+	~ShaderCompileWorker();
+	FT_DELETE_COPY_AND_MOVE(ShaderCompileWorker)
+
+public:
+	uint64_t Submit(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const ShaderCompileOptions& inOptions);
+	void Cancel();
+	bool TryGetResult(ShaderCompileResult& outResult);
+
+public:
+	uint64_t GetGeneration() const { return m_Generation; }
+	bool IsBusy() const { return m_Busy; }
+
+private:
+	void Run();
+
+private:
+	struct Request
+	{
+		uint64_t Generation = 0;
+		ShaderLanguage Language;
+		ShaderStage Stage;
+		std::string SourceCode;
+		ShaderCompileOptions Options;
+	};
+
+private:
+	std::thread m_Thread;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::atomic<uint64_t> m_Generation;
+	std::atomic<bool> m_Busy;
+	bool m_Quit;
+	bool m_HasPendingRequest;
+	Request m_PendingRequest;
+	bool m_HasResult;
+	ShaderCompileResult m_Result;
+};
+
+FT_END_NAMESPACE
@@ -1,23 +1,16 @@
 #include "ShaderCompiler.h"
 #include "ShaderFileIncluder.h"
 #include "ShaderResourceLimits.hpp"
+#include "ShaderCache.h"
 #include "Core/Shader.h"
 #include "Utility/ShaderFile.h"
+#include "Utility/Hash.hpp"
+#include "Utility/BinaryStream.hpp"
 
 FT_BEGIN_NAMESPACE
 
 namespace ShaderCompiler
 {
-	void Initialize()
-	{
-		FT_CHECK(glslang::InitializeProcess(), "Glslang not initialized properly.");
-	}
-
-	void Finalize()
-	{
-		glslang::FinalizeProcess();
-	}
-
 	static glslang::EShSource GetGlslangShaderLanguage(const ShaderLanguage inShaderLanguage)
 	{
 		switch (inShaderLanguage)
@@ -48,51 +41,252 @@ namespace ShaderCompiler
 		}
 	}
 
-	ShaderCompileResult Compile(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const std::string inCodeEntry)
+	static const size_t SpvHeaderWordCount = 5;
+
+	static SpvReflectShaderStageFlagBits GetSpvReflectShaderStage(const ShaderStage inShaderStage)
+	{
+		switch (inShaderStage)
+		{
+		case ShaderStage::Vertex:
+			return SPV_REFLECT_SHADER_STAGE_VERTEX_BIT;
+
+		case ShaderStage::Fragment:
+			return SPV_REFLECT_SHADER_STAGE_FRAGMENT_BIT;
+
+		default:
+			FT_FAIL("Unsupported ShaderType.");
+		}
+	}
+
+	// Shaders without a #version directive are parsed as DefaultVersion, bundled and new shaders declare 450.
+	static const char* WarmUpDefaultVersionGlslShader = "layout(location = 0) out vec4 outColor;\nvoid main() { outColor = vec4(0.0); }\n";
+	static const char* WarmUpGlslShader = "#version 450\nlayout(location = 0) out vec4 outColor;\nvoid main() { outColor = vec4(0.0); }\n";
+	static const char* WarmUpHlslShader = "float4 main() : SV_Target { return float4(0.0, 0.0, 0.0, 0.0); }\n";
+
+	static glslang::SpvOptions GetSpvOptions()
+	{
+		glslang::SpvOptions spvOptions;
+		spvOptions.optimizeSize = false;
+		spvOptions.disableOptimizer = true;
+		spvOptions.generateDebugInfo = true;
+		spvOptions.validate = true;
+		return spvOptions;
+	}
+
+	// Release builds ship modules without debug info, the full module is kept as a separate artifact.
+#ifdef NDEBUG
+	static const bool SplitDebugInfo = true;
+#else
+	static const bool SplitDebugInfo = false;
+#endif // NDEBUG
+
+	// Bumped whenever modules would come out differently without any tool version or option changing along with it.
+	static const uint32_t CompilerRevision = 1;
+
+	// Upgrading glslang or SPIRV-Tools changes the produced modules, so entries of older tools are never served.
+	static const std::string& GetToolVersionText()
+	{
+		static const std::string ToolVersionText = []()
+			{
+				const glslang::Version glslangVersion = glslang::GetVersion();
+				return "glslang " + std::to_string(glslangVersion.major) + "." + std::to_string(glslangVersion.minor) + "." + std::to_string(glslangVersion.patch) +
+					glslangVersion.flavor + ", " + ShaderOptimizer::GetToolVersionText();
+			}();
+
+		return ToolVersionText;
+	}
+
+	// Everything the module depends on, the cache key is its hash and the cache compares it in full before serving an entry, so
+	// a hash collision is a miss instead of a wrong module. Preprocessed source already contains the text of every resolved include.
+	static std::string GetCacheKeySource(const std::string& inPreprocessedShader, const ShaderLanguage inLanguage, const ShaderStage inStage,
+		const ShaderCompileOptions& inOptions, const glslang::SpvOptions& inSpvOptions)
+	{
+		std::string keySource;
+		WriteBinaryValue(keySource, CompilerRevision);
+		WriteBinaryString(keySource, GetToolVersionText());
+		WriteBinaryString(keySource, inPreprocessedShader);
+		WriteBinaryValue(keySource, inLanguage);
+		WriteBinaryValue(keySource, inStage);
+		WriteBinaryString(keySource, inOptions.CodeEntry);
+		WriteBinaryValue(keySource, inOptions.OptimizationLevel);
+		WriteBinaryValue(keySource, static_cast<uint32_t>(inOptions.Defines.size()));
+		for (const ShaderDefine& define : inOptions.Defines)
+		{
+			WriteBinaryString(keySource, define.Name);
+			WriteBinaryString(keySource, define.Value);
+		}
+		WriteBinaryValue(keySource, SplitDebugInfo);
+		WriteBinaryValue(keySource, inSpvOptions.generateDebugInfo);
+		WriteBinaryValue(keySource, inSpvOptions.disableOptimizer);
+		WriteBinaryValue(keySource, inSpvOptions.optimizeSize);
+		WriteBinaryValue(keySource, inSpvOptions.validate);
+		return keySource;
+	}
+
+	static const TBuiltInResource BuiltInResource = DefaultTBuiltInResource;
+	static const int DefaultVersion = 330;
+	static const EShMessages Messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgKeepUncalled);
+
+	static std::string GetPreamble(const ShaderLanguage inLanguage, const std::vector<ShaderDefine>& inDefines)
+	{
+		std::string preamble;
+
+		// HLSL supports #include out of the box, GLSL needs the extension enabled for both preprocessing and parsing.
+		if (inLanguage == ShaderLanguage::GLSL)
+		{
+			preamble += "#extension GL_GOOGLE_include_directive : enable\n";
+		}
+
+		for (const ShaderDefine& define : inDefines)
+		{
+			preamble += "#define " + define.Name + " " + define.Value + "\n";
+		}
+
+		return preamble;
+	}
+
+	// Glslang keeps a pointer to the preamble, so it has to outlive both preprocessing and parsing.
+	static void SetupShader(glslang::TShader& outShader, const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inCodeEntry, const std::string& inPreamble)
 	{
 		const EShLanguage shaderType = GetGlslangShaderStage(inStage);
-		glslang::TShader compiledShader(shaderType);
-		const char* codeEntry = inCodeEntry.c_str();
-		compiledShader.setEntryPoint(codeEntry);
-		compiledShader.setSourceEntryPoint(codeEntry);
 
-		const char* sourceCode = inSourceCode.c_str();
-		compiledShader.setStrings(&sourceCode, 1);
+		outShader.setEntryPoint(inCodeEntry.c_str());
+		outShader.setSourceEntryPoint(inCodeEntry.c_str());
+		outShader.setPreamble(inPreamble.c_str());
 
 		const glslang::EShSource shaderLanguage = GetGlslangShaderLanguage(inLanguage);
 		const static glslang::EShClient client = glslang::EShClientVulkan;
-		const static int version = 330;
-		compiledShader.setEnvInput(shaderLanguage, shaderType, client, version);
+		outShader.setEnvInput(shaderLanguage, shaderType, client, DefaultVersion);
 
 		const static glslang::EShTargetClientVersion targetClientVersion = glslang::EShTargetVulkan_1_0;
-		compiledShader.setEnvClient(client, targetClientVersion);
+		outShader.setEnvClient(client, targetClientVersion);
 
 		const static glslang::EShTargetLanguageVersion targetLanguageVersion = glslang::EShTargetSpv_1_0;
-		compiledShader.setEnvTarget(glslang::EShTargetSpv, targetLanguageVersion);
+		outShader.setEnvTarget(glslang::EShTargetSpv, targetLanguageVersion);
+	}
+
+	static void WarmUp(const ShaderLanguage inLanguage, const char* inSourceCode)
+	{
+		const std::string preamble = GetPreamble(inLanguage, std::vector<ShaderDefine>());
+
+		glslang::TShader warmUpShader(EShLangFragment);
+		SetupShader(warmUpShader, inLanguage, ShaderStage::Fragment, "main", preamble);
+		warmUpShader.setStrings(&inSourceCode, 1);
+		warmUpShader.parse(&BuiltInResource, DefaultVersion, false, Messages);
+	}
+
+	void Initialize()
+	{
+		FT_CHECK(glslang::InitializeProcess(), "Glslang not initialized properly.");
+
+		// Glslang's built-in symbol tables are shared by the whole process, parsing creates them for the version and
+		// language once, so no compilation on any thread pays for them.
+		WarmUp(ShaderLanguage::GLSL, WarmUpDefaultVersionGlslShader);
+		WarmUp(ShaderLanguage::GLSL, WarmUpGlslShader);
+		WarmUp(ShaderLanguage::HLSL, WarmUpHlslShader);
+	}
+
+	void Finalize()
+	{
+		glslang::FinalizeProcess();
+	}
+
+	void ResetThreadContext()
+	{
+		ShaderOptimizer::ResetThreadOptimizers();
+	}
+
+	static std::mutex s_DeviceLimitsMutex;
+	static ShaderDeviceLimits s_DeviceLimits;
+
+	void SetDeviceLimits(const ShaderDeviceLimits& inDeviceLimits)
+	{
+		std::lock_guard<std::mutex> lock(s_DeviceLimitsMutex);
+		s_DeviceLimits = inDeviceLimits;
+	}
+
+	bool CheckDeviceLimits(const std::vector<uint32_t>& inSpvCode, std::string& outInfoLog)
+	{
+		ShaderDeviceLimits deviceLimits;
+		{
+			std::lock_guard<std::mutex> lock(s_DeviceLimitsMutex);
+			deviceLimits = s_DeviceLimits;
+		}
+
+		const ShaderDeviceRequirements deviceRequirements = ReflectDeviceRequirements(inSpvCode);
+		if (deviceRequirements.PushConstantSize > deviceLimits.MaxPushConstantsSize)
+		{
+			outInfoLog += "Push constant block is " + std::to_string(deviceRequirements.PushConstantSize) + " bytes, which exceeds the device limit of " +
+				std::to_string(deviceLimits.MaxPushConstantsSize) + " bytes.\n";
+			return false;
+		}
+
+		if (deviceRequirements.RuntimeArrays && !deviceLimits.DescriptorIndexingSupported)
+		{
+			outInfoLog += "Runtime sized arrays require descriptor indexing, which the device doesn't support.\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	ShaderCompileResult Compile(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const ShaderCompileOptions& inOptions)
+	{
+		const EShLanguage shaderType = GetGlslangShaderStage(inStage);
+		const std::string preamble = GetPreamble(inLanguage, inOptions.Defines);
+
+		glslang::TShader compiledShader(shaderType);
+		SetupShader(compiledShader, inLanguage, inStage, inOptions.CodeEntry, preamble);
 
-		const static TBuiltInResource builtInResource = DefaultTBuiltInResource;
-		const static int defaultVersion = version;
+		const char* sourceCode = inSourceCode.c_str();
+		compiledShader.setStrings(&sourceCode, 1);
 
-		EShMessages messages = (EShMessages)(EShMsgSpvRules | EShMsgKeepUncalled);
 		std::string preprocessedShader;
-		ShaderFileIncluder fileIncluder;
+		ShaderFileIncluder fileIncluder(inOptions.SourcePath, inOptions.IncludeDirectories);
 
-		if (!compiledShader.preprocess(&builtInResource, defaultVersion, ENoProfile, false, false, messages, &preprocessedShader, fileIncluder))
+		const bool preprocessed = compiledShader.preprocess(&BuiltInResource, DefaultVersion, ENoProfile, false, false, Messages, &preprocessedShader, fileIncluder);
+
+		const std::vector<std::string>& includedFiles = fileIncluder.GetIncludedFiles();
+
+		// Dependencies are recorded even for failed compilations, fixing an include should still trigger a recompile.
+		if (!inOptions.SourcePath.empty())
+		{
+			ShaderIncludes::UpdateDependencies(inOptions.SourcePath, includedFiles);
+		}
+
+		if (!preprocessed)
 		{
 			ShaderCompileResult result{};
 			result.Status = ShaderCompileStatus::PreprocessingFailed;
+			result.IncludedFiles = includedFiles;
 			result.InfoLog = compiledShader.getInfoLog();
 			return result;
 		}
 
+		glslang::SpvOptions spvOptions = GetSpvOptions();
+		const std::string cacheKeySource = GetCacheKeySource(preprocessedShader, inLanguage, inStage, inOptions, spvOptions);
+		const uint64_t cacheKey = HashString(cacheKeySource);
+
+		ShaderCompileResult cachedResult{};
+		if (ShaderCache::Load(cacheKey, cacheKeySource, cachedResult))
+		{
+			// Cached modules don't depend on the device, so its limits are checked on every load.
+			cachedResult.Status = CheckDeviceLimits(cachedResult.SpvCode, cachedResult.InfoLog) ? ShaderCompileStatus::Success : ShaderCompileStatus::ReflectionFailed;
+			cachedResult.IncludedFiles = includedFiles;
+			cachedResult.DebugInfoPath = ShaderCache::FindDebugInfo(cacheKey);
+			cachedResult.CacheHit = true;
+			return cachedResult;
+		}
+
 		const char* preprocessedShaderCode = preprocessedShader.c_str();
 		compiledShader.setStrings(&preprocessedShaderCode, 1);
 		compiledShader.setAutoMapLocations(true);
 
-		if (!compiledShader.parse(&builtInResource, defaultVersion, false, messages))
+		if (!compiledShader.parse(&BuiltInResource, DefaultVersion, false, Messages))
 		{
 			ShaderCompileResult result{};
 			result.Status = ShaderCompileStatus::ParsingFailed;
+			result.IncludedFiles = includedFiles;
 			result.InfoLog = compiledShader.getInfoLog();
 			return result;
 		}
@@ -100,28 +294,124 @@ namespace ShaderCompiler
 		glslang::TProgram shaderProgram;
 		shaderProgram.addShader(&compiledShader);
 
-		if (!shaderProgram.link(messages))
+		if (!shaderProgram.link(Messages))
 		{
 			ShaderCompileResult result{};
 			result.Status = ShaderCompileStatus::LinkingFailed;
+			result.IncludedFiles = includedFiles;
 			result.InfoLog = compiledShader.getInfoLog();
 			return result;
 		}
 
 		spv::SpvBuildLogger spvBuildLogger;
 
-		glslang::SpvOptions spvOptions;
-		spvOptions.optimizeSize = false;
-		spvOptions.disableOptimizer = true;
-		spvOptions.generateDebugInfo = true;
-		spvOptions.validate = true;
-
 		ShaderCompileResult result{};
+		result.IncludedFiles = includedFiles;
 		const glslang::TIntermediate* intermediate = shaderProgram.getIntermediate(shaderType);
+
 		glslang::GlslangToSpv(*intermediate, result.SpvCode, &spvBuildLogger, &spvOptions);
 
-		result.Status = ShaderCompileStatus::Success;
 		result.InfoLog = spvBuildLogger.getAllMessages().c_str();
+		result.UnoptimizedSize = sizeof(uint32_t) * result.SpvCode.size();
+
+		if (inOptions.OptimizationLevel != ShaderOptimizationLevel::None)
+		{
+			const auto optimizationStartTime = std::chrono::high_resolution_clock::now();
+
+			std::vector<uint32_t> optimizedSpvCode;
+			if (!ShaderOptimizer::Optimize(inOptions.OptimizationLevel, result.SpvCode, optimizedSpvCode, result.InfoLog))
+			{
+				result.Status = ShaderCompileStatus::OptimizationFailed;
+				return result;
+			}
+
+			const auto optimizationEndTime = std::chrono::high_resolution_clock::now();
+			result.OptimizationTime = std::chrono::duration<double, std::milli>(optimizationEndTime - optimizationStartTime).count();
+			result.SpvCode = std::move(optimizedSpvCode);
+		}
+
+		std::vector<uint32_t> debugSpvCode;
+		if (SplitDebugInfo)
+		{
+			debugSpvCode = std::move(result.SpvCode);
+			result.SpvCode = ShaderOptimizer::StripDebugInfo(debugSpvCode);
+		}
+
+		// Compilation can run on a background thread, so unsupported bindings are reported instead of thrown.
+		try
+		{
+			result.BindingLayouts = ReflectBindingLayouts(result.SpvCode);
+		}
+		catch (const std::runtime_error& exception)
+		{
+			result.Status = ShaderCompileStatus::ReflectionFailed;
+			result.InfoLog = exception.what();
+			return result;
+		}
+
+		result.Status = ShaderCompileStatus::Success;
+
+		ShaderCache::Store(cacheKey, cacheKeySource, result);
+
+		if (!debugSpvCode.empty())
+		{
+			result.DebugInfoPath = ShaderCache::StoreDebugInfo(cacheKey, debugSpvCode);
+		}
+
+		if (!CheckDeviceLimits(result.SpvCode, result.InfoLog))
+		{
+			result.Status = ShaderCompileStatus::ReflectionFailed;
+		}
+
+		return result;
+	}
+
+	static ShaderCompileResult GetLoadingFailedResult(const std::string& inInfoLog)
+	{
+		ShaderCompileResult result{};
+		result.Status = ShaderCompileStatus::LoadingFailed;
+		result.InfoLog = inInfoLog;
+		return result;
+	}
+
+	// Precompiled modules skip the compiler and the cache, they only have to be checked before the device sees them.
+	ShaderCompileResult LoadPrecompiled(const ShaderStage inStage, const std::vector<uint32_t>& inSpvCode, const std::string& inCodeEntry)
+	{
+		if (inSpvCode.size() < SpvHeaderWordCount || inSpvCode[0] != SpvMagicNumber)
+		{
+			return GetLoadingFailedResult("File isn't a SPIR-V module.\n");
+		}
+
+		SpvReflectShaderModule spvModule;
+		if (spvReflectCreateShaderModule(sizeof(uint32_t) * inSpvCode.size(), inSpvCode.data(), &spvModule) != SPV_REFLECT_RESULT_SUCCESS)
+		{
+			return GetLoadingFailedResult("SPIR-V module is malformed.\n");
+		}
+
+		const SpvReflectEntryPoint* entryPoint = spvReflectGetEntryPoint(&spvModule, inCodeEntry.c_str());
+		const bool hasEntryPoint = entryPoint != nullptr && entryPoint->shader_stage == GetSpvReflectShaderStage(inStage);
+		spvReflectDestroyShaderModule(&spvModule);
+
+		if (!hasEntryPoint)
+		{
+			return GetLoadingFailedResult("SPIR-V module has no " + inCodeEntry + " entry point for the required shader stage.\n");
+		}
+
+		ShaderCompileResult result{};
+
+		try
+		{
+			result.BindingLayouts = ReflectBindingLayouts(inSpvCode);
+		}
+		catch (const std::runtime_error& exception)
+		{
+			result.Status = ShaderCompileStatus::ReflectionFailed;
+			result.InfoLog = exception.what();
+			return result;
+		}
+
+		result.Status = CheckDeviceLimits(inSpvCode, result.InfoLog) ? ShaderCompileStatus::Success : ShaderCompileStatus::ReflectionFailed;
+		result.SpvCode = inSpvCode;
 		return result;
 	}
 
@@ -141,6 +431,15 @@ namespace ShaderCompiler
 		case ShaderCompileStatus::LinkingFailed:
 			return "Linking";
 
+		case ShaderCompileStatus::OptimizationFailed:
+			return "Optimization";
+
+		case ShaderCompileStatus::ReflectionFailed:
+			return "Reflection";
+
+		case ShaderCompileStatus::LoadingFailed:
+			return "Loading";
+
 		default:
 			FT_FAIL("Unsupported ShaderCompileStatus.");
 		}
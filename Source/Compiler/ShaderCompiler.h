@@ -1,5 +1,8 @@
 #pragma once
 
+#include "ShaderReflect.h"
+#include "ShaderOptimizer.h"
+
 FT_BEGIN_NAMESPACE
 
 enum class ShaderLanguage : uint8_t;
@@ -11,22 +14,60 @@ enum class ShaderCompileStatus : uint8_t
 	PreprocessingFailed,
 	ParsingFailed,
 	LinkingFailed,
+	OptimizationFailed,
+	ReflectionFailed,
+	LoadingFailed,
 
 	Count
 };
 
+struct ShaderDefine
+{
+	std::string Name;
+	std::string Value;
+};
+
+struct ShaderCompileOptions
+{
+	std::string SourcePath;
+	std::string CodeEntry = "main";
+	ShaderOptimizationLevel OptimizationLevel = ShaderOptimizationLevel::None;
+	std::vector<ShaderDefine> Defines;
+	std::vector<std::string> IncludeDirectories;
+};
+
+// Limits of the device compiled shaders are created on, shaders exceeding them fail reflection instead of pipeline creation.
+// Defaults don't restrict anything, processes without a device, like the compile server, leave the check to their clients.
+struct ShaderDeviceLimits
+{
+	uint32_t MaxPushConstantsSize = UINT32_MAX;
+
+	// Runtime sized arrays are only partially bound, which requires descriptor indexing.
+	bool DescriptorIndexingSupported = true;
+};
+
 struct ShaderCompileResult
 {
 	ShaderCompileStatus Status = ShaderCompileStatus::Count;
 	std::vector<uint32_t> SpvCode;
+	std::vector<BindingLayout> BindingLayouts;
+	std::vector<std::string> IncludedFiles;
+	std::string DebugInfoPath;
 	std::string InfoLog;
+	uint64_t UnoptimizedSize = 0;
+	double OptimizationTime = 0.0;
+	bool CacheHit = false;
 };
 
 namespace ShaderCompiler
 {
 	extern void Initialize();
 	extern void Finalize();
-	extern ShaderCompileResult Compile(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const std::string inCodeEntry = "main");
+	extern void ResetThreadContext();
+	extern void SetDeviceLimits(const ShaderDeviceLimits& inDeviceLimits);
+	extern bool CheckDeviceLimits(const std::vector<uint32_t>& inSpvCode, std::string& outInfoLog);
+	extern ShaderCompileResult Compile(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode, const ShaderCompileOptions& inOptions = ShaderCompileOptions());
+	extern ShaderCompileResult LoadPrecompiled(const ShaderStage inStage, const std::vector<uint32_t>& inSpvCode, const std::string& inCodeEntry = "main");
 	extern const char* GetStatusText(const ShaderCompileStatus inStatus);
 }
 
@@ -1,7 +1,293 @@
 #include "ShaderFileIncluder.h"
+#include "Utility/Hash.hpp"
 
 FT_BEGIN_NAMESPACE
 
-// TODO: Implement.
+struct IncludeFile
+{
+	std::string Path;
+	std::string Contents;
+	uint64_t Size = 0;
+	int64_t ModificationTime = 0;
+	uint64_t Hash = 0;
+
+	// Read while the modification time was still within the file system granularity, so another write might not have
+	// changed it. Contents of such files are read and compared again, even if their modification time and size match.
+	bool Racy = false;
+};
+
+typedef std::shared_ptr<const IncludeFile> IncludeFileHandle;
+
+namespace ShaderIncludes
+{
+	static std::mutex s_Mutex;
+	static std::vector<std::string> s_SearchPaths;
+	static std::map<std::string, IncludeFileHandle> s_Files;
+	static std::map<std::string, std::set<std::string>> s_Dependencies;
+	static std::map<std::string, std::set<std::string>> s_Dependents;
+	static std::atomic<uint64_t> s_FileReads(0);
+	static std::atomic<uint64_t> s_CacheHits(0);
+
+	// Coarsest modification time step of common file systems (FAT), in nanoseconds. Finer ones only shorten the racy window.
+	static const int64_t ModificationTimeGranularity = 2000000000ll;
+
+	static bool IsSameFile(const IncludeFile& inIncludeFile, const FileInfo& inFileInfo)
+	{
+		return inIncludeFile.ModificationTime == inFileInfo.PreciseModificationTime && inIncludeFile.Size == inFileInfo.Size;
+	}
+
+	static IncludeFileHandle ReadIncludeFile(const std::string& inPath, const FileInfo& inFileInfo)
+	{
+		// Time is taken before reading, so writes which happen during the read are covered by the racy check as well.
+		const int64_t readTime = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+
+		std::string contents;
+		if (!ReadBinaryFile(inPath, contents))
+		{
+			return nullptr;
+		}
+
+		++s_FileReads;
+
+		std::shared_ptr<IncludeFile> includeFile = std::make_shared<IncludeFile>();
+		includeFile->Path = inPath;
+		includeFile->Contents = std::move(contents);
+		includeFile->Size = inFileInfo.Size;
+		includeFile->ModificationTime = inFileInfo.PreciseModificationTime;
+		includeFile->Hash = HashString(includeFile->Contents);
+		includeFile->Racy = readTime - inFileInfo.PreciseModificationTime < ModificationTimeGranularity;
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_Files[inPath] = includeFile;
+
+		return includeFile;
+	}
+
+	static IncludeFileHandle TryLoadFile(const std::string& inPath)
+	{
+		FileInfo fileInfo;
+		if (!QueryFileInfo(inPath, fileInfo))
+		{
+			return nullptr;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+
+			auto fileIterator = s_Files.find(inPath);
+			if (fileIterator != s_Files.end() && !fileIterator->second->Racy && IsSameFile(*fileIterator->second, fileInfo))
+			{
+				++s_CacheHits;
+				return fileIterator->second;
+			}
+		}
+
+		return ReadIncludeFile(inPath, fileInfo);
+	}
+
+	void SetSearchPaths(const std::vector<std::string>& inSearchPaths)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		s_SearchPaths.clear();
+		for (const std::string& searchPath : inSearchPaths)
+		{
+			s_SearchPaths.push_back(NormalizePath(searchPath));
+		}
+	}
+
+	std::vector<std::string> GetSearchPaths()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return s_SearchPaths;
+	}
+
+	void UpdateDependencies(const std::string& inShaderPath, const std::vector<std::string>& inIncludedFiles)
+	{
+		const std::string shaderPath = NormalizePath(inShaderPath);
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		std::set<std::string>& dependencies = s_Dependencies[shaderPath];
+		for (const std::string& dependency : dependencies)
+		{
+			s_Dependents[dependency].erase(shaderPath);
+		}
+
+		dependencies = std::set<std::string>(inIncludedFiles.begin(), inIncludedFiles.end());
+		for (const std::string& dependency : dependencies)
+		{
+			s_Dependents[dependency].insert(shaderPath);
+		}
+	}
+
+	std::vector<std::string> GetDependencies(const std::string& inShaderPath)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto dependenciesIterator = s_Dependencies.find(NormalizePath(inShaderPath));
+		if (dependenciesIterator == s_Dependencies.end())
+		{
+			return std::vector<std::string>();
+		}
+
+		return std::vector<std::string>(dependenciesIterator->second.begin(), dependenciesIterator->second.end());
+	}
+
+	std::vector<std::string> GetAffectedShaders(const std::string& inIncludePath)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto dependentsIterator = s_Dependents.find(NormalizePath(inIncludePath));
+		if (dependentsIterator == s_Dependents.end())
+		{
+			return std::vector<std::string>();
+		}
+
+		return std::vector<std::string>(dependentsIterator->second.begin(), dependentsIterator->second.end());
+	}
+
+	bool TryGetContentHash(const std::string& inIncludePath, uint64_t& outHash)
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+
+		auto fileIterator = s_Files.find(NormalizePath(inIncludePath));
+		if (fileIterator == s_Files.end())
+		{
+			return false;
+		}
+
+		outHash = fileIterator->second->Hash;
+
+		return true;
+	}
+
+	std::vector<std::string> GetModifiedFiles()
+	{
+		std::vector<IncludeFileHandle> includeFiles;
+
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			for (const auto& file : s_Files)
+			{
+				includeFiles.push_back(file.second);
+			}
+		}
+
+		// Files stay modified until the next compilation which includes them reloads the cached contents.
+		std::vector<std::string> modifiedFiles;
+		for (const IncludeFileHandle& includeFile : includeFiles)
+		{
+			FileInfo fileInfo;
+			if (!QueryFileInfo(includeFile->Path, fileInfo) || !IsSameFile(*includeFile, fileInfo))
+			{
+				modifiedFiles.push_back(includeFile->Path);
+				continue;
+			}
+
+			// Unchanged contents replace the racy entry, which stops being racy once the granularity window has passed.
+			if (includeFile->Racy)
+			{
+				IncludeFileHandle reloadedFile = ReadIncludeFile(includeFile->Path, fileInfo);
+				if (reloadedFile == nullptr || reloadedFile->Hash != includeFile->Hash)
+				{
+					modifiedFiles.push_back(includeFile->Path);
+				}
+			}
+		}
+
+		return modifiedFiles;
+	}
+
+	void TrackFiles(const std::vector<std::string>& inPaths)
+	{
+		for (const std::string& path : inPaths)
+		{
+			TryLoadFile(NormalizePath(path));
+		}
+	}
+
+	ShaderIncludeStatistics GetStatistics()
+	{
+		ShaderIncludeStatistics statistics;
+		statistics.FileReads = s_FileReads;
+		statistics.CacheHits = s_CacheHits;
+		return statistics;
+	}
+}
+
+ShaderFileIncluder::ShaderFileIncluder(const std::string& inShaderPath, const std::vector<std::string>& inSearchPaths)
+	: m_ShaderPath(NormalizePath(inShaderPath))
+{
+	if (inSearchPaths.empty())
+	{
+		m_SearchPaths = ShaderIncludes::GetSearchPaths();
+		return;
+	}
+
+	for (const std::string& searchPath : inSearchPaths)
+	{
+		m_SearchPaths.push_back(NormalizePath(searchPath));
+	}
+}
+
+glslang::TShader::Includer::IncludeResult* ShaderFileIncluder::includeSystem(const char* inHeaderName, const char* inIncluderName, size_t inInclusionDepth)
+{
+	for (const std::string& searchPath : m_SearchPaths)
+	{
+		IncludeResult* includeResult = TryInclude(CombinePath(searchPath, inHeaderName));
+		if (includeResult != nullptr)
+		{
+			return includeResult;
+		}
+	}
+
+	return nullptr;
+}
+
+glslang::TShader::Includer::IncludeResult* ShaderFileIncluder::includeLocal(const char* inHeaderName, const char* inIncluderName, size_t inInclusionDepth)
+{
+	// Nested includes get the resolved path of their parent, the shader itself is compiled from an unnamed string.
+	const std::string includerPath = (inIncluderName != nullptr && inIncluderName[0] != '\0') ? std::string(inIncluderName) : m_ShaderPath;
+	if (includerPath.empty())
+	{
+		return nullptr;
+	}
+
+	// Glslang falls back to includeSystem on its own if this fails.
+	return TryInclude(CombinePath(ExtractDirectory(includerPath), inHeaderName));
+}
+
+void ShaderFileIncluder::releaseInclude(IncludeResult* inIncludeResult)
+{
+	if (inIncludeResult == nullptr)
+	{
+		return;
+	}
+
+	delete(static_cast<IncludeFileHandle*>(inIncludeResult->userData));
+	delete(inIncludeResult);
+}
+
+glslang::TShader::Includer::IncludeResult* ShaderFileIncluder::TryInclude(const std::string& inPath)
+{
+	const std::string includePath = NormalizePath(inPath);
+
+	IncludeFileHandle includeFile = ShaderIncludes::TryLoadFile(includePath);
+	if (includeFile == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (std::find(m_IncludedFiles.begin(), m_IncludedFiles.end(), includePath) == m_IncludedFiles.end())
+	{
+		m_IncludedFiles.push_back(includePath);
+	}
+
+	// Handle keeps the cached contents alive until glslang releases the include, even if the file changes meanwhile.
+	IncludeFileHandle* includeFileHandle = new IncludeFileHandle(includeFile);
+	return new IncludeResult(includePath, includeFile->Contents.c_str(), includeFile->Contents.length(), includeFileHandle);
+}
 
 FT_END_NAMESPACE
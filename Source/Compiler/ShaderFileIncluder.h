@@ -4,9 +4,51 @@
 
 FT_BEGIN_NAMESPACE
 
+struct ShaderIncludeStatistics
+{
+	uint64_t FileReads = 0;
+	uint64_t CacheHits = 0;
+};
+
+// Resolves #include directives of a single compilation. Local includes are looked up relative to the including file first,
+// system includes and unresolved local includes go through the search paths. Contents come from the shared include cache.
+// Without explicit search paths, the session wide ones are used.
 class ShaderFileIncluder : public glslang::TShader::Includer
 {
-	virtual void releaseInclude(IncludeResult*) override {};
+public:
+	ShaderFileIncluder(const std::string& inShaderPath, const std::vector<std::string>& inSearchPaths);
+	FT_DELETE_COPY_AND_MOVE(ShaderFileIncluder)
+
+public:
+	virtual IncludeResult* includeSystem(const char* inHeaderName, const char* inIncluderName, size_t inInclusionDepth) override;
+	virtual IncludeResult* includeLocal(const char* inHeaderName, const char* inIncluderName, size_t inInclusionDepth) override;
+	virtual void releaseInclude(IncludeResult* inIncludeResult) override;
+
+public:
+	const std::vector<std::string>& GetIncludedFiles() const { return m_IncludedFiles; }
+
+private:
+	IncludeResult* TryInclude(const std::string& inPath);
+
+private:
+	std::string m_ShaderPath;
+	std::vector<std::string> m_SearchPaths;
+	std::vector<std::string> m_IncludedFiles;
 };
 
+// Session wide state shared by all includers. Include file contents are kept in memory and only read again
+// once their modification time or size changes, or when they were read too close to their last write to trust either. Every compiled shader records the files it includes, directly or not.
+namespace ShaderIncludes
+{
+	extern void SetSearchPaths(const std::vector<std::string>& inSearchPaths);
+	extern std::vector<std::string> GetSearchPaths();
+	extern void UpdateDependencies(const std::string& inShaderPath, const std::vector<std::string>& inIncludedFiles);
+	extern std::vector<std::string> GetDependencies(const std::string& inShaderPath);
+	extern std::vector<std::string> GetAffectedShaders(const std::string& inIncludePath);
+	extern bool TryGetContentHash(const std::string& inIncludePath, uint64_t& outHash);
+	extern std::vector<std::string> GetModifiedFiles();
+	extern void TrackFiles(const std::vector<std::string>& inPaths);
+	extern ShaderIncludeStatistics GetStatistics();
+}
+
 FT_END_NAMESPACE
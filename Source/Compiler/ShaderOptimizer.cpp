@@ -0,0 +1,202 @@
+#include "ShaderOptimizer.h"
+
+#include <spirv-tools/optimizer.hpp>
+#include <spirv-tools/libspirv.hpp>
+
+FT_BEGIN_NAMESPACE
+
+namespace ShaderOptimizer
+{
+	static const uint32_t SpvHeaderWordCount = 5;
+	static const uint32_t SpvOpCodeMask = 0xFFFF;
+	static const uint32_t SpvWordCountShift = 16;
+
+	// Registering the -O or -Os recipe creates dozens of passes, so each thread keeps its optimizers between compilations.
+	static thread_local std::unique_ptr<spvtools::Optimizer> s_ThreadOptimizers[static_cast<size_t>(ShaderOptimizationLevel::Count)];
+
+	static spvtools::Optimizer& GetThreadOptimizer(const ShaderOptimizationLevel inLevel)
+	{
+		std::unique_ptr<spvtools::Optimizer>& optimizer = s_ThreadOptimizers[static_cast<size_t>(inLevel)];
+		if (optimizer)
+		{
+			return *optimizer;
+		}
+
+		optimizer.reset(new spvtools::Optimizer(SPV_ENV_VULKAN_1_0));
+
+		switch (inLevel)
+		{
+		case ShaderOptimizationLevel::Performance:
+			optimizer->RegisterPerformancePasses();
+			break;
+
+		case ShaderOptimizationLevel::Size:
+			optimizer->RegisterSizePasses();
+			break;
+
+		default:
+			FT_FAIL("Unsupported ShaderOptimizationLevel.");
+		}
+
+		return *optimizer;
+	}
+
+	static bool IsDebugInstruction(const uint32_t inOpCode)
+	{
+		// Names are kept on purpose, since reflection and the bindings window rely on them.
+		switch (inOpCode)
+		{
+		case 2:   // OpSourceContinued
+		case 3:   // OpSource
+		case 4:   // OpSourceExtension
+		case 7:   // OpString
+		case 8:   // OpLine
+		case 317: // OpNoLine
+		case 330: // OpModuleProcessed
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	void ResetThreadOptimizers()
+	{
+		for (std::unique_ptr<spvtools::Optimizer>& optimizer : s_ThreadOptimizers)
+		{
+			optimizer.reset();
+		}
+	}
+
+	bool Optimize(const ShaderOptimizationLevel inLevel, const std::vector<uint32_t>& inSpvCode, std::vector<uint32_t>& outSpvCode, std::string& outInfoLog)
+	{
+		if (inLevel == ShaderOptimizationLevel::None)
+		{
+			outSpvCode = inSpvCode;
+			return true;
+		}
+
+		spvtools::Optimizer& optimizer = GetThreadOptimizer(inLevel);
+		optimizer.SetMessageConsumer([&outInfoLog](spv_message_level_t, const char*, const spv_position_t&, const char* inMessage)
+			{
+				outInfoLog += inMessage;
+				outInfoLog += "\n";
+			});
+
+		const bool optimized = optimizer.Run(inSpvCode.data(), inSpvCode.size(), &outSpvCode);
+
+		// Optimizer outlives this call, so its consumer can't keep referencing the info log of the caller.
+		optimizer.SetMessageConsumer([](spv_message_level_t, const char*, const spv_position_t&, const char*) {});
+
+		return optimized;
+	}
+
+	// Every float operation is decorated with RelaxedPrecision, which drivers are free to execute at 16 bits or ignore.
+	// Converting to half makes the reduced precision explicit and requires the shaderFloat16 device feature.
+	bool RelaxPrecision(const std::vector<uint32_t>& inSpvCode, const bool inConvertToHalf, std::vector<uint32_t>& outSpvCode, std::string& outInfoLog)
+	{
+		spvtools::Optimizer optimizer(SPV_ENV_VULKAN_1_0);
+		optimizer.SetMessageConsumer([&outInfoLog](spv_message_level_t, const char*, const spv_position_t&, const char* inMessage)
+			{
+				outInfoLog += inMessage;
+				outInfoLog += "\n";
+			});
+
+		if (inConvertToHalf)
+		{
+			// Conversion only follows values through SSA, function local variables would stay 32 bits wide.
+			optimizer.RegisterPass(spvtools::CreateSSARewritePass());
+		}
+
+		optimizer.RegisterPass(spvtools::CreateRelaxFloatOpsPass());
+
+		if (inConvertToHalf)
+		{
+			optimizer.RegisterPass(spvtools::CreateConvertRelaxedToHalfPass());
+			optimizer.RegisterPass(spvtools::CreateSimplificationPass());
+			optimizer.RegisterPass(spvtools::CreateAggressiveDCEPass());
+		}
+
+		return optimizer.Run(inSpvCode.data(), inSpvCode.size(), &outSpvCode);
+	}
+
+	std::vector<uint32_t> StripDebugInfo(const std::vector<uint32_t>& inSpvCode)
+	{
+		if (inSpvCode.size() < SpvHeaderWordCount)
+		{
+			return inSpvCode;
+		}
+
+		std::vector<uint32_t> strippedSpvCode;
+		strippedSpvCode.reserve(inSpvCode.size());
+		strippedSpvCode.insert(strippedSpvCode.end(), inSpvCode.begin(), inSpvCode.begin() + SpvHeaderWordCount);
+
+		size_t wordIndex = SpvHeaderWordCount;
+		while (wordIndex < inSpvCode.size())
+		{
+			const uint32_t instructionWordCount = inSpvCode[wordIndex] >> SpvWordCountShift;
+			const uint32_t opCode = inSpvCode[wordIndex] & SpvOpCodeMask;
+
+			// Malformed module, leave it as it is and let the driver or validation layers report it.
+			if (instructionWordCount == 0 || wordIndex + instructionWordCount > inSpvCode.size())
+			{
+				return inSpvCode;
+			}
+
+			if (!IsDebugInstruction(opCode))
+			{
+				strippedSpvCode.insert(strippedSpvCode.end(), inSpvCode.begin() + wordIndex, inSpvCode.begin() + wordIndex + instructionWordCount);
+			}
+
+			wordIndex += instructionWordCount;
+		}
+
+		return strippedSpvCode;
+	}
+
+	std::string Disassemble(const std::vector<uint32_t>& inSpvCode)
+	{
+		std::string errorText;
+
+		spvtools::SpirvTools tools(SPV_ENV_UNIVERSAL_1_5);
+		tools.SetMessageConsumer([&errorText](spv_message_level_t, const char*, const spv_position_t&, const char* inMessage)
+			{
+				errorText += inMessage;
+			});
+
+		std::string disassembly;
+		const uint32_t options = SPV_BINARY_TO_TEXT_OPTION_INDENT | SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES | SPV_BINARY_TO_TEXT_OPTION_COMMENT;
+		if (!tools.Disassemble(inSpvCode, &disassembly, options))
+		{
+			// Shown in the editor instead of the disassembly, loading reports the actual error.
+			return "; Failed disassembling SPIR-V module: " + errorText + "\n";
+		}
+
+		return disassembly;
+	}
+
+	const char* GetToolVersionText()
+	{
+		return spvSoftwareVersionDetailsString();
+	}
+
+	const char* GetLevelText(const ShaderOptimizationLevel inLevel)
+	{
+		switch (inLevel)
+		{
+		case ShaderOptimizationLevel::None:
+			return "None";
+
+		case ShaderOptimizationLevel::Performance:
+			return "Performance (-O)";
+
+		case ShaderOptimizationLevel::Size:
+			return "Size (-Os)";
+
+		default:
+			FT_FAIL("Unsupported ShaderOptimizationLevel.");
+		}
+	}
+}
+
+FT_END_NAMESPACE
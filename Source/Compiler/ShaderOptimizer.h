@@ -0,0 +1,25 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+enum class ShaderOptimizationLevel : uint8_t
+{
+	None,
+	Performance,
+	Size,
+
+	Count
+};
+
+namespace ShaderOptimizer
+{
+	extern void ResetThreadOptimizers();
+	extern bool Optimize(const ShaderOptimizationLevel inLevel, const std::vector<uint32_t>& inSpvCode, std::vector<uint32_t>& outSpvCode, std::string& outInfoLog);
+	extern bool RelaxPrecision(const std::vector<uint32_t>& inSpvCode, const bool inConvertToHalf, std::vector<uint32_t>& outSpvCode, std::string& outInfoLog);
+	extern std::vector<uint32_t> StripDebugInfo(const std::vector<uint32_t>& inSpvCode);
+	extern std::string Disassemble(const std::vector<uint32_t>& inSpvCode);
+	extern const char* GetToolVersionText();
+	extern const char* GetLevelText(const ShaderOptimizationLevel inLevel);
+}
+
+FT_END_NAMESPACE
@@ -20,6 +20,9 @@ static VkDescriptorType GetVkDescriptorType(const SpvReflectDescriptorType inDes
 	case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
 		return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 
+	case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+		return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
 	case SPV_REFLECT_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
 		return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
 
@@ -31,6 +34,20 @@ static VkDescriptorType GetVkDescriptorType(const SpvReflectDescriptorType inDes
 	}
 }
 
+// Only texture arrays are backed by a resource, other runtime arrays would get a layout without anything to bind.
+static void CheckRuntimeArrayType(const VkDescriptorType inDescriptorType)
+{
+	if (inDescriptorType != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+	{
+		FT_FAIL("Only combined image sampler runtime arrays are supported.");
+	}
+}
+
+bool IsRuntimeArrayBinding(const SpvReflectDescriptorBinding& inReflectDescriptorBinding)
+{
+	return inReflectDescriptorBinding.type_description != nullptr && inReflectDescriptorBinding.type_description->op == SpvOpTypeRuntimeArray;
+}
+
 std::vector<Binding> ReflectShader(const std::vector<uint32_t>& inSpvCode, const VkShaderStageFlags inShaderStage, SpvReflectShaderModule& outSpvModule)
 {
 	size_t spvCodeSize = sizeof(uint32_t) * inSpvCode.size();
@@ -55,10 +72,216 @@ std::vector<Binding> ReflectShader(const std::vector<uint32_t>& inSpvCode, const
 		descriptorSetLayoutBinding.stageFlags = inShaderStage;
 		descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
 
+		if (IsRuntimeArrayBinding(*spvBindings[bindingIndex]))
+		{
+			CheckRuntimeArrayType(descriptorSetLayoutBinding.descriptorType);
+			descriptorSetLayoutBinding.descriptorCount = g_RuntimeArrayCapacity;
+		}
+
 		binding.ReflectDescriptorBinding = *spvBindings[bindingIndex];
 	}
 
 	return bindings;
 }
 
+std::vector<BindingLayout> ReflectBindingLayouts(const std::vector<uint32_t>& inSpvCode)
+{
+	SpvReflectShaderModule spvModule;
+	FT_SPV_REFLECT_CALL(spvReflectCreateShaderModule(sizeof(uint32_t) * inSpvCode.size(), inSpvCode.data(), &spvModule));
+
+	uint32_t bindingCount = 0;
+	FT_SPV_REFLECT_CALL(spvReflectEnumerateDescriptorBindings(&spvModule, &bindingCount, nullptr));
+
+	std::vector<SpvReflectDescriptorBinding*> spvBindings(bindingCount);
+	FT_SPV_REFLECT_CALL(spvReflectEnumerateDescriptorBindings(&spvModule, &bindingCount, spvBindings.data()));
+
+	std::vector<BindingLayout> bindingLayouts(bindingCount);
+	try
+	{
+		for (uint32_t bindingIndex = 0; bindingIndex < bindingCount; ++bindingIndex)
+		{
+			const SpvReflectDescriptorBinding* spvBinding = spvBindings[bindingIndex];
+
+			BindingLayout& bindingLayout = bindingLayouts[bindingIndex];
+			bindingLayout.Set = spvBinding->set;
+			bindingLayout.Binding = spvBinding->binding;
+			bindingLayout.DescriptorType = GetVkDescriptorType(spvBinding->descriptor_type);
+			bindingLayout.DescriptorCount = spvBinding->count;
+			bindingLayout.Name = spvBinding->name != nullptr ? spvBinding->name : "";
+
+			if (IsRuntimeArrayBinding(*spvBinding))
+			{
+				CheckRuntimeArrayType(bindingLayout.DescriptorType);
+			}
+		}
+	}
+	catch (...)
+	{
+		// Callers recover from unsupported bindings, so the module must not leak.
+		spvReflectDestroyShaderModule(&spvModule);
+		throw;
+	}
+
+	spvReflectDestroyShaderModule(&spvModule);
+
+	return bindingLayouts;
+}
+
+const SpvReflectBlockVariable* ReflectPushConstantBlock(SpvReflectShaderModule& inSpvModule)
+{
+	uint32_t blockCount = 0;
+	FT_SPV_REFLECT_CALL(spvReflectEnumeratePushConstantBlocks(&inSpvModule, &blockCount, nullptr));
+
+	if (blockCount == 0)
+	{
+		return nullptr;
+	}
+
+	std::vector<SpvReflectBlockVariable*> spvBlocks(blockCount);
+	FT_SPV_REFLECT_CALL(spvReflectEnumeratePushConstantBlocks(&inSpvModule, &blockCount, spvBlocks.data()));
+
+	return spvBlocks[0];
+}
+
+ShaderDeviceRequirements ReflectDeviceRequirements(const std::vector<uint32_t>& inSpvCode)
+{
+	SpvReflectShaderModule spvModule;
+	FT_SPV_REFLECT_CALL(spvReflectCreateShaderModule(sizeof(uint32_t) * inSpvCode.size(), inSpvCode.data(), &spvModule));
+
+	ShaderDeviceRequirements deviceRequirements;
+
+	const SpvReflectBlockVariable* pushConstantBlock = ReflectPushConstantBlock(spvModule);
+	deviceRequirements.PushConstantSize = pushConstantBlock != nullptr ? pushConstantBlock->padded_size : 0;
+
+	uint32_t bindingCount = 0;
+	FT_SPV_REFLECT_CALL(spvReflectEnumerateDescriptorBindings(&spvModule, &bindingCount, nullptr));
+
+	std::vector<SpvReflectDescriptorBinding*> spvBindings(bindingCount);
+	FT_SPV_REFLECT_CALL(spvReflectEnumerateDescriptorBindings(&spvModule, &bindingCount, spvBindings.data()));
+
+	for (const SpvReflectDescriptorBinding* spvBinding : spvBindings)
+	{
+		deviceRequirements.RuntimeArrays |= IsRuntimeArrayBinding(*spvBinding);
+	}
+
+	spvReflectDestroyShaderModule(&spvModule);
+
+	return deviceRequirements;
+}
+
+static std::string ReadSpvString(const std::vector<uint32_t>& inSpvCode, const size_t inWordOffset, const size_t inWordEnd)
+{
+	std::string text;
+	for (size_t wordIndex = inWordOffset; wordIndex < inWordEnd; ++wordIndex)
+	{
+		for (uint32_t byteIndex = 0; byteIndex < sizeof(uint32_t); ++byteIndex)
+		{
+			const char character = static_cast<char>((inSpvCode[wordIndex] >> (8 * byteIndex)) & 0xFF);
+			if (character == '\0')
+			{
+				return text;
+			}
+
+			text += character;
+		}
+	}
+
+	return text;
+}
+
+// SPIRV-Reflect doesn't expose specialization constants, so they are read directly from the instruction stream.
+std::vector<SpecializationConstant> ReflectSpecializationConstants(const std::vector<uint32_t>& inSpvCode)
+{
+	const static size_t SpvHeaderWordCount = 5;
+
+	struct SpecConstantDeclaration
+	{
+		uint32_t TypeId;
+		uint32_t Value;
+	};
+
+	std::map<uint32_t, std::string> names;
+	std::map<uint32_t, uint32_t> specIds;
+	std::map<uint32_t, SpecializationConstantType> types;
+	std::map<uint32_t, SpecConstantDeclaration> declarations;
+
+	size_t wordIndex = SpvHeaderWordCount;
+	while (wordIndex < inSpvCode.size())
+	{
+		const uint32_t opCode = inSpvCode[wordIndex] & SpvOpCodeMask;
+		const uint32_t wordCount = inSpvCode[wordIndex] >> SpvWordCountShift;
+		if (wordCount == 0 || wordIndex + wordCount > inSpvCode.size())
+		{
+			break;
+		}
+
+		const uint32_t* operands = inSpvCode.data() + wordIndex + 1;
+
+		if (opCode == SpvOpName && wordCount >= 3)
+		{
+			names[operands[0]] = ReadSpvString(inSpvCode, wordIndex + 2, wordIndex + wordCount);
+		}
+		else if (opCode == SpvOpDecorate && wordCount == 4 && operands[1] == SpvDecorationSpecId)
+		{
+			specIds[operands[0]] = operands[2];
+		}
+		else if (opCode == SpvOpTypeBool && wordCount == 2)
+		{
+			types[operands[0]] = SpecializationConstantType::Bool;
+		}
+		else if (opCode == SpvOpTypeInt && wordCount == 4 && operands[1] == 32)
+		{
+			types[operands[0]] = operands[2] ? SpecializationConstantType::Int : SpecializationConstantType::UInt;
+		}
+		else if (opCode == SpvOpTypeFloat && wordCount == 3 && operands[1] == 32)
+		{
+			types[operands[0]] = SpecializationConstantType::Float;
+		}
+		else if ((opCode == SpvOpSpecConstantTrue || opCode == SpvOpSpecConstantFalse) && wordCount == 3)
+		{
+			declarations[operands[1]] = { operands[0], opCode == SpvOpSpecConstantTrue ? 1u : 0u };
+		}
+		else if (opCode == SpvOpSpecConstant && wordCount == 4)
+		{
+			declarations[operands[1]] = { operands[0], operands[2] };
+		}
+
+		wordIndex += wordCount;
+	}
+
+	std::vector<SpecializationConstant> specializationConstants;
+	for (const auto& declarationIterator : declarations)
+	{
+		const uint32_t resultId = declarationIterator.first;
+		const SpecConstantDeclaration& declaration = declarationIterator.second;
+
+		// Constants without SpecId are operations on other constants, 64-bit ones have no matching type entry.
+		const auto specIdIterator = specIds.find(resultId);
+		const auto typeIterator = types.find(declaration.TypeId);
+		if (specIdIterator == specIds.end() || typeIterator == types.end())
+		{
+			continue;
+		}
+
+		SpecializationConstant specializationConstant;
+		specializationConstant.ConstantId = specIdIterator->second;
+		specializationConstant.Type = typeIterator->second;
+		specializationConstant.DefaultValue = declaration.Value;
+		specializationConstant.Value = declaration.Value;
+
+		const auto nameIterator = names.find(resultId);
+		specializationConstant.Name = nameIterator != names.end() && !nameIterator->second.empty() ?
+			nameIterator->second : "Constant " + std::to_string(specializationConstant.ConstantId);
+
+		specializationConstants.push_back(specializationConstant);
+	}
+
+	std::sort(specializationConstants.begin(), specializationConstants.end(), [](const SpecializationConstant& inLeft, const SpecializationConstant& inRight)
+		{
+			return inLeft.ConstantId < inRight.ConstantId;
+		});
+
+	return specializationConstants;
+}
+
 FT_END_NAMESPACE
@@ -2,6 +2,54 @@
 
 FT_BEGIN_NAMESPACE
 
+// Pointer free summary of a reflected descriptor binding, which can be stored outside of a SpvReflectShaderModule.
+struct BindingLayout
+{
+	uint32_t Set = 0;
+	uint32_t Binding = 0;
+	VkDescriptorType DescriptorType = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+	uint32_t DescriptorCount = 0;
+	std::string Name;
+};
+
+enum class SpecializationConstantType : uint8_t
+{
+	Bool,
+	Int,
+	UInt,
+	Float,
+
+	Count
+};
+
+// Only 32-bit scalar constants are reflected, which covers bool, int, uint and float.
+struct SpecializationConstant
+{
+	uint32_t ConstantId = 0;
+	SpecializationConstantType Type = SpecializationConstantType::Count;
+	std::string Name;
+	uint32_t DefaultValue = 0;
+	uint32_t Value = 0;
+};
+
+// Parts of a module which depend on limits of the device it's created on.
+struct ShaderDeviceRequirements
+{
+	uint32_t PushConstantSize = 0;
+	bool RuntimeArrays = false;
+};
+
+// Runtime sized arrays get a fixed capacity in the set layout. It's far below the update after bind limits which descriptor
+// indexing guarantees, so it doesn't have to be queried from the device.
+const uint32_t g_RuntimeArrayCapacity = 1024;
+
+extern bool IsRuntimeArrayBinding(const SpvReflectDescriptorBinding& inReflectDescriptorBinding);
 extern std::vector<struct Binding> ReflectShader(const std::vector<uint32_t>& inSpvCode, const VkShaderStageFlags inShaderStage, SpvReflectShaderModule& outSpvModule);
+extern std::vector<BindingLayout> ReflectBindingLayouts(const std::vector<uint32_t>& inSpvCode);
+extern std::vector<SpecializationConstant> ReflectSpecializationConstants(const std::vector<uint32_t>& inSpvCode);
+extern ShaderDeviceRequirements ReflectDeviceRequirements(const std::vector<uint32_t>& inSpvCode);
+
+// Entry point can use only a single push constant block, nullptr is returned when there's none. Block is owned by the module.
+extern const SpvReflectBlockVariable* ReflectPushConstantBlock(SpvReflectShaderModule& inSpvModule);
 
 FT_END_NAMESPACE
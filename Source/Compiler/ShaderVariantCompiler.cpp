@@ -0,0 +1,195 @@
+#include "ShaderVariantCompiler.h"
+#include "ShaderCompileClient.h"
+#include "Utility/ShaderFile.h"
+
+FT_BEGIN_NAMESPACE
+
+namespace ShaderVariants
+{
+	uint32_t GetPermutationCount(const std::vector<ShaderVariantDefine>& inVariantDefines)
+	{
+		uint32_t permutationCount = 1;
+		for (const ShaderVariantDefine& variantDefine : inVariantDefines)
+		{
+			permutationCount *= static_cast<uint32_t>(variantDefine.Values.size());
+		}
+
+		return permutationCount;
+	}
+
+	uint32_t GetSelectedPermutation(const std::vector<ShaderVariantDefine>& inVariantDefines)
+	{
+		uint32_t permutationIndex = 0;
+		uint32_t stride = 1;
+		for (const ShaderVariantDefine& variantDefine : inVariantDefines)
+		{
+			permutationIndex += variantDefine.SelectedValue * stride;
+			stride *= static_cast<uint32_t>(variantDefine.Values.size());
+		}
+
+		return permutationIndex;
+	}
+
+	std::vector<ShaderDefine> GetPermutationDefines(const std::vector<ShaderVariantDefine>& inVariantDefines, const uint32_t inPermutationIndex)
+	{
+		std::vector<ShaderDefine> defines;
+		defines.reserve(inVariantDefines.size());
+
+		uint32_t remainder = inPermutationIndex;
+		for (const ShaderVariantDefine& variantDefine : inVariantDefines)
+		{
+			const uint32_t valueCount = static_cast<uint32_t>(variantDefine.Values.size());
+
+			ShaderDefine define;
+			define.Name = variantDefine.Name;
+			define.Value = variantDefine.Values[remainder % valueCount];
+			defines.push_back(define);
+
+			remainder /= valueCount;
+		}
+
+		return defines;
+	}
+}
+
+ShaderVariantCompiler::ShaderVariantCompiler(const uint32_t inThreadCount)
+	: m_Generation(0)
+	, m_Busy(false)
+	, m_Quit(false)
+	, m_HasResults(false)
+{
+	const uint32_t threadCount = std::max(inThreadCount, 1u);
+	for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+	{
+		m_Threads.push_back(std::thread(&ShaderVariantCompiler::Run, this));
+	}
+}
+
+ShaderVariantCompiler::~ShaderVariantCompiler()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_Condition.notify_all();
+
+	for (std::thread& thread : m_Threads)
+	{
+		thread.join();
+	}
+}
+
+uint64_t ShaderVariantCompiler::Submit(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode,
+	const ShaderCompileOptions& inOptions, const std::vector<ShaderVariantDefine>& inVariantDefines)
+{
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+	batch->Language = inLanguage;
+	batch->Stage = inStage;
+	batch->SourceCode = inSourceCode;
+	batch->Options = inOptions;
+	batch->VariantDefines = inVariantDefines;
+	batch->PermutationCount = ShaderVariants::GetPermutationCount(inVariantDefines);
+	batch->Results.resize(batch->PermutationCount);
+	batch->NextPermutation = 0;
+	batch->FinishedPermutationCount = 0;
+
+	uint64_t generation = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		generation = ++m_Generation;
+		batch->Generation = generation;
+
+		// Threads still compiling permutations of the previous batch keep it alive until they are done.
+		m_Batch = batch;
+		m_HasResults = false;
+		m_Busy = true;
+	}
+
+	m_Condition.notify_all();
+
+	return generation;
+}
+
+void ShaderVariantCompiler::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	++m_Generation;
+	m_Batch.reset();
+	m_HasResults = false;
+	m_Busy = false;
+}
+
+bool ShaderVariantCompiler::TryGetResults(std::vector<ShaderVariantResult>& outResults)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (!m_HasResults)
+	{
+		return false;
+	}
+
+	outResults = std::move(m_Results);
+	m_HasResults = false;
+
+	return true;
+}
+
+void ShaderVariantCompiler::Run()
+{
+	while (true)
+	{
+		std::shared_ptr<Batch> batch;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]()
+				{
+					return m_Quit || (m_Batch && m_Batch->NextPermutation < m_Batch->PermutationCount);
+				});
+
+			if (m_Quit)
+			{
+				return;
+			}
+
+			batch = m_Batch;
+		}
+
+		const uint32_t permutationIndex = batch->NextPermutation++;
+		if (permutationIndex >= batch->PermutationCount)
+		{
+			continue;
+		}
+
+		// Permutations of a superseded batch are only counted, so the batch still completes.
+		if (batch->Generation == m_Generation)
+		{
+			ShaderVariantResult& result = batch->Results[permutationIndex];
+			result.PermutationIndex = permutationIndex;
+			result.Defines = ShaderVariants::GetPermutationDefines(batch->VariantDefines, permutationIndex);
+
+			ShaderCompileOptions options = batch->Options;
+			options.Defines.insert(options.Defines.end(), result.Defines.begin(), result.Defines.end());
+
+			result.CompileResult = ShaderCompileClient::Compile(batch->Language, batch->Stage, batch->SourceCode, options);
+		}
+
+		if (++batch->FinishedPermutationCount == batch->PermutationCount)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (batch->Generation == m_Generation)
+			{
+				m_Results = std::move(batch->Results);
+				m_HasResults = true;
+				m_Busy = false;
+			}
+		}
+	}
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+
+FT_BEGIN_NAMESPACE
+
+struct ShaderVariantDefine;
+
+struct ShaderVariantResult
+{
+	uint32_t PermutationIndex = 0;
+	std::vector<ShaderDefine> Defines;
+	ShaderCompileResult CompileResult;
+};
+
+namespace ShaderVariants
+{
+	// Permutations are numbered in mixed radix, the first define changes the fastest.
+	extern uint32_t GetPermutationCount(const std::vector<ShaderVariantDefine>& inVariantDefines);
+	extern uint32_t GetSelectedPermutation(const std::vector<ShaderVariantDefine>& inVariantDefines);
+	extern std::vector<ShaderDefine> GetPermutationDefines(const std::vector<ShaderVariantDefine>& inVariantDefines, const uint32_t inPermutationIndex);
+}
+
+// Compiles every permutation of a shader on a pool of background threads. Like ShaderCompileWorker, every submit
+// starts a new generation, permutations of a superseded generation are skipped and their results are never handed out.
+class ShaderVariantCompiler
+{
+public:
+	explicit ShaderVariantCompiler(const uint32_t inThreadCount);
+	~ShaderVariantCompiler();
+	FT_DELETE_COPY_AND_MOVE(ShaderVariantCompiler)
+
+public:
+	uint64_t Submit(const ShaderLanguage inLanguage, const ShaderStage inStage, const std::string& inSourceCode,
+		const ShaderCompileOptions& inOptions, const std::vector<ShaderVariantDefine>& inVariantDefines);
+	void Cancel();
+	bool TryGetResults(std::vector<ShaderVariantResult>& outResults);
+
+public:
+	uint64_t GetGeneration() const { return m_Generation; }
+	bool IsBusy() const { return m_Busy; }
+
+private:
+	void Run();
+
+private:
+	struct Batch
+	{
+		uint64_t Generation = 0;
+		ShaderLanguage Language;
+		ShaderStage Stage;
+		std::string SourceCode;
+		ShaderCompileOptions Options;
+		std::vector<ShaderVariantDefine> VariantDefines;
+		std::vector<ShaderVariantResult> Results;
+		uint32_t PermutationCount = 0;
+		std::atomic<uint32_t> NextPermutation;
+		std::atomic<uint32_t> FinishedPermutationCount;
+	};
+
+private:
+	std::vector<std::thread> m_Threads;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::atomic<uint64_t> m_Generation;
+	std::atomic<bool> m_Busy;
+	bool m_Quit;
+	std::shared_ptr<Batch> m_Batch;
+	bool m_HasResults;
+	std::vector<ShaderVariantResult> m_Results;
+};
+
+FT_END_NAMESPACE
@@ -21,10 +21,15 @@ static VkBufferUsageFlags GetVkBufferUsageFlags(const BufferUsageFlags usageFlag
 		bufferUsageFlags |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 	}
 
+	if (IsFlagSet(usageFlags & BufferUsageFlags::Storage))
+	{
+		bufferUsageFlags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+	}
+
 	return bufferUsageFlags;
 }
 
-static void CreateBuffer(const Device* inDevice, const VkDeviceSize inSize, const VkBufferUsageFlags inUsage, const VkMemoryPropertyFlags inProperties, VkBuffer& outBuffer, VkDeviceMemory& outBufferMemory)
+static void CreateBuffer(const Device* inDevice, const VkDeviceSize inSize, const VkBufferUsageFlags inUsage, const VkMemoryPropertyFlags inProperties, VkBuffer& outBuffer, MemoryAllocation& outAllocation)
 {
 	VkBufferCreateInfo bufferCreateInfo{};
 	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -37,14 +42,9 @@ static void CreateBuffer(const Device* inDevice, const VkDeviceSize inSize, cons
 	VkMemoryRequirements memoryRequirements;
 	vkGetBufferMemoryRequirements(inDevice->GetDevice(), outBuffer, &memoryRequirements);
 
-	VkMemoryAllocateInfo allocateInfo{};
-	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocateInfo.allocationSize = memoryRequirements.size;
-	allocateInfo.memoryTypeIndex = inDevice->FindMemoryType(memoryRequirements.memoryTypeBits, inProperties);
+	outAllocation = inDevice->GetMemoryAllocator()->Allocate(memoryRequirements, inProperties, MemoryResourceKind::Linear);
 
-	FT_VK_CALL(vkAllocateMemory(inDevice->GetDevice(), &allocateInfo, nullptr, &outBufferMemory));
-
-	vkBindBufferMemory(inDevice->GetDevice(), outBuffer, outBufferMemory, 0);
+	FT_VK_CALL(vkBindBufferMemory(inDevice->GetDevice(), outBuffer, outAllocation.Memory, outAllocation.Offset));
 }
 
 static void CreateDescriptorInfo(const VkBuffer inBuffer, const size_t inSize, VkDescriptorBufferInfo& outDescriptorInfo)
@@ -55,38 +55,36 @@ static void CreateDescriptorInfo(const VkBuffer inBuffer, const size_t inSize, V
 	outDescriptorInfo.range = inSize;
 }
 
-Buffer::Buffer(const Device* inDevice, const size_t inSize, const BufferUsageFlags inUsageFlags)
+Buffer::Buffer(const Device* inDevice, const size_t inSize, const BufferUsageFlags inUsageFlags, const VkMemoryPropertyFlags inMemoryProperties)
 	: m_Device(inDevice)
 	, m_Size(inSize)
 	, m_HostVisibleData(nullptr)
 {
 	// VK_MEMORY_PROPERTY_HOST_COHERENT_BIT means that if we update this memory on the CPU, in the next command we use it on the GPU it will be guarantied that this memory is updated (so it's coherent).
-	CreateBuffer(inDevice, inSize, GetVkBufferUsageFlags(inUsageFlags), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Buffer, m_Memory);
+	CreateBuffer(inDevice, inSize, GetVkBufferUsageFlags(inUsageFlags), inMemoryProperties, m_Buffer, m_Allocation);
 	CreateDescriptorInfo(m_Buffer, m_Size, m_DescriptorInfo);
 }
 
 Buffer::~Buffer()
 {
 	vkDestroyBuffer(m_Device->GetDevice(), m_Buffer, nullptr);
-	vkFreeMemory(m_Device->GetDevice(), m_Memory, nullptr);
+	m_Device->GetMemoryAllocator()->Free(m_Allocation);
 }
 
 void* Buffer::Map()
 {
 	FT_CHECK(m_HostVisibleData == nullptr, "Buffer is still unmapped.");
 
-	FT_VK_CALL(vkMapMemory(m_Device->GetDevice(), m_Memory, 0, m_Size, 0, &m_HostVisibleData));
+	// Host visible blocks stay mapped for their whole lifetime, so this only hands out the buffer's part of the block.
+	FT_CHECK(m_Allocation.HostVisibleData != nullptr, "Buffer memory isn't host visible.");
+	m_HostVisibleData = m_Allocation.HostVisibleData;
 
 	return m_HostVisibleData;
 }
 
 void Buffer::Unmap()
 {
-	if (m_HostVisibleData)
-	{
-		vkUnmapMemory(m_Device->GetDevice(), m_Memory);
-		m_HostVisibleData = nullptr;
-	}
+	m_HostVisibleData = nullptr;
 }
 
 FT_END_NAMESPACE
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "MemoryAllocator.h"
+
 FT_BEGIN_NAMESPACE
 
 enum class BufferUsageFlags
@@ -8,6 +10,7 @@ enum class BufferUsageFlags
 	TransferSrc = 0x1 << 0,
 	TransferDst = 0x1 << 1,
 	Uniform = 0x1 << 2,
+	Storage = 0x1 << 3,
 };
 FT_FLAG_TYPE_SETUP(BufferUsageFlags)
 	
@@ -16,7 +19,8 @@ class Device;
 class Buffer
 {
 public:
-	Buffer(const Device* inDevice, const size_t inSize, const BufferUsageFlags inUsageFlags);
+	Buffer(const Device* inDevice, const size_t inSize, const BufferUsageFlags inUsageFlags,
+		const VkMemoryPropertyFlags inMemoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 	~Buffer();
 	FT_DELETE_COPY_AND_MOVE(Buffer)
 
@@ -34,7 +38,7 @@ private:
 	const Device* m_Device;
 	VkBuffer m_Buffer;
 	VkDescriptorBufferInfo m_DescriptorInfo;
-	VkDeviceMemory m_Memory;
+	MemoryAllocation m_Allocation;
 	size_t m_Size;
 	void* m_HostVisibleData;
 };
@@ -60,18 +60,22 @@ CombinedImageSampler::~CombinedImageSampler()
 	delete(m_Image);
 }
 
-void CombinedImageSampler::UpdateImage(const ImageFile& inFile)
+Image* CombinedImageSampler::UpdateImage(const ImageFile& inFile)
 {
-	delete(m_Image);
+	Image* replacedImage = m_Image;
 	m_Image = new Image(m_Device, inFile);
 	CreateDescriptorInfo(m_Image->GetImageView(), m_Sampler->GetSampler(), m_DescriptorInfo);
+
+	return replacedImage;
 }
 
-void CombinedImageSampler::UpdateSampler(const SamplerInfo& inSamplerInfo)
+Sampler* CombinedImageSampler::UpdateSampler(const SamplerInfo& inSamplerInfo)
 {
-	delete(m_Sampler);
+	Sampler* replacedSampler = m_Sampler;
 	m_Sampler = new Sampler(m_Device, inSamplerInfo);
 	CreateDescriptorInfo(m_Image->GetImageView(), m_Sampler->GetSampler(), m_DescriptorInfo);
+
+	return replacedSampler;
 }
 
 FT_END_NAMESPACE
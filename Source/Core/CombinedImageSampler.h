@@ -11,6 +11,7 @@ struct SamplerInfo;
 rapidjson::Value SerializeCombinedImageSampler(const std::string& inImagePath, const SamplerInfo& inSamplerInfo, rapidjson::Document::AllocatorType& inAllocator);
 bool DeserializeCombinedImageSampler(const rapidjson::Value& inCombinedImageSamplerJson, std::string& outImagePath, SamplerInfo& outSamplerInfo);
 
+// Replaced image or sampler is handed back instead of destroyed, since frames in flight might still sample it.
 class CombinedImageSampler
 {
 public:
@@ -19,8 +20,8 @@ public:
 	FT_DELETE_COPY_AND_MOVE(CombinedImageSampler)
 
 public:
-	void UpdateImage(const ImageFile& inFile);
-	void UpdateSampler(const SamplerInfo& inSamplerInfo);
+	Image* UpdateImage(const ImageFile& inFile);
+	Sampler* UpdateSampler(const SamplerInfo& inSamplerInfo);
 
 public:
 	const Image* GetImage() const { return m_Image; }
@@ -29,8 +30,8 @@ public:
 
 private:
 	const Device* m_Device;
-	const Image* m_Image;
-	const Sampler* m_Sampler;
+	Image* m_Image;
+	Sampler* m_Sampler;
 	VkDescriptorImageInfo m_DescriptorInfo;
 };
 
@@ -29,9 +29,10 @@ CommandBuffer::~CommandBuffer()
 	vkFreeCommandBuffers(m_Device->GetDevice(), m_Device->GetCommandPool(), static_cast<uint32_t>(m_CommandBuffers.size()), m_CommandBuffers.data());
 }
 
-void CommandBuffer::Begin(const uint32_t inCommandBufferIndex, const Swapchain* inSwapchain)
+void CommandBuffer::Begin(const uint32_t inCommandBufferIndex)
 {
 	m_CurrentCommandBufferIndex = inCommandBufferIndex;
+	m_PipelineLayout = VK_NULL_HANDLE;
 
 	const VkCommandBuffer commandBuffer = m_CommandBuffers[m_CurrentCommandBufferIndex];
 
@@ -40,13 +41,20 @@ void CommandBuffer::Begin(const uint32_t inCommandBufferIndex, const Swapchain*
 	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 
 	FT_VK_CALL(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+}
+
+void CommandBuffer::BeginRenderPass(const VkRenderPass inRenderPass, const VkFramebuffer inFramebuffer, const VkExtent2D inExtent) const
+{
+	FT_CHECK(m_CurrentCommandBufferIndex != FT_ILLEGAL_COMMAND_BUFFER_INDEX, "Command buffer begin command needs to be called first.");
+
+	const VkCommandBuffer commandBuffer = m_CommandBuffers[m_CurrentCommandBufferIndex];
 
 	VkRenderPassBeginInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = inSwapchain->GetRenderPass();
-	renderPassInfo.framebuffer = inSwapchain->GetFramebuffer(m_CurrentCommandBufferIndex);
+	renderPassInfo.renderPass = inRenderPass;
+	renderPassInfo.framebuffer = inFramebuffer;
 	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = inSwapchain->GetExtent();
+	renderPassInfo.renderArea.extent = inExtent;
 
 	VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
 	renderPassInfo.clearValueCount = 1;
@@ -55,12 +63,18 @@ void CommandBuffer::Begin(const uint32_t inCommandBufferIndex, const Swapchain*
 	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 }
 
+void CommandBuffer::EndRenderPass() const
+{
+	FT_CHECK(m_CurrentCommandBufferIndex != FT_ILLEGAL_COMMAND_BUFFER_INDEX, "Command buffer begin command needs to be called first.");
+
+	vkCmdEndRenderPass(m_CommandBuffers[m_CurrentCommandBufferIndex]);
+}
+
 void CommandBuffer::End() 
 {
 	FT_CHECK(m_CurrentCommandBufferIndex != FT_ILLEGAL_COMMAND_BUFFER_INDEX, "Command buffer begin command needs to be called first.");
 
 	const VkCommandBuffer commandBuffer = m_CommandBuffers[m_CurrentCommandBufferIndex];
-	vkCmdEndRenderPass(commandBuffer);
 	FT_VK_CALL(vkEndCommandBuffer(commandBuffer));
 
 	m_CurrentCommandBufferIndex = FT_ILLEGAL_COMMAND_BUFFER_INDEX;
@@ -83,14 +97,51 @@ void CommandBuffer::BindPipeline(const Pipeline* inPipeline)
 	m_PipelineLayout = inPipeline->GetPipelineLayout();
 }
 
-void CommandBuffer::BindDescriptorSet(const DescriptorSet* inDescriptorSet) const
+void CommandBuffer::BindDescriptorSets(const DescriptorSet* inDescriptorSets) const
 {
 	FT_CHECK(m_CurrentCommandBufferIndex != FT_ILLEGAL_COMMAND_BUFFER_INDEX, "Command buffer begin command needs to be called first.");
 	FT_CHECK(m_PipelineLayout != VK_NULL_HANDLE, "Pipeline needs to be bound before descriptor set.");
 
 	const VkCommandBuffer commandBuffer = m_CommandBuffers[m_CurrentCommandBufferIndex];
-	const VkDescriptorSet& descriptorSet = inDescriptorSet->GetDescriptorSet(m_CurrentCommandBufferIndex);
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+	const uint32_t setCount = inDescriptorSets->GetSetCount();
+
+	// Consecutive sets are bound with a single call, unused set indices split the range.
+	std::vector<VkDescriptorSet> descriptorSets;
+	std::vector<uint32_t> dynamicOffsets;
+	uint32_t firstSet = 0;
+	for (uint32_t setIndex = 0; setIndex <= setCount; ++setIndex)
+	{
+		const VkDescriptorSet descriptorSet = setIndex < setCount ? inDescriptorSets->GetDescriptorSet(setIndex, m_CurrentCommandBufferIndex) : VK_NULL_HANDLE;
+		if (descriptorSet != VK_NULL_HANDLE)
+		{
+			if (descriptorSets.empty())
+			{
+				firstSet = setIndex;
+			}
+
+			descriptorSets.push_back(descriptorSet);
+			inDescriptorSets->GetDynamicOffsets(setIndex, m_CurrentCommandBufferIndex, dynamicOffsets);
+			continue;
+		}
+
+		if (!descriptorSets.empty())
+		{
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, firstSet,
+				static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+			descriptorSets.clear();
+			dynamicOffsets.clear();
+		}
+	}
+}
+
+void CommandBuffer::PushConstants(const VkShaderStageFlags inStageFlags, const uint32_t inSize, const void* inData) const
+{
+	FT_CHECK(m_CurrentCommandBufferIndex != FT_ILLEGAL_COMMAND_BUFFER_INDEX, "Command buffer begin command needs to be called first.");
+	FT_CHECK(m_PipelineLayout != VK_NULL_HANDLE, "Pipeline needs to be bound before push constants.");
+
+	// Values are recorded into the command buffer itself, there's no buffer memory or descriptor behind them.
+	const VkCommandBuffer commandBuffer = m_CommandBuffers[m_CurrentCommandBufferIndex];
+	vkCmdPushConstants(commandBuffer, m_PipelineLayout, inStageFlags, 0, inSize, inData);
 }
 
 FT_END_NAMESPACE
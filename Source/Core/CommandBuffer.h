@@ -15,14 +15,18 @@ public:
 	FT_DELETE_COPY_AND_MOVE(CommandBuffer)
 
 public:
-	void Begin(const uint32_t inCommandBufferIndex, const Swapchain* inSwapchain);
+	void Begin(const uint32_t inCommandBufferIndex);
+	void BeginRenderPass(const VkRenderPass inRenderPass, const VkFramebuffer inFramebuffer, const VkExtent2D inExtent) const;
+	void EndRenderPass() const;
 	void End();
 	void Draw() const;
 	void BindPipeline(const Pipeline* inPipeline);
-	void BindDescriptorSet(const DescriptorSet* inDescriptorSet) const;
+	void BindDescriptorSets(const DescriptorSet* inDescriptorSets) const;
+	void PushConstants(const VkShaderStageFlags inStageFlags, const uint32_t inSize, const void* inData) const;
 
 public:
 	VkCommandBuffer GetCommandBuffer(const uint32_t inIndex) const { return m_CommandBuffers[inIndex]; }
+	uint32_t GetCurrentIndex() const { return m_CurrentCommandBufferIndex; }
 
 private:
 	const Device* m_Device;
@@ -6,17 +6,94 @@
 #include "Sampler.h"
 #include "CombinedImageSampler.h"
 #include "UniformBuffer.h"
+#include "StorageBuffer.h"
+#include "TextureArray.h"
 #include "Descriptor.hpp"
 
 FT_BEGIN_NAMESPACE
 
-static void CreateDescriptorSetLayout(const VkDevice inDevice, const std::vector<Descriptor>& inDescriptors, VkDescriptorSetLayout& outDescriptorSetLayout)
+static uint32_t GetSetCount(const std::vector<Descriptor>& inDescriptors)
 {
+	uint32_t setCount = 0;
+	for (const Descriptor& descriptor : inDescriptors)
+	{
+		setCount = std::max(setCount, descriptor.Binding.ReflectDescriptorBinding.set + 1);
+	}
+
+	return setCount;
+}
+
+static bool IsSetUsed(const std::vector<Descriptor>& inDescriptors, const uint32_t inSetIndex)
+{
+	for (const Descriptor& descriptor : inDescriptors)
+	{
+		if (descriptor.Binding.ReflectDescriptorBinding.set == inSetIndex)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint32_t GetUniformBufferDescriptorCount(const std::vector<Descriptor>& inDescriptors)
+{
+	uint32_t descriptorCount = 0;
+	for (const Descriptor& descriptor : inDescriptors)
+	{
+		if (descriptor.Resource.Type == ResourceType::UniformBuffer)
+		{
+			descriptorCount += descriptor.Binding.DescriptorSetBinding.descriptorCount;
+		}
+	}
+
+	return descriptorCount;
+}
+
+static VkDescriptorType GetDescriptorType(const Descriptor& inDescriptor, const bool inDynamicUniformBuffers)
+{
+	if (inDynamicUniformBuffers && inDescriptor.Resource.Type == ResourceType::UniformBuffer)
+	{
+		return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	}
+
+	return inDescriptor.Binding.DescriptorSetBinding.descriptorType;
+}
+
+static uint32_t GetTextureArrayDescriptorCount(const std::vector<Descriptor>& inDescriptors, const std::vector<uint32_t>& inInstanceCounts)
+{
+	uint32_t descriptorCount = 0;
+	for (const Descriptor& descriptor : inDescriptors)
+	{
+		if (descriptor.Resource.Type == ResourceType::TextureArray)
+		{
+			descriptorCount += descriptor.Binding.DescriptorSetBinding.descriptorCount * inInstanceCounts[descriptor.Binding.ReflectDescriptorBinding.set];
+		}
+	}
+
+	return descriptorCount;
+}
+
+static void CreateDescriptorSetLayout(const VkDevice inDevice, const std::vector<Descriptor>& inDescriptors, const uint32_t inSetIndex, const bool inUpdateAfterBind,
+	const bool inDynamicUniformBuffers, VkDescriptorSetLayout& outDescriptorSetLayout)
+{
+	// Pipeline layout can't skip set indices, so unused ones in between get an empty layout.
 	std::vector<VkDescriptorSetLayoutBinding> descriptorSetBindings;
-	descriptorSetBindings.resize(inDescriptors.size());
-	for (uint32_t descriptorIndex = 0; descriptorIndex < inDescriptors.size(); ++descriptorIndex)
+	std::vector<VkDescriptorBindingFlagsEXT> descriptorBindingFlags;
+	bool hasTextureArray = false;
+	for (const Descriptor& descriptor : inDescriptors)
 	{
-		descriptorSetBindings[descriptorIndex] = inDescriptors[descriptorIndex].Binding.DescriptorSetBinding;
+		if (descriptor.Binding.ReflectDescriptorBinding.set == inSetIndex)
+		{
+			descriptorSetBindings.push_back(descriptor.Binding.DescriptorSetBinding);
+			descriptorSetBindings.back().descriptorType = GetDescriptorType(descriptor, inDynamicUniformBuffers);
+
+			// Texture array slots past the loaded images stay unwritten. Update after bind pools lift the descriptor limits of large arrays.
+			const bool isTextureArray = descriptor.Resource.Type == ResourceType::TextureArray;
+			descriptorBindingFlags.push_back(isTextureArray ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+				VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT : 0);
+			hasTextureArray |= isTextureArray;
+		}
 	}
 
 	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
@@ -24,103 +101,401 @@ static void CreateDescriptorSetLayout(const VkDevice inDevice, const std::vector
 	descriptorSetLayoutCreateInfo.bindingCount = static_cast<uint32_t>(descriptorSetBindings.size());
 	descriptorSetLayoutCreateInfo.pBindings = descriptorSetBindings.data();
 
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo{};
+	bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	bindingFlagsCreateInfo.bindingCount = static_cast<uint32_t>(descriptorBindingFlags.size());
+	bindingFlagsCreateInfo.pBindingFlags = descriptorBindingFlags.data();
+
+	if (hasTextureArray && inUpdateAfterBind)
+	{
+		descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+	}
+
 	FT_VK_CALL(vkCreateDescriptorSetLayout(inDevice, &descriptorSetLayoutCreateInfo, nullptr, &outDescriptorSetLayout));
 }
 
-static void CreateDescriptorPool(const VkDevice inDevice, const uint32_t inSwapchainImageCount, VkDescriptorPool& outDescriptorPool)
+static void AddDescriptorPoolSize(const VkDescriptorType inType, const uint32_t inDescriptorCount, std::vector<VkDescriptorPoolSize>& inOutPoolSizes)
+{
+	for (VkDescriptorPoolSize& poolSize : inOutPoolSizes)
+	{
+		if (poolSize.type == inType)
+		{
+			poolSize.descriptorCount += inDescriptorCount;
+			return;
+		}
+	}
+
+	VkDescriptorPoolSize poolSize{};
+	poolSize.type = inType;
+	poolSize.descriptorCount = inDescriptorCount;
+	inOutPoolSizes.push_back(poolSize);
+}
+
+static uint32_t GetDescriptorPoolSize(const std::vector<VkDescriptorPoolSize>& inPoolSizes, const VkDescriptorType inType)
+{
+	for (const VkDescriptorPoolSize& poolSize : inPoolSizes)
+	{
+		if (poolSize.type == inType)
+		{
+			return poolSize.descriptorCount;
+		}
+	}
+
+	return 0;
+}
+
+static std::vector<VkDescriptorPoolSize> GetDescriptorPoolSizes(const std::vector<Descriptor>& inDescriptors, const std::vector<uint32_t>& inInstanceCounts,
+	const bool inDynamicUniformBuffers)
+{
+	std::vector<VkDescriptorPoolSize> poolSizes;
+	for (const Descriptor& descriptor : inDescriptors)
+	{
+		const uint32_t descriptorCount = descriptor.Binding.DescriptorSetBinding.descriptorCount * inInstanceCounts[descriptor.Binding.ReflectDescriptorBinding.set];
+		AddDescriptorPoolSize(GetDescriptorType(descriptor, inDynamicUniformBuffers), descriptorCount, poolSizes);
+	}
+
+	return poolSizes;
+}
+
+static bool FitsDescriptorPool(const std::vector<VkDescriptorPoolSize>& inPoolSizes, const std::vector<VkDescriptorPoolSize>& inRequiredPoolSizes)
 {
-	const static uint32_t MaxDescriptorCount = 128;
+	for (const VkDescriptorPoolSize& requiredPoolSize : inRequiredPoolSizes)
+	{
+		if (GetDescriptorPoolSize(inPoolSizes, requiredPoolSize.type) < requiredPoolSize.descriptorCount)
+		{
+			return false;
+		}
+	}
 
-	std::array<VkDescriptorPoolSize, 4> poolSizes{};
-	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[0].descriptorCount = MaxDescriptorCount * inSwapchainImageCount;
-	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[1].descriptorCount = MaxDescriptorCount * inSwapchainImageCount;
-	poolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-	poolSizes[2].descriptorCount = MaxDescriptorCount * inSwapchainImageCount;
-	poolSizes[3].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-	poolSizes[3].descriptorCount = MaxDescriptorCount * inSwapchainImageCount;
+	return true;
+}
 
+static void GrowDescriptorPoolSizes(const std::vector<VkDescriptorPoolSize>& inRequiredPoolSizes, std::vector<VkDescriptorPoolSize>& inOutPoolSizes)
+{
+	// Capacity is doubled, so swapchains with more images than before don't reallocate the pool on every recreation.
+	for (const VkDescriptorPoolSize& requiredPoolSize : inRequiredPoolSizes)
+	{
+		const uint32_t descriptorCount = GetDescriptorPoolSize(inOutPoolSizes, requiredPoolSize.type);
+		if (descriptorCount < requiredPoolSize.descriptorCount)
+		{
+			AddDescriptorPoolSize(requiredPoolSize.type, std::max(requiredPoolSize.descriptorCount, 2 * descriptorCount) - descriptorCount, inOutPoolSizes);
+		}
+	}
+}
+
+static void CreateDescriptorPool(const VkDevice inDevice, const std::vector<VkDescriptorPoolSize>& inPoolSizes, const uint32_t inMaxSetCount, const bool inUpdateAfterBind,
+	VkDescriptorPool& outDescriptorPool)
+{
 	VkDescriptorPoolCreateInfo poolInfo{};
 	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = inSwapchainImageCount;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(inPoolSizes.size());
+	poolInfo.pPoolSizes = inPoolSizes.data();
+	poolInfo.maxSets = inMaxSetCount;
+	poolInfo.flags = inUpdateAfterBind ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT : 0;
 
 	FT_VK_CALL(vkCreateDescriptorPool(inDevice, &poolInfo, nullptr, &outDescriptorPool));
 }
 
-static void CreateDescriptorSets(const VkDevice inDevice, const VkDescriptorPool inDescriptorPool, const VkDescriptorSetLayout inDescriptorSetLayout, const uint32_t inSwapchainImageCount, const std::vector<Descriptor>& inDescriptors, std::vector<VkDescriptorSet>& outDescriptorSets)
+// Returns false when there's nothing to write, writes are batched by the caller.
+static bool FillDescriptorWrite(const Descriptor& inDescriptor, const VkDescriptorSet inDescriptorSet, const uint32_t inImageIndex, const bool inDynamicUniformBuffers,
+	VkWriteDescriptorSet& outDescriptorWrite)
 {
-	std::vector<VkDescriptorSetLayout> descriptorSetLayouts(inSwapchainImageCount, inDescriptorSetLayout);
+	const Binding& binding = inDescriptor.Binding;
+	const Resource& resource = inDescriptor.Resource;
+
+	VkWriteDescriptorSet& descriptorWrite = outDescriptorWrite;
+	descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = inDescriptorSet;
+	descriptorWrite.dstBinding = binding.DescriptorSetBinding.binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = GetDescriptorType(inDescriptor, inDynamicUniformBuffers);
+	descriptorWrite.descriptorCount = 1;
+
+	if (resource.Type == ResourceType::CombinedImageSampler)
+	{
+		const CombinedImageSampler* combinedImageSampler = resource.Handle.CombinedImageSampler;
+		descriptorWrite.pImageInfo = combinedImageSampler->GetDescriptorInfo();
+	}
+	else if (resource.Type == ResourceType::Image)
+	{
+		const Image* image = resource.Handle.Image;
+		descriptorWrite.pImageInfo = image->GetDescriptorInfo();
+	}
+	else if (resource.Type == ResourceType::Sampler)
+	{
+		const Sampler* sampler = resource.Handle.Sampler;
+		descriptorWrite.pImageInfo = sampler->GetDescriptorInfo();
+	}
+	else if (resource.Type == ResourceType::UniformBuffer)
+	{
+		// Dynamic descriptors point at the first region, the image's region is selected by the offset when binding.
+		descriptorWrite.pBufferInfo = resource.Handle.UniformBuffer->GetDescriptorInfo(inDynamicUniformBuffers ? 0 : inImageIndex);
+	}
+	else if (resource.Type == ResourceType::StorageBuffer)
+	{
+		const Buffer* buffer = resource.Handle.StorageBuffer->GetBuffer();
+		descriptorWrite.pBufferInfo = buffer->GetDescriptorInfo();
+	}
+	else if (resource.Type == ResourceType::TextureArray)
+	{
+		// Array is partially bound, only slots which ever held an image are written, vacated ones with the default image.
+		const TextureArray* textureArray = resource.Handle.TextureArray;
+		if (textureArray->GetDescriptorCount() == 0)
+		{
+			return false;
+		}
+
+		descriptorWrite.descriptorCount = textureArray->GetDescriptorCount();
+		descriptorWrite.pImageInfo = textureArray->GetDescriptorInfos();
+	}
+	else
+	{
+		FT_FAIL("Descriptor type not supported.");
+	}
+
+	return true;
+}
+
+static void CreateDescriptorSets(const VkDevice inDevice, const VkDescriptorPool inDescriptorPool, const VkDescriptorSetLayout inDescriptorSetLayout, const uint32_t inSetIndex,
+	const uint32_t inInstanceCount, const std::vector<Descriptor>& inDescriptors, const bool inDynamicUniformBuffers, std::vector<VkDescriptorSet>& outDescriptorSets)
+{
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts(inInstanceCount, inDescriptorSetLayout);
 
 	VkDescriptorSetAllocateInfo allocateInfo{};
 	allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 	allocateInfo.descriptorPool = inDescriptorPool;
-	allocateInfo.descriptorSetCount = inSwapchainImageCount;
+	allocateInfo.descriptorSetCount = inInstanceCount;
 	allocateInfo.pSetLayouts = descriptorSetLayouts.data();
 
-	outDescriptorSets.resize(inSwapchainImageCount);
+	outDescriptorSets.resize(inInstanceCount);
 	FT_VK_CALL(vkAllocateDescriptorSets(inDevice, &allocateInfo, outDescriptorSets.data()));
 
-	for (size_t i = 0; i < inSwapchainImageCount; ++i)
+	std::vector<VkWriteDescriptorSet> descriptorWrites;
+	for (uint32_t instanceIndex = 0; instanceIndex < inInstanceCount; ++instanceIndex)
 	{
-		std::vector<VkWriteDescriptorSet> descriptorWrites(inDescriptors.size());
-		for (uint32_t j = 0; j < inDescriptors.size(); ++j)
+		for (const Descriptor& descriptor : inDescriptors)
 		{
-			const Binding binding = inDescriptors[j].Binding;
-			const Resource resource = inDescriptors[j].Resource;
-
-			descriptorWrites[j] = {};
-			descriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrites[j].dstSet = outDescriptorSets[i];
-			descriptorWrites[j].dstBinding = binding.DescriptorSetBinding.binding;
-			descriptorWrites[j].dstArrayElement = 0;
-			descriptorWrites[j].descriptorType = binding.DescriptorSetBinding.descriptorType;
-			descriptorWrites[j].descriptorCount = 1;
-
-			if (resource.Type == ResourceType::CombinedImageSampler)
-			{
-				const CombinedImageSampler* combinedImageSampler = resource.Handle.CombinedImageSampler;
-				descriptorWrites[j].pImageInfo = combinedImageSampler->GetDescriptorInfo();
-			}
-			else if (resource.Type == ResourceType::Image)
-			{
-				const Image* image = resource.Handle.Image;
-				descriptorWrites[j].pImageInfo = image->GetDescriptorInfo();
-			}
-			else if (resource.Type == ResourceType::Sampler)
-			{
-				const Sampler* sampler = resource.Handle.Sampler;
-				descriptorWrites[j].pImageInfo = sampler->GetDescriptorInfo();
-			}
-			else if (resource.Type == ResourceType::UniformBuffer)
-			{
-				const Buffer* buffer = resource.Handle.UniformBuffer->GetBuffer(i);
-				descriptorWrites[j].pBufferInfo = buffer->GetDescriptorInfo();
-			}
-			else
+			VkWriteDescriptorSet descriptorWrite;
+			if (descriptor.Binding.ReflectDescriptorBinding.set == inSetIndex && FillDescriptorWrite(descriptor, outDescriptorSets[instanceIndex], instanceIndex, inDynamicUniformBuffers, descriptorWrite))
 			{
-				FT_FAIL("Descriptor type not supported.");
+				descriptorWrites.push_back(descriptorWrite);
 			}
 		}
-
-		vkUpdateDescriptorSets(inDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 	}
+
+	vkUpdateDescriptorSets(inDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 }
 
 DescriptorSet::DescriptorSet(const Device* inDevice, const Swapchain* inSwapchain, const std::vector<Descriptor> inDescriptors)
 	: m_Device(inDevice)
+	, m_DescriptorPool(VK_NULL_HANDLE)
+	, m_MaxSetCount(0)
+	, m_UpdateAfterBindPool(false)
+	, m_DynamicUniformBuffers(GetUniformBufferDescriptorCount(inDescriptors) <= inDevice->GetMaxDescriptorSetUniformBuffersDynamic())
 {
-	CreateDescriptorSetLayout(m_Device->GetDevice(), inDescriptors, m_DescriptorSetLayout);
-	CreateDescriptorPool(m_Device->GetDevice(), inSwapchain->GetImageCount(), m_DescriptorPool);
-	CreateDescriptorSets(m_Device->GetDevice(), m_DescriptorPool, m_DescriptorSetLayout, inSwapchain->GetImageCount(), inDescriptors, m_DescriptorSets);
+	const uint32_t setCount = GetSetCount(inDescriptors);
+	m_DescriptorSetLayouts.resize(setCount);
+
+	// Uniform buffers only differ by their region between images, so they are selected through dynamic offsets.
+	// Past the device limit, the set of every image points at the region of that image instead.
+	if (!m_DynamicUniformBuffers)
+	{
+		FT_LOG("Shader uses more uniform buffers than can be bound with dynamic offsets, they are bound through the region of each image.\n");
+	}
+
+	const bool updateAfterBind = m_Device->IsDescriptorIndexingSupported();
+	for (uint32_t setIndex = 0; setIndex < setCount; ++setIndex)
+	{
+		CreateDescriptorSetLayout(m_Device->GetDevice(), inDescriptors, setIndex, updateAfterBind, m_DynamicUniformBuffers, m_DescriptorSetLayouts[setIndex]);
+	}
+
+	AllocateDescriptorSets(inSwapchain->GetImageCount(), inDescriptors);
 }
 
 DescriptorSet::~DescriptorSet()
 {
 	vkDestroyDescriptorPool(m_Device->GetDevice(), m_DescriptorPool, nullptr);
-	vkDestroyDescriptorSetLayout(m_Device->GetDevice(), m_DescriptorSetLayout, nullptr);
+
+	for (const VkDescriptorSetLayout descriptorSetLayout : m_DescriptorSetLayouts)
+	{
+		vkDestroyDescriptorSetLayout(m_Device->GetDevice(), descriptorSetLayout, nullptr);
+	}
+}
+
+void DescriptorSet::Recreate(const Swapchain* inSwapchain, const std::vector<Descriptor>& inDescriptors)
+{
+	// Layouts only depend on the bindings, so a new swapchain image count only allocates the sets again.
+	FT_CHECK(GetSetCount(inDescriptors) == m_DescriptorSetLayouts.size(), "Descriptor set is recreated with a different binding layout.");
+	AllocateDescriptorSets(inSwapchain->GetImageCount(), inDescriptors);
+}
+
+void DescriptorSet::UpdateDescriptor(const Descriptor& inDescriptor)
+{
+	const uint32_t setIndex = inDescriptor.Binding.ReflectDescriptorBinding.set;
+	FT_CHECK(setIndex < m_DescriptorSets.size(), "Descriptor set index is out of bounds.");
+
+	if (inDescriptor.Resource.Type == ResourceType::UniformBuffer)
+	{
+		SetDynamicUniformBuffer(inDescriptor);
+	}
+
+	// Sets are only written once their frame isn't in flight anymore, a newer write of the same binding replaces the pending one.
+	// Replaced resources are retired by the renderer for as long as frames recorded before the write might still use them.
+	for (std::vector<Descriptor>& pendingDescriptors : m_PendingDescriptors)
+	{
+		bool replaced = false;
+		for (Descriptor& pendingDescriptor : pendingDescriptors)
+		{
+			if (pendingDescriptor.Binding.ReflectDescriptorBinding.set == setIndex &&
+				pendingDescriptor.Binding.DescriptorSetBinding.binding == inDescriptor.Binding.DescriptorSetBinding.binding)
+			{
+				pendingDescriptor = inDescriptor;
+				replaced = true;
+			}
+		}
+
+		if (!replaced)
+		{
+			pendingDescriptors.push_back(inDescriptor);
+		}
+	}
+}
+
+void DescriptorSet::FlushDescriptorWrites(const uint32_t inImageIndex)
+{
+	FT_CHECK(inImageIndex < m_PendingDescriptors.size(), "Swapchain image index is out of bounds.");
+
+	std::vector<Descriptor>& pendingDescriptors = m_PendingDescriptors[inImageIndex];
+	if (pendingDescriptors.empty())
+	{
+		return;
+	}
+
+	std::vector<VkWriteDescriptorSet> descriptorWrites;
+	for (const Descriptor& descriptor : pendingDescriptors)
+	{
+		VkWriteDescriptorSet descriptorWrite;
+		if (FillDescriptorWrite(descriptor, m_DescriptorSets[descriptor.Binding.ReflectDescriptorBinding.set][inImageIndex], inImageIndex, m_DynamicUniformBuffers, descriptorWrite))
+		{
+			descriptorWrites.push_back(descriptorWrite);
+		}
+	}
+
+	vkUpdateDescriptorSets(m_Device->GetDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	pendingDescriptors.clear();
+}
+
+VkDescriptorSet DescriptorSet::GetDescriptorSet(const uint32_t inSetIndex, const uint32_t inImageIndex) const
+{
+	const std::vector<VkDescriptorSet>& descriptorSets = m_DescriptorSets[inSetIndex];
+	if (descriptorSets.empty())
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return descriptorSets[inImageIndex];
+}
+
+void DescriptorSet::GetDynamicOffsets(const uint32_t inSetIndex, const uint32_t inImageIndex, std::vector<uint32_t>& inOutDynamicOffsets) const
+{
+	for (const Descriptor& descriptor : m_DynamicUniformBufferDescriptors[inSetIndex])
+	{
+		inOutDynamicOffsets.push_back(descriptor.Resource.Handle.UniformBuffer->GetDynamicOffset(inImageIndex));
+	}
+}
+
+void DescriptorSet::AllocateDescriptorSets(const uint32_t inImageCount, const std::vector<Descriptor>& inDescriptors)
+{
+	const uint32_t setCount = static_cast<uint32_t>(m_DescriptorSetLayouts.size());
+
+	uint32_t maxSetCount = 0;
+	std::vector<uint32_t> instanceCounts(setCount, 0);
+	for (uint32_t setIndex = 0; setIndex < setCount; ++setIndex)
+	{
+		if (IsSetUsed(inDescriptors, setIndex))
+		{
+			instanceCounts[setIndex] = inImageCount;
+			maxSetCount += instanceCounts[setIndex];
+		}
+	}
+
+	const bool updateAfterBind = m_Device->IsDescriptorIndexingSupported();
+	const uint32_t textureArrayDescriptorCount = GetTextureArrayDescriptorCount(inDescriptors, instanceCounts);
+	if (textureArrayDescriptorCount > 0 && !updateAfterBind)
+	{
+		FT_LOG("Shader uses runtime sized texture arrays, but descriptor indexing isn't supported by the device.\n");
+	}
+
+	// Pool is sized by what the bindings actually use. Sets are only allocated again when the swapchain is recreated,
+	// so the pool is reset and reused while it's big enough, and grows otherwise.
+	const std::vector<VkDescriptorPoolSize> requiredPoolSizes = GetDescriptorPoolSizes(inDescriptors, instanceCounts, m_DynamicUniformBuffers);
+	const bool updateAfterBindPool = updateAfterBind && textureArrayDescriptorCount > 0;
+	if (m_DescriptorPool != VK_NULL_HANDLE && maxSetCount <= m_MaxSetCount && updateAfterBindPool == m_UpdateAfterBindPool &&
+		FitsDescriptorPool(m_DescriptorPoolSizes, requiredPoolSizes))
+	{
+		FT_VK_CALL(vkResetDescriptorPool(m_Device->GetDevice(), m_DescriptorPool, 0));
+	}
+	else if (maxSetCount > 0)
+	{
+		vkDestroyDescriptorPool(m_Device->GetDevice(), m_DescriptorPool, nullptr);
+
+		GrowDescriptorPoolSizes(requiredPoolSizes, m_DescriptorPoolSizes);
+		m_MaxSetCount = std::max(maxSetCount, 2 * m_MaxSetCount);
+		m_UpdateAfterBindPool = updateAfterBindPool;
+
+		CreateDescriptorPool(m_Device->GetDevice(), m_DescriptorPoolSizes, m_MaxSetCount, m_UpdateAfterBindPool, m_DescriptorPool);
+	}
+
+	m_DescriptorSets.assign(setCount, std::vector<VkDescriptorSet>());
+	for (uint32_t setIndex = 0; setIndex < setCount; ++setIndex)
+	{
+		if (instanceCounts[setIndex] > 0)
+		{
+			CreateDescriptorSets(m_Device->GetDevice(), m_DescriptorPool, m_DescriptorSetLayouts[setIndex], setIndex, instanceCounts[setIndex], inDescriptors,
+				m_DynamicUniformBuffers, m_DescriptorSets[setIndex]);
+		}
+	}
+
+	// Freshly allocated sets are written with the current descriptors, nothing is left pending.
+	m_PendingDescriptors.assign(inImageCount, std::vector<Descriptor>());
+
+	m_DynamicUniformBufferDescriptors.assign(setCount, std::vector<Descriptor>());
+	for (const Descriptor& descriptor : inDescriptors)
+	{
+		if (descriptor.Resource.Type == ResourceType::UniformBuffer)
+		{
+			SetDynamicUniformBuffer(descriptor);
+		}
+	}
+}
+
+void DescriptorSet::SetDynamicUniformBuffer(const Descriptor& inDescriptor)
+{
+	if (!m_DynamicUniformBuffers)
+	{
+		return;
+	}
+
+	// Dynamic offsets are consumed in binding order, so descriptors are kept sorted by their binding.
+	std::vector<Descriptor>& descriptors = m_DynamicUniformBufferDescriptors[inDescriptor.Binding.ReflectDescriptorBinding.set];
+	const uint32_t binding = inDescriptor.Binding.DescriptorSetBinding.binding;
+
+	auto descriptorIterator = descriptors.begin();
+	while (descriptorIterator != descriptors.end() && descriptorIterator->Binding.DescriptorSetBinding.binding < binding)
+	{
+		++descriptorIterator;
+	}
+
+	if (descriptorIterator != descriptors.end() && descriptorIterator->Binding.DescriptorSetBinding.binding == binding)
+	{
+		*descriptorIterator = inDescriptor;
+	}
+	else
+	{
+		descriptors.insert(descriptorIterator, inDescriptor);
+	}
 }
 
 FT_END_NAMESPACE
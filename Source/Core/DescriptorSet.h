@@ -6,6 +6,10 @@ class Device;
 class Swapchain;
 struct Descriptor;
 
+// Every set index used by the shader gets its own layout and a set per swapchain image, so changed resources are written into
+// the sets of an image once its frame isn't in flight anymore, instead of waiting for the queue. Uniform buffers are bound with
+// dynamic offsets selecting the ring region of the current image, past the device limit each set points at the region of its image.
+// Layouts and the pool are kept for the whole lifetime, changed resources only rewrite the bindings referencing them.
 class DescriptorSet
 {
 public:
@@ -14,14 +18,37 @@ public:
 	FT_DELETE_COPY_AND_MOVE(DescriptorSet)
 
 public:
-	VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
-	VkDescriptorSet GetDescriptorSet(const uint32_t inDescriptorSetIndex) const { return m_DescriptorSets[inDescriptorSetIndex]; }
+	void Recreate(const Swapchain* inSwapchain, const std::vector<Descriptor>& inDescriptors);
+	void UpdateDescriptor(const Descriptor& inDescriptor);
+	void FlushDescriptorWrites(const uint32_t inImageIndex);
+
+public:
+	uint32_t GetSetCount() const { return static_cast<uint32_t>(m_DescriptorSetLayouts.size()); }
+	const std::vector<VkDescriptorSetLayout>& GetDescriptorSetLayouts() const { return m_DescriptorSetLayouts; }
+	VkDescriptorSet GetDescriptorSet(const uint32_t inSetIndex, const uint32_t inImageIndex) const;
+	void GetDynamicOffsets(const uint32_t inSetIndex, const uint32_t inImageIndex, std::vector<uint32_t>& inOutDynamicOffsets) const;
+
+private:
+	void AllocateDescriptorSets(const uint32_t inImageCount, const std::vector<Descriptor>& inDescriptors);
+	void SetDynamicUniformBuffer(const Descriptor& inDescriptor);
 
 private:
 	const Device* m_Device;
-	VkDescriptorSetLayout m_DescriptorSetLayout;
+	std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
 	VkDescriptorPool m_DescriptorPool;
-	std::vector<VkDescriptorSet> m_DescriptorSets;
+	std::vector<VkDescriptorPoolSize> m_DescriptorPoolSizes;
+	uint32_t m_MaxSetCount;
+	bool m_UpdateAfterBindPool;
+	bool m_DynamicUniformBuffers;
+
+	// Indexed by set, then by swapchain image. Sets without bindings aren't allocated at all.
+	std::vector<std::vector<VkDescriptorSet>> m_DescriptorSets;
+
+	// Indexed by swapchain image, descriptors which are written once that frame isn't in flight anymore.
+	std::vector<std::vector<Descriptor>> m_PendingDescriptors;
+
+	// Indexed by set, uniform buffers bound with dynamic offsets.
+	std::vector<std::vector<Descriptor>> m_DynamicUniformBufferDescriptors;
 };
 
 FT_END_NAMESPACE
@@ -1,5 +1,8 @@
 #include "Device.h"
 #include "Window.h"
+#include "MemoryAllocator.h"
+#include "Utility/Hash.hpp"
+#include "Utility/BinaryStream.hpp"
 
 FT_BEGIN_NAMESPACE
 
@@ -14,6 +17,23 @@ static const std::vector<const char*> deviceExtensions =
 	VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
+static const std::string PipelineCacheFilePath = GetAbsolutePath("PipelineCache.bin");
+static const uint32_t PipelineCacheFileMagic = 0x43505446; // "FTPC"
+static const uint32_t PipelineCacheFileVersion = 1;
+
+// Drivers validate their own cache header as well, but silently drop mismatching data, so stale files are caught and reported first.
+struct PipelineCacheFileHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t VendorId;
+	uint32_t DeviceId;
+	uint32_t DriverVersion;
+	uint8_t PipelineCacheUuid[VK_UUID_SIZE];
+	uint64_t DataSize;
+	uint64_t DataHash;
+};
+
 static const std::vector<const char*> validationLayers =
 {
 	"VK_LAYER_KHRONOS_validation"
@@ -49,6 +69,25 @@ static bool CheckValidationLayerSupport()
 	return true;
 }
 
+static bool IsInstanceExtensionAvailable(const char* inExtensionName)
+{
+	uint32_t extensionCount = 0;
+	vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+
+	for (const VkExtensionProperties& availableExtension : availableExtensions)
+	{
+		if (strcmp(availableExtension.extensionName, inExtensionName) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static std::vector<const char*> GetRequiredExtensions()
 {
 	uint32_t glfwExtensionCount = 0;
@@ -57,6 +96,12 @@ static std::vector<const char*> GetRequiredExtensions()
 
 	std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
 
+	// Optional, only needed for querying extended device features on a Vulkan 1.0 instance.
+	if (IsInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+	}
+
 	if (enableValidationLayers)
 	{
 		extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -251,7 +296,110 @@ static void PickPhysicalDevice(const VkInstance inInstance, const VkSurfaceKHR i
 	FT_FAIL("Failed to find a suitable GPU.");
 }
 
-static void CreateLogicalDevice(const VkPhysicalDevice inPhysicalDevice, const VkSurfaceKHR inSurface, VkDevice& outDevice, VkQueue& outGraphicsQueue, uint32_t& outGraphicsQueueFamilyIndex)
+// Half precision arithmetic is optional, it's only used by relaxed precision shader variants when available.
+static bool CheckShaderFloat16Support(const VkInstance inInstance, const VkPhysicalDevice inPhysicalDevice)
+{
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(inPhysicalDevice, nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(inPhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+	if (!IsDeviceExtensionAvailable(availableExtensions, VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	const auto vkGetPhysicalDeviceFeatures2KHR = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(inInstance, "vkGetPhysicalDeviceFeatures2KHR");
+	if (vkGetPhysicalDeviceFeatures2KHR == nullptr)
+	{
+		return false;
+	}
+
+	VkPhysicalDeviceShaderFloat16Int8FeaturesKHR float16Int8Features{};
+	float16Int8Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR;
+
+	VkPhysicalDeviceFeatures2KHR features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+	features.pNext = &float16Int8Features;
+
+	vkGetPhysicalDeviceFeatures2KHR(inPhysicalDevice, &features);
+
+	return float16Int8Features.shaderFloat16 == VK_TRUE;
+}
+
+// Runtime sized texture arrays are optional as well, shaders which use them just fail to create their pipeline without it.
+static bool CheckDescriptorIndexingSupport(const VkInstance inInstance, const VkPhysicalDevice inPhysicalDevice)
+{
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(inPhysicalDevice, nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(inPhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+	if (!IsDeviceExtensionAvailable(availableExtensions, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) ||
+		!IsDeviceExtensionAvailable(availableExtensions, VK_KHR_MAINTENANCE3_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	const auto vkGetPhysicalDeviceFeatures2KHR = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(inInstance, "vkGetPhysicalDeviceFeatures2KHR");
+	if (vkGetPhysicalDeviceFeatures2KHR == nullptr)
+	{
+		return false;
+	}
+
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};
+	descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+	VkPhysicalDeviceFeatures2KHR features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+	features.pNext = &descriptorIndexingFeatures;
+
+	vkGetPhysicalDeviceFeatures2KHR(inPhysicalDevice, &features);
+
+	return descriptorIndexingFeatures.runtimeDescriptorArray == VK_TRUE &&
+		descriptorIndexingFeatures.descriptorBindingPartiallyBound == VK_TRUE &&
+		descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+		descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+		descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+}
+
+// Pipeline libraries are optional, fragment shader pipelines are created monolithically without them.
+static bool CheckGraphicsPipelineLibrarySupport(const VkInstance inInstance, const VkPhysicalDevice inPhysicalDevice)
+{
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(inPhysicalDevice, nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(inPhysicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+	if (!IsDeviceExtensionAvailable(availableExtensions, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) ||
+		!IsDeviceExtensionAvailable(availableExtensions, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	const auto vkGetPhysicalDeviceFeatures2KHR = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(inInstance, "vkGetPhysicalDeviceFeatures2KHR");
+	if (vkGetPhysicalDeviceFeatures2KHR == nullptr)
+	{
+		return false;
+	}
+
+	VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+	graphicsPipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+	VkPhysicalDeviceFeatures2KHR features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+	features.pNext = &graphicsPipelineLibraryFeatures;
+
+	vkGetPhysicalDeviceFeatures2KHR(inPhysicalDevice, &features);
+
+	return graphicsPipelineLibraryFeatures.graphicsPipelineLibrary == VK_TRUE;
+}
+
+static void CreateLogicalDevice(const VkPhysicalDevice inPhysicalDevice, const VkSurfaceKHR inSurface, const bool inEnableShaderFloat16, const bool inEnableDescriptorIndexing,
+	const bool inEnableGraphicsPipelineLibrary, VkDevice& outDevice, VkQueue& outGraphicsQueue, uint32_t& outGraphicsQueueFamilyIndex)
 {
 	outGraphicsQueueFamilyIndex = FindGraphicsQueueFamily(inPhysicalDevice);
 
@@ -270,13 +418,55 @@ static void CreateLogicalDevice(const VkPhysicalDevice inPhysicalDevice, const V
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+	std::vector<const char*> enabledExtensions = deviceExtensions;
+
+	VkPhysicalDeviceShaderFloat16Int8FeaturesKHR float16Int8Features{};
+	float16Int8Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR;
+
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};
+	descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+	VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+	graphicsPipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
 	VkDeviceCreateInfo deviceCreateInfo{};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	deviceCreateInfo.queueCreateInfoCount = 1;
 	deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
 	deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-	deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
+
+	if (inEnableShaderFloat16)
+	{
+		enabledExtensions.push_back(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
+		float16Int8Features.shaderFloat16 = VK_TRUE;
+		float16Int8Features.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+		deviceCreateInfo.pNext = &float16Int8Features;
+	}
+
+	if (inEnableDescriptorIndexing)
+	{
+		enabledExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+		enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+		descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+		descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		descriptorIndexingFeatures.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+		deviceCreateInfo.pNext = &descriptorIndexingFeatures;
+	}
+
+	if (inEnableGraphicsPipelineLibrary)
+	{
+		enabledExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+		enabledExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+		graphicsPipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+		graphicsPipelineLibraryFeatures.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+		deviceCreateInfo.pNext = &graphicsPipelineLibraryFeatures;
+	}
+
+	deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+	deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
 	if (enableValidationLayers)
 	{
@@ -303,20 +493,123 @@ static void CreateCommandPool(const VkDevice inDevice, const uint32_t inQueueFam
 	FT_VK_CALL(vkCreateCommandPool(inDevice, &commandPoolCreateInfo, nullptr, &outCommandPool));
 }
 
+static bool IsPipelineCacheFileValid(const PipelineCacheFileHeader& inHeader, const VkPhysicalDeviceProperties& inPhysicalDeviceProperties)
+{
+	return inHeader.Magic == PipelineCacheFileMagic &&
+		inHeader.Version == PipelineCacheFileVersion &&
+		inHeader.VendorId == inPhysicalDeviceProperties.vendorID &&
+		inHeader.DeviceId == inPhysicalDeviceProperties.deviceID &&
+		inHeader.DriverVersion == inPhysicalDeviceProperties.driverVersion &&
+		memcmp(inHeader.PipelineCacheUuid, inPhysicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+static void CreatePipelineCache(const VkDevice inDevice, const VkPhysicalDeviceProperties& inPhysicalDeviceProperties, VkPipelineCache& outPipelineCache)
+{
+	std::string cacheData;
+
+	std::string fileBuffer;
+	if (ReadBinaryFile(PipelineCacheFilePath, fileBuffer))
+	{
+		size_t offset = 0;
+		PipelineCacheFileHeader header{};
+		if (ReadBinaryValue(fileBuffer, offset, header) && IsPipelineCacheFileValid(header, inPhysicalDeviceProperties) &&
+			header.DataSize == fileBuffer.size() - offset && HashBytes(fileBuffer.data() + offset, fileBuffer.size() - offset) == header.DataHash)
+		{
+			cacheData = fileBuffer.substr(offset);
+			FT_LOG("Pipeline cache loaded, %.2f KB.\n", cacheData.size() / 1024.0);
+		}
+		else
+		{
+			FT_LOG("Pipeline cache %s doesn't match the device or driver, it will be rebuilt.\n", PipelineCacheFilePath.c_str());
+		}
+	}
+
+	VkPipelineCacheCreateInfo pipelineCacheCreateInfo{};
+	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	pipelineCacheCreateInfo.initialDataSize = cacheData.size();
+	pipelineCacheCreateInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+	FT_VK_CALL(vkCreatePipelineCache(inDevice, &pipelineCacheCreateInfo, nullptr, &outPipelineCache));
+}
+
+static void SavePipelineCache(const VkDevice inDevice, const VkPhysicalDeviceProperties& inPhysicalDeviceProperties, const VkPipelineCache inPipelineCache)
+{
+	size_t dataSize = 0;
+	FT_VK_CALL(vkGetPipelineCacheData(inDevice, inPipelineCache, &dataSize, nullptr));
+
+	std::string cacheData(dataSize, '\0');
+	FT_VK_CALL(vkGetPipelineCacheData(inDevice, inPipelineCache, &dataSize, dataSize > 0 ? &cacheData[0] : nullptr));
+	cacheData.resize(dataSize);
+
+	PipelineCacheFileHeader header{};
+	header.Magic = PipelineCacheFileMagic;
+	header.Version = PipelineCacheFileVersion;
+	header.VendorId = inPhysicalDeviceProperties.vendorID;
+	header.DeviceId = inPhysicalDeviceProperties.deviceID;
+	header.DriverVersion = inPhysicalDeviceProperties.driverVersion;
+	memcpy(header.PipelineCacheUuid, inPhysicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.DataSize = cacheData.size();
+	header.DataHash = HashBytes(cacheData.data(), cacheData.size());
+
+	std::string fileBuffer;
+	fileBuffer.reserve(sizeof(PipelineCacheFileHeader) + cacheData.size());
+	WriteBinaryValue(fileBuffer, header);
+	fileBuffer.append(cacheData);
+
+	// Written next to the previous cache and renamed over it, so a crash while writing can't leave a truncated file behind.
+	const std::string temporaryPath = PipelineCacheFilePath + ".tmp";
+	if (!WriteBinaryFile(temporaryPath, fileBuffer) || !RenameFile(temporaryPath, PipelineCacheFilePath))
+	{
+		FT_LOG("Failed saving pipeline cache %s.\n", PipelineCacheFilePath.c_str());
+		RemoveFile(temporaryPath);
+		return;
+	}
+
+	FT_LOG("Pipeline cache saved, %.2f KB.\n", cacheData.size() / 1024.0);
+}
+
 Device::Device(const Window* inWindow)
 {
 	CreateInstance(m_Instance);
 	SetupDebugMessenger(m_Instance, m_DebugMessenger);
 	CreateSurface(m_Instance, inWindow->GetWindow(), m_Surface);
 	PickPhysicalDevice(m_Instance, m_Surface, m_PhysicalDevice);
-	CreateLogicalDevice(m_PhysicalDevice, m_Surface, m_Device, m_GraphicsQueue, m_GraphicsQueueFamilyIndex);
+	m_ShaderFloat16Supported = CheckShaderFloat16Support(m_Instance, m_PhysicalDevice);
+	m_DescriptorIndexingSupported = CheckDescriptorIndexingSupport(m_Instance, m_PhysicalDevice);
+	m_GraphicsPipelineLibrarySupported = CheckGraphicsPipelineLibrarySupport(m_Instance, m_PhysicalDevice);
+	CreateLogicalDevice(m_PhysicalDevice, m_Surface, m_ShaderFloat16Supported, m_DescriptorIndexingSupported, m_GraphicsPipelineLibrarySupported, m_Device, m_GraphicsQueue, m_GraphicsQueueFamilyIndex);
 	CreateCommandPool(m_Device, m_GraphicsQueueFamilyIndex, m_CommandPool);
+	m_MemoryAllocator = new MemoryAllocator(m_PhysicalDevice, m_Device);
+
+	VkPhysicalDeviceProperties physicalDeviceProperties;
+	vkGetPhysicalDeviceProperties(m_PhysicalDevice, &physicalDeviceProperties);
+	m_TimestampPeriod = physicalDeviceProperties.limits.timestampPeriod;
+	m_MaxPushConstantsSize = physicalDeviceProperties.limits.maxPushConstantsSize;
+	m_MaxStorageBufferRange = physicalDeviceProperties.limits.maxStorageBufferRange;
+	m_MinUniformBufferOffsetAlignment = physicalDeviceProperties.limits.minUniformBufferOffsetAlignment;
+	m_MaxDescriptorSetUniformBuffersDynamic = physicalDeviceProperties.limits.maxDescriptorSetUniformBuffersDynamic;
+
+	CreatePipelineCache(m_Device, physicalDeviceProperties, m_PipelineCache);
+
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, nullptr);
+
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevice, &queueFamilyCount, queueFamilies.data());
+	m_TimestampValidBits = queueFamilies[m_GraphicsQueueFamilyIndex].timestampValidBits;
 }
 
 Device::~Device()
 {
+	VkPhysicalDeviceProperties physicalDeviceProperties;
+	vkGetPhysicalDeviceProperties(m_PhysicalDevice, &physicalDeviceProperties);
+
+	SavePipelineCache(m_Device, physicalDeviceProperties, m_PipelineCache);
+	vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
+
 	vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
 
+	delete(m_MemoryAllocator);
 	vkDestroyDevice(m_Device, nullptr);
 
 	if (enableValidationLayers)
@@ -331,22 +624,6 @@ Device::~Device()
 	vkDestroyInstance(m_Instance, nullptr);
 }
 
-uint32_t Device::FindMemoryType(const uint32_t inTypeFilter, const VkMemoryPropertyFlags inProperties) const
-{
-	VkPhysicalDeviceMemoryProperties memProperties;
-	vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memProperties);
-
-	for (uint32_t memoryTypeIndex = 0; memoryTypeIndex < memProperties.memoryTypeCount; ++memoryTypeIndex)
-	{
-		if ((inTypeFilter & (1 << memoryTypeIndex)) && (memProperties.memoryTypes[memoryTypeIndex].propertyFlags & inProperties) == inProperties)
-		{
-			return memoryTypeIndex;
-		}
-	}
-
-	FT_FAIL("Failed to find suitable memory type.");
-}
-
 VkCommandBuffer Device::BeginSingleTimeCommands() const
 {
 	VkCommandBufferAllocateInfo allocateInfo{};
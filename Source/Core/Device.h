@@ -3,6 +3,7 @@
 FT_BEGIN_NAMESPACE
 
 class Window;
+class MemoryAllocator;
 
 class Device
 {
@@ -12,7 +13,6 @@ public:
 	FT_DELETE_COPY_AND_MOVE(Device)
 
 public:
-	uint32_t FindMemoryType(const uint32_t inTypeFilter, const VkMemoryPropertyFlags inProperties) const;
 	VkCommandBuffer BeginSingleTimeCommands() const;
 	void EndSingleTimeCommands(VkCommandBuffer commandBuffer) const;
 
@@ -24,6 +24,18 @@ public:
 	VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; }
 	uint32_t GetGraphicsQueueFamilyIndex() const { return m_GraphicsQueueFamilyIndex; }
 	VkCommandPool GetCommandPool() const { return m_CommandPool; }
+	VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+	MemoryAllocator* GetMemoryAllocator() const { return m_MemoryAllocator; }
+	bool IsShaderFloat16Supported() const { return m_ShaderFloat16Supported; }
+	bool IsDescriptorIndexingSupported() const { return m_DescriptorIndexingSupported; }
+	bool IsGraphicsPipelineLibrarySupported() const { return m_GraphicsPipelineLibrarySupported; }
+	bool AreTimestampsSupported() const { return m_TimestampValidBits > 0; }
+	uint32_t GetTimestampValidBits() const { return m_TimestampValidBits; }
+	float GetTimestampPeriod() const { return m_TimestampPeriod; }
+	uint32_t GetMaxPushConstantsSize() const { return m_MaxPushConstantsSize; }
+	uint32_t GetMaxStorageBufferRange() const { return m_MaxStorageBufferRange; }
+	VkDeviceSize GetMinUniformBufferOffsetAlignment() const { return m_MinUniformBufferOffsetAlignment; }
+	uint32_t GetMaxDescriptorSetUniformBuffersDynamic() const { return m_MaxDescriptorSetUniformBuffersDynamic; }
 
 private:
 	VkInstance m_Instance;
@@ -34,6 +46,17 @@ private:
 	VkQueue m_GraphicsQueue;
 	uint32_t m_GraphicsQueueFamilyIndex;
 	VkCommandPool m_CommandPool;
+	VkPipelineCache m_PipelineCache;
+	MemoryAllocator* m_MemoryAllocator;
+	bool m_ShaderFloat16Supported;
+	bool m_DescriptorIndexingSupported;
+	bool m_GraphicsPipelineLibrarySupported;
+	uint32_t m_TimestampValidBits;
+	float m_TimestampPeriod;
+	uint32_t m_MaxPushConstantsSize;
+	uint32_t m_MaxStorageBufferRange;
+	VkDeviceSize m_MinUniformBufferOffsetAlignment;
+	uint32_t m_MaxDescriptorSetUniformBuffersDynamic;
 };
 
 FT_END_NAMESPACE
@@ -93,7 +93,7 @@ static void CopyBufferToImage(const Device* inDevice, const VkBuffer inBuffer, c
 	inDevice->EndSingleTimeCommands(commandBuffer);
 }
 
-static void CreateImage(const Device* inDevice, const ImageFile& inImageFile, VkImage& outImage, VkDeviceMemory& outMemory, uint32_t& outWidth, uint32_t& outHeight)
+static void CreateImage(const Device* inDevice, const ImageFile& inImageFile, VkImage& outImage, MemoryAllocation& outAllocation, uint32_t& outWidth, uint32_t& outHeight)
 {
 	outWidth = inImageFile.GetWidth();
 	outHeight = inImageFile.GetHeight();
@@ -126,14 +126,9 @@ static void CreateImage(const Device* inDevice, const ImageFile& inImageFile, Vk
 	VkMemoryRequirements memRequirements;
 	vkGetImageMemoryRequirements(inDevice->GetDevice(), outImage, &memRequirements);
 
-	VkMemoryAllocateInfo allocateInfo{};
-	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocateInfo.allocationSize = memRequirements.size;
-	allocateInfo.memoryTypeIndex = inDevice->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	outAllocation = inDevice->GetMemoryAllocator()->Allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryResourceKind::Optimal);
 
-	FT_VK_CALL(vkAllocateMemory(inDevice->GetDevice(), &allocateInfo, nullptr, &outMemory));
-
-	vkBindImageMemory(inDevice->GetDevice(), outImage, outMemory, 0);
+	FT_VK_CALL(vkBindImageMemory(inDevice->GetDevice(), outImage, outAllocation.Memory, outAllocation.Offset));
 
 	TransitionImageLayout(inDevice, outImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 	CopyBufferToImage(inDevice, stagingBuffer.GetBuffer(), outImage, static_cast<uint32_t>(outWidth), static_cast<uint32_t>(outHeight));
@@ -167,7 +162,7 @@ Image::Image(const Device* inDevice, const ImageFile& inFile)
 	: m_Device(inDevice)
 	, m_Path(inFile.GetPath())
 {
-	CreateImage(m_Device, inFile, m_Image, m_Memory, m_Width, m_Height);
+	CreateImage(m_Device, inFile, m_Image, m_Allocation, m_Width, m_Height);
 	CreateImageView(inDevice->GetDevice(), m_Image, VK_FORMAT_R8G8B8A8_UNORM, m_ImageView);
 	CreateDescriptorInfo(m_ImageView, m_DescriptorInfo);
 }
@@ -176,7 +171,7 @@ Image::~Image()
 {
 	vkDestroyImageView(m_Device->GetDevice(), m_ImageView, nullptr);
 	vkDestroyImage(m_Device->GetDevice(), m_Image, nullptr);
-	vkFreeMemory(m_Device->GetDevice(), m_Memory, nullptr);
+	m_Device->GetMemoryAllocator()->Free(m_Allocation);
 }
 
 FT_END_NAMESPACE
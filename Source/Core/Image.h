@@ -1,5 +1,7 @@
 #pragma once
 
+#include "MemoryAllocator.h"
+
 FT_BEGIN_NAMESPACE
 
 // TODO: Implement support for 3D, Cube and Array images.
@@ -28,7 +30,7 @@ public:
 private:
 	const Device* m_Device;
 	VkImage m_Image;
-	VkDeviceMemory m_Memory;
+	MemoryAllocation m_Allocation;
 	VkImageView m_ImageView;
 	VkDescriptorImageInfo m_DescriptorInfo;
 	uint32_t m_Width;
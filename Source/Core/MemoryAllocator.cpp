@@ -0,0 +1,286 @@
+#include "MemoryAllocator.h"
+
+FT_BEGIN_NAMESPACE
+
+// Large enough for dozens of textures, while not taking a noticeable part of small host visible heaps.
+static const VkDeviceSize DefaultBlockSize = 64ull * 1024ull * 1024ull;
+
+static VkDeviceSize AlignOffset(const VkDeviceSize inOffset, const VkDeviceSize inAlignment)
+{
+	return (inOffset + inAlignment - 1) / inAlignment * inAlignment;
+}
+
+static uint32_t GetPoolIndex(const uint32_t inMemoryTypeIndex, const MemoryResourceKind inResourceKind)
+{
+	return inMemoryTypeIndex * static_cast<uint32_t>(MemoryResourceKind::Count) + static_cast<uint32_t>(inResourceKind);
+}
+
+// First fit, returns false when no free range of the block can hold the aligned allocation.
+static bool AllocateFromFreeRanges(std::map<VkDeviceSize, VkDeviceSize>& inOutFreeRanges, const VkDeviceSize inSize, const VkDeviceSize inAlignment, VkDeviceSize& outOffset)
+{
+	for (auto freeRangeIterator = inOutFreeRanges.begin(); freeRangeIterator != inOutFreeRanges.end(); ++freeRangeIterator)
+	{
+		const VkDeviceSize rangeOffset = freeRangeIterator->first;
+		const VkDeviceSize rangeEnd = rangeOffset + freeRangeIterator->second;
+		const VkDeviceSize alignedOffset = AlignOffset(rangeOffset, inAlignment);
+		if (alignedOffset + inSize > rangeEnd)
+		{
+			continue;
+		}
+
+		// Padding in front of the aligned offset stays free, it's merged back once the allocation is freed.
+		inOutFreeRanges.erase(freeRangeIterator);
+		if (alignedOffset > rangeOffset)
+		{
+			inOutFreeRanges[rangeOffset] = alignedOffset - rangeOffset;
+		}
+
+		if (rangeEnd > alignedOffset + inSize)
+		{
+			inOutFreeRanges[alignedOffset + inSize] = rangeEnd - alignedOffset - inSize;
+		}
+
+		outOffset = alignedOffset;
+		return true;
+	}
+
+	return false;
+}
+
+static void FreeToFreeRanges(std::map<VkDeviceSize, VkDeviceSize>& inOutFreeRanges, VkDeviceSize inOffset, VkDeviceSize inSize)
+{
+	auto nextIterator = inOutFreeRanges.lower_bound(inOffset);
+	if (nextIterator != inOutFreeRanges.end() && nextIterator->first == inOffset + inSize)
+	{
+		inSize += nextIterator->second;
+		nextIterator = inOutFreeRanges.erase(nextIterator);
+	}
+
+	if (nextIterator != inOutFreeRanges.begin())
+	{
+		const auto previousIterator = std::prev(nextIterator);
+		if (previousIterator->first + previousIterator->second == inOffset)
+		{
+			inOffset = previousIterator->first;
+			inSize += previousIterator->second;
+			inOutFreeRanges.erase(previousIterator);
+		}
+	}
+
+	inOutFreeRanges[inOffset] = inSize;
+}
+
+MemoryAllocator::MemoryAllocator(const VkPhysicalDevice inPhysicalDevice, const VkDevice inDevice)
+	: m_Device(inDevice)
+	, m_DeviceAllocationCount(0)
+{
+	// Memory properties never change for a device, so they are queried once instead of on every allocation.
+	vkGetPhysicalDeviceMemoryProperties(inPhysicalDevice, &m_MemoryProperties);
+
+	VkPhysicalDeviceProperties physicalDeviceProperties;
+	vkGetPhysicalDeviceProperties(inPhysicalDevice, &physicalDeviceProperties);
+	m_MaxAllocationCount = physicalDeviceProperties.limits.maxMemoryAllocationCount;
+
+	m_Pools.resize(m_MemoryProperties.memoryTypeCount * static_cast<uint32_t>(MemoryResourceKind::Count));
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+	for (Pool& pool : m_Pools)
+	{
+		for (Block* block : pool.Blocks)
+		{
+			FT_CHECK(block->AllocationCount == 0, "Device memory has to be freed before the allocator is destroyed.");
+			DestroyBlock(block);
+		}
+	}
+}
+
+MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements& inRequirements, const VkMemoryPropertyFlags inProperties, const MemoryResourceKind inResourceKind)
+{
+	const uint32_t memoryTypeIndex = FindMemoryType(inRequirements.memoryTypeBits, inProperties);
+	const uint32_t poolIndex = GetPoolIndex(memoryTypeIndex, inResourceKind);
+	const VkDeviceSize alignment = std::max<VkDeviceSize>(inRequirements.alignment, 1);
+	Pool& pool = m_Pools[poolIndex];
+
+	MemoryAllocation allocation;
+	allocation.Size = inRequirements.size;
+	allocation.PoolIndex = poolIndex;
+
+	Block* allocationBlock = nullptr;
+	for (Block* block : pool.Blocks)
+	{
+		if (!block->Dedicated && AllocateFromFreeRanges(block->FreeRanges, inRequirements.size, alignment, allocation.Offset))
+		{
+			allocationBlock = block;
+			break;
+		}
+	}
+
+	if (allocationBlock == nullptr)
+	{
+		// Resources taking a large part of a block get memory of their own, so they don't leave most of a block unusable.
+		const VkDeviceSize blockSize = GetBlockSize(memoryTypeIndex);
+		const bool dedicated = inRequirements.size > blockSize / 2;
+
+		allocationBlock = CreateBlock(memoryTypeIndex, dedicated ? inRequirements.size : blockSize, dedicated);
+		pool.Blocks.push_back(allocationBlock);
+
+		const bool allocated = AllocateFromFreeRanges(allocationBlock->FreeRanges, inRequirements.size, alignment, allocation.Offset);
+		FT_CHECK(allocated, "Failed allocating from a new device memory block.");
+	}
+
+	allocationBlock->UsedSize += inRequirements.size;
+	++allocationBlock->AllocationCount;
+
+	allocation.Memory = allocationBlock->Memory;
+	allocation.HostVisibleData = allocationBlock->HostVisibleData ? allocationBlock->HostVisibleData + allocation.Offset : nullptr;
+
+	return allocation;
+}
+
+void MemoryAllocator::Free(const MemoryAllocation& inAllocation)
+{
+	if (inAllocation.Memory == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	FT_CHECK(inAllocation.PoolIndex < m_Pools.size(), "Device memory pool index is out of bounds.");
+	std::vector<Block*>& blocks = m_Pools[inAllocation.PoolIndex].Blocks;
+
+	auto blockIterator = blocks.begin();
+	while (blockIterator != blocks.end() && (*blockIterator)->Memory != inAllocation.Memory)
+	{
+		++blockIterator;
+	}
+
+	FT_CHECK(blockIterator != blocks.end(), "Freed device memory doesn't belong to the pool.");
+
+	Block* block = *blockIterator;
+	FreeToFreeRanges(block->FreeRanges, inAllocation.Offset, inAllocation.Size);
+	block->UsedSize -= inAllocation.Size;
+	--block->AllocationCount;
+
+	if (block->AllocationCount > 0)
+	{
+		return;
+	}
+
+	// A single empty block is kept per pool, so swapping a resource reuses it instead of allocating device memory again.
+	bool hasOtherEmptyBlock = false;
+	for (const Block* otherBlock : blocks)
+	{
+		hasOtherEmptyBlock |= otherBlock != block && otherBlock->AllocationCount == 0 && !otherBlock->Dedicated;
+	}
+
+	if (block->Dedicated || hasOtherEmptyBlock)
+	{
+		blocks.erase(blockIterator);
+		DestroyBlock(block);
+	}
+}
+
+uint32_t MemoryAllocator::FindMemoryType(const uint32_t inTypeFilter, const VkMemoryPropertyFlags inProperties) const
+{
+	for (uint32_t memoryTypeIndex = 0; memoryTypeIndex < m_MemoryProperties.memoryTypeCount; ++memoryTypeIndex)
+	{
+		if ((inTypeFilter & (1 << memoryTypeIndex)) && (m_MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & inProperties) == inProperties)
+		{
+			return memoryTypeIndex;
+		}
+	}
+
+	FT_FAIL("Failed to find suitable memory type.");
+}
+
+MemoryStatistics MemoryAllocator::GetStatistics() const
+{
+	MemoryStatistics statistics;
+	for (const MemoryPoolStatistics& poolStatistics : GetPoolStatistics())
+	{
+		statistics.BlockCount += poolStatistics.BlockCount;
+		statistics.AllocationCount += poolStatistics.AllocationCount;
+		statistics.BlockSize += poolStatistics.BlockSize;
+		statistics.UsedSize += poolStatistics.UsedSize;
+	}
+
+	statistics.DeviceAllocationCount = m_DeviceAllocationCount;
+	return statistics;
+}
+
+std::vector<MemoryPoolStatistics> MemoryAllocator::GetPoolStatistics() const
+{
+	// Only pools holding blocks are reported, most memory type and resource kind pairs are never used.
+	std::vector<MemoryPoolStatistics> poolStatistics;
+	for (uint32_t poolIndex = 0; poolIndex < m_Pools.size(); ++poolIndex)
+	{
+		const Pool& pool = m_Pools[poolIndex];
+		if (pool.Blocks.empty())
+		{
+			continue;
+		}
+
+		MemoryPoolStatistics statistics;
+		statistics.MemoryTypeIndex = poolIndex / static_cast<uint32_t>(MemoryResourceKind::Count);
+		statistics.PropertyFlags = m_MemoryProperties.memoryTypes[statistics.MemoryTypeIndex].propertyFlags;
+		statistics.ResourceKind = static_cast<MemoryResourceKind>(poolIndex % static_cast<uint32_t>(MemoryResourceKind::Count));
+		statistics.BlockCount = static_cast<uint32_t>(pool.Blocks.size());
+
+		for (const Block* block : pool.Blocks)
+		{
+			statistics.AllocationCount += block->AllocationCount;
+			statistics.BlockSize += block->Size;
+			statistics.UsedSize += block->UsedSize;
+		}
+
+		poolStatistics.push_back(statistics);
+	}
+
+	return poolStatistics;
+}
+
+MemoryAllocator::Block* MemoryAllocator::CreateBlock(const uint32_t inMemoryTypeIndex, const VkDeviceSize inSize, const bool inDedicated)
+{
+	Block* block = new Block();
+	block->Size = inSize;
+	block->Dedicated = inDedicated;
+	block->FreeRanges[0] = inSize;
+
+	VkMemoryAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = inSize;
+	allocateInfo.memoryTypeIndex = inMemoryTypeIndex;
+
+	FT_VK_CALL(vkAllocateMemory(m_Device, &allocateInfo, nullptr, &block->Memory));
+	++m_DeviceAllocationCount;
+
+	// Memory can't be mapped twice, so host visible blocks are mapped once for the whole block and never unmapped.
+	if (m_MemoryProperties.memoryTypes[inMemoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		void* hostVisibleData = nullptr;
+		FT_VK_CALL(vkMapMemory(m_Device, block->Memory, 0, VK_WHOLE_SIZE, 0, &hostVisibleData));
+		block->HostVisibleData = static_cast<unsigned char*>(hostVisibleData);
+	}
+
+	return block;
+}
+
+void MemoryAllocator::DestroyBlock(Block* inBlock)
+{
+	// Freeing the memory unmaps it implicitly.
+	vkFreeMemory(m_Device, inBlock->Memory, nullptr);
+	--m_DeviceAllocationCount;
+	delete(inBlock);
+}
+
+VkDeviceSize MemoryAllocator::GetBlockSize(const uint32_t inMemoryTypeIndex) const
+{
+	const VkMemoryType& memoryType = m_MemoryProperties.memoryTypes[inMemoryTypeIndex];
+	const VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[memoryType.heapIndex].size;
+
+	// Small heaps, like the host visible part of device local memory, would be taken up by a few default blocks.
+	return std::min(DefaultBlockSize, heapSize / 8);
+}
+
+FT_END_NAMESPACE
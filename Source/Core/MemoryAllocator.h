@@ -0,0 +1,99 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+// Linear and optimal resources are kept in separate pools, so neighbouring resources never break bufferImageGranularity.
+enum class MemoryResourceKind : uint8_t
+{
+	Linear,
+	Optimal,
+
+	Count
+};
+
+// Range of a device memory block, mapped persistently when the memory is host visible.
+struct MemoryAllocation
+{
+	VkDeviceMemory Memory = VK_NULL_HANDLE;
+	VkDeviceSize Offset = 0;
+	VkDeviceSize Size = 0;
+	void* HostVisibleData = nullptr;
+	uint32_t PoolIndex = 0;
+};
+
+struct MemoryPoolStatistics
+{
+	uint32_t MemoryTypeIndex = 0;
+	VkMemoryPropertyFlags PropertyFlags = 0;
+	MemoryResourceKind ResourceKind = MemoryResourceKind::Linear;
+	uint32_t BlockCount = 0;
+	uint32_t AllocationCount = 0;
+	VkDeviceSize BlockSize = 0;
+	VkDeviceSize UsedSize = 0;
+};
+
+struct MemoryStatistics
+{
+	uint32_t BlockCount = 0;
+	uint32_t AllocationCount = 0;
+	VkDeviceSize BlockSize = 0;
+	VkDeviceSize UsedSize = 0;
+	uint32_t DeviceAllocationCount = 0;
+};
+
+// Suballocates buffers and images from large device memory blocks, one pool per memory type and resource kind, instead of
+// calling vkAllocateMemory for each of them. Freed ranges go back to the free list of their block and are merged with their
+// neighbours, and an emptied block is kept around, so replacing resources doesn't allocate device memory again.
+// Resources are only created and destroyed on the main thread.
+class MemoryAllocator
+{
+public:
+	MemoryAllocator(const VkPhysicalDevice inPhysicalDevice, const VkDevice inDevice);
+	~MemoryAllocator();
+	FT_DELETE_COPY_AND_MOVE(MemoryAllocator)
+
+public:
+	MemoryAllocation Allocate(const VkMemoryRequirements& inRequirements, const VkMemoryPropertyFlags inProperties, const MemoryResourceKind inResourceKind);
+	void Free(const MemoryAllocation& inAllocation);
+	uint32_t FindMemoryType(const uint32_t inTypeFilter, const VkMemoryPropertyFlags inProperties) const;
+
+public:
+	MemoryStatistics GetStatistics() const;
+	std::vector<MemoryPoolStatistics> GetPoolStatistics() const;
+	uint32_t GetMaxAllocationCount() const { return m_MaxAllocationCount; }
+
+private:
+	struct Block
+	{
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+		VkDeviceSize Size = 0;
+		VkDeviceSize UsedSize = 0;
+		uint32_t AllocationCount = 0;
+		unsigned char* HostVisibleData = nullptr;
+		bool Dedicated = false;
+
+		// Free ranges by their offset, neighbouring ones are merged when freed.
+		std::map<VkDeviceSize, VkDeviceSize> FreeRanges;
+	};
+
+	struct Pool
+	{
+		std::vector<Block*> Blocks;
+	};
+
+	Block* CreateBlock(const uint32_t inMemoryTypeIndex, const VkDeviceSize inSize, const bool inDedicated);
+	void DestroyBlock(Block* inBlock);
+	VkDeviceSize GetBlockSize(const uint32_t inMemoryTypeIndex) const;
+
+private:
+	VkDevice m_Device;
+	VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+	uint32_t m_MaxAllocationCount;
+	// Live vkAllocateMemory allocations, compared against maxMemoryAllocationCount.
+	uint32_t m_DeviceAllocationCount;
+
+	// Indexed by memory type, then by resource kind.
+	std::vector<Pool> m_Pools;
+};
+
+FT_END_NAMESPACE
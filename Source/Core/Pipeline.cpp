@@ -3,108 +3,381 @@
 #include "Swapchain.h"
 #include "DescriptorSet.h"
 #include "Shader.h"
+#include "Compiler/ShaderReflect.h"
 
 FT_BEGIN_NAMESPACE
 
-static void CreatePipelineLayout(const VkDevice inDevice, const VkDescriptorSetLayout inDescriptorSetLayout, VkPipelineLayout& outPipelineLayout)
+static void CreatePipelineLayout(const VkDevice inDevice, const std::vector<VkDescriptorSetLayout>& inDescriptorSetLayouts, const std::vector<VkPushConstantRange>& inPushConstantRanges,
+	const VkPipelineLayoutCreateFlags inFlags, VkPipelineLayout& outPipelineLayout)
 {
 	VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
 	pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutCreateInfo.setLayoutCount = 1;
-	pipelineLayoutCreateInfo.pSetLayouts = &inDescriptorSetLayout;
+	pipelineLayoutCreateInfo.flags = inFlags;
+	pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(inDescriptorSetLayouts.size());
+	pipelineLayoutCreateInfo.pSetLayouts = inDescriptorSetLayouts.data();
+	pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(inPushConstantRanges.size());
+	pipelineLayoutCreateInfo.pPushConstantRanges = inPushConstantRanges.data();
 
 	FT_VK_CALL(vkCreatePipelineLayout(inDevice, &pipelineLayoutCreateInfo, nullptr, &outPipelineLayout));
 }
 
-static void CreateGraphicsPipeline(const VkDevice inDevice, const Swapchain* inSwapchain, const Shader* inVertexShader, const Shader* inFragmentShader, const VkPipelineLayout inPipelineLayout, VkPipeline& outPraphicsPipeline)
+// Every constant is 32 bits wide, so values are tightly packed in constant order.
+struct SpecializationState
+{
+	std::vector<VkSpecializationMapEntry> MapEntries;
+	std::vector<uint32_t> Data;
+	VkSpecializationInfo Info{};
+};
+
+static void FillSpecializationState(const std::vector<SpecializationConstant>& inSpecializationConstants, SpecializationState& outSpecializationState)
+{
+	outSpecializationState.MapEntries.resize(inSpecializationConstants.size());
+	outSpecializationState.Data.resize(inSpecializationConstants.size());
+	for (size_t constantIndex = 0; constantIndex < inSpecializationConstants.size(); ++constantIndex)
+	{
+		outSpecializationState.MapEntries[constantIndex].constantID = inSpecializationConstants[constantIndex].ConstantId;
+		outSpecializationState.MapEntries[constantIndex].offset = static_cast<uint32_t>(sizeof(uint32_t) * constantIndex);
+		outSpecializationState.MapEntries[constantIndex].size = sizeof(uint32_t);
+		outSpecializationState.Data[constantIndex] = inSpecializationConstants[constantIndex].Value;
+	}
+
+	outSpecializationState.Info.mapEntryCount = static_cast<uint32_t>(outSpecializationState.MapEntries.size());
+	outSpecializationState.Info.pMapEntries = outSpecializationState.MapEntries.data();
+	outSpecializationState.Info.dataSize = sizeof(uint32_t) * outSpecializationState.Data.size();
+	outSpecializationState.Info.pData = outSpecializationState.Data.data();
+}
+
+// Same for every pipeline, monolithic pipelines and pipeline libraries pick the parts they need.
+struct FixedFunctionState
+{
+	VkPipelineVertexInputStateCreateInfo VertexInputState{};
+	VkPipelineInputAssemblyStateCreateInfo InputAssemblyState{};
+	VkViewport Viewport{};
+	VkRect2D Scissor{};
+	VkPipelineViewportStateCreateInfo ViewportState{};
+	VkPipelineRasterizationStateCreateInfo RasterizationState{};
+	VkPipelineMultisampleStateCreateInfo MultisampleState{};
+	VkPipelineColorBlendAttachmentState ColorBlendAttachment{};
+	VkPipelineColorBlendStateCreateInfo ColorBlendState{};
+};
+
+static void FillFixedFunctionState(const Swapchain* inSwapchain, FixedFunctionState& outFixedFunctionState)
+{
+	outFixedFunctionState.VertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	outFixedFunctionState.InputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	outFixedFunctionState.InputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	outFixedFunctionState.InputAssemblyState.primitiveRestartEnable = VK_FALSE;
+
+	outFixedFunctionState.Viewport.x = 0.0f;
+	outFixedFunctionState.Viewport.y = 0.0f;
+	outFixedFunctionState.Viewport.width = static_cast<float>(inSwapchain->GetExtent().width);
+	outFixedFunctionState.Viewport.height = static_cast<float>(inSwapchain->GetExtent().height);
+	outFixedFunctionState.Viewport.minDepth = 0.0f;
+	outFixedFunctionState.Viewport.maxDepth = 1.0f;
+
+	outFixedFunctionState.Scissor.offset = { 0, 0 };
+	outFixedFunctionState.Scissor.extent = inSwapchain->GetExtent();
+
+	outFixedFunctionState.ViewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	outFixedFunctionState.ViewportState.viewportCount = 1;
+	outFixedFunctionState.ViewportState.pViewports = &outFixedFunctionState.Viewport;
+	outFixedFunctionState.ViewportState.scissorCount = 1;
+	outFixedFunctionState.ViewportState.pScissors = &outFixedFunctionState.Scissor;
+
+	outFixedFunctionState.RasterizationState.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	outFixedFunctionState.RasterizationState.depthClampEnable = VK_FALSE;
+	outFixedFunctionState.RasterizationState.rasterizerDiscardEnable = VK_FALSE;
+	outFixedFunctionState.RasterizationState.polygonMode = VK_POLYGON_MODE_FILL;
+	outFixedFunctionState.RasterizationState.lineWidth = 1.0f;
+	outFixedFunctionState.RasterizationState.cullMode = VK_CULL_MODE_FRONT_BIT;
+	outFixedFunctionState.RasterizationState.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	outFixedFunctionState.RasterizationState.depthBiasEnable = VK_FALSE;
+
+	outFixedFunctionState.MultisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	outFixedFunctionState.MultisampleState.sampleShadingEnable = VK_FALSE;
+	outFixedFunctionState.MultisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	outFixedFunctionState.ColorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	outFixedFunctionState.ColorBlendAttachment.blendEnable = VK_FALSE;
+
+	outFixedFunctionState.ColorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	outFixedFunctionState.ColorBlendState.logicOpEnable = VK_FALSE;
+	outFixedFunctionState.ColorBlendState.logicOp = VK_LOGIC_OP_COPY;
+	outFixedFunctionState.ColorBlendState.attachmentCount = 1;
+	outFixedFunctionState.ColorBlendState.pAttachments = &outFixedFunctionState.ColorBlendAttachment;
+	outFixedFunctionState.ColorBlendState.blendConstants[0] = 0.0f;
+	outFixedFunctionState.ColorBlendState.blendConstants[1] = 0.0f;
+	outFixedFunctionState.ColorBlendState.blendConstants[2] = 0.0f;
+	outFixedFunctionState.ColorBlendState.blendConstants[3] = 0.0f;
+}
+
+static void CreateGraphicsPipeline(const VkDevice inDevice, const VkPipelineCache inPipelineCache, const Swapchain* inSwapchain, const Shader* inVertexShader, const Shader* inFragmentShader,
+	const std::vector<SpecializationConstant>& inSpecializationConstants, const VkPipelineLayout inPipelineLayout, VkPipeline& outPraphicsPipeline)
 {
 	VkPipelineShaderStageCreateInfo shaderStageCreateInfos[] = { inVertexShader->GetVkPipelineStageInfo(), inFragmentShader->GetVkPipelineStageInfo() };
 
-	VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{};
-	vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-
-	VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo{};
-	inputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	inputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-	inputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
-
-	VkViewport viewport{};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = static_cast<float>(inSwapchain->GetExtent().width);
-	viewport.height = static_cast<float>(inSwapchain->GetExtent().height);
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-
-	VkRect2D scissor{};
-	scissor.offset = { 0, 0 };
-	scissor.extent = inSwapchain->GetExtent();
-
-	VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
-	viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportStateCreateInfo.viewportCount = 1;
-	viewportStateCreateInfo.pViewports = &viewport;
-	viewportStateCreateInfo.scissorCount = 1;
-	viewportStateCreateInfo.pScissors = &scissor;
-
-	VkPipelineRasterizationStateCreateInfo rasterizationStateCreateInfo{};
-	rasterizationStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizationStateCreateInfo.depthClampEnable = VK_FALSE;
-	rasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
-	rasterizationStateCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
-	rasterizationStateCreateInfo.lineWidth = 1.0f;
-	rasterizationStateCreateInfo.cullMode = VK_CULL_MODE_FRONT_BIT;
-	rasterizationStateCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-	rasterizationStateCreateInfo.depthBiasEnable = VK_FALSE;
-
-	VkPipelineMultisampleStateCreateInfo multisampleStateCreateInfo{};
-	multisampleStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampleStateCreateInfo.sampleShadingEnable = VK_FALSE;
-	multisampleStateCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_FALSE;
-
-	VkPipelineColorBlendStateCreateInfo colorBlendStateCreateInfo{};
-	colorBlendStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlendStateCreateInfo.logicOpEnable = VK_FALSE;
-	colorBlendStateCreateInfo.logicOp = VK_LOGIC_OP_COPY;
-	colorBlendStateCreateInfo.attachmentCount = 1;
-	colorBlendStateCreateInfo.pAttachments = &colorBlendAttachment;
-	colorBlendStateCreateInfo.blendConstants[0] = 0.0f;
-	colorBlendStateCreateInfo.blendConstants[1] = 0.0f;
-	colorBlendStateCreateInfo.blendConstants[2] = 0.0f;
-	colorBlendStateCreateInfo.blendConstants[3] = 0.0f;
+	SpecializationState specializationState;
+	FillSpecializationState(inSpecializationConstants, specializationState);
+	if (!inSpecializationConstants.empty())
+	{
+		shaderStageCreateInfos[1].pSpecializationInfo = &specializationState.Info;
+	}
+
+	FixedFunctionState fixedFunctionState;
+	FillFixedFunctionState(inSwapchain, fixedFunctionState);
 
 	VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
 	pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 	pipelineCreateInfo.stageCount = 2;
 	pipelineCreateInfo.pStages = shaderStageCreateInfos;
-	pipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
-	pipelineCreateInfo.pInputAssemblyState = &inputAssemblyStateCreateInfo;
-	pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-	pipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
-	pipelineCreateInfo.pMultisampleState = &multisampleStateCreateInfo;
-	pipelineCreateInfo.pColorBlendState = &colorBlendStateCreateInfo;
+	pipelineCreateInfo.pVertexInputState = &fixedFunctionState.VertexInputState;
+	pipelineCreateInfo.pInputAssemblyState = &fixedFunctionState.InputAssemblyState;
+	pipelineCreateInfo.pViewportState = &fixedFunctionState.ViewportState;
+	pipelineCreateInfo.pRasterizationState = &fixedFunctionState.RasterizationState;
+	pipelineCreateInfo.pMultisampleState = &fixedFunctionState.MultisampleState;
+	pipelineCreateInfo.pColorBlendState = &fixedFunctionState.ColorBlendState;
 	pipelineCreateInfo.layout = inPipelineLayout;
 	pipelineCreateInfo.renderPass = inSwapchain->GetRenderPass();
 	pipelineCreateInfo.subpass = 0;
 	pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	FT_VK_CALL(vkCreateGraphicsPipelines(inDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &outPraphicsPipeline));
+	FT_VK_CALL(vkCreateGraphicsPipelines(inDevice, inPipelineCache, 1, &pipelineCreateInfo, nullptr, &outPraphicsPipeline));
+}
+
+// Link time optimization info is retained in every library, so fast linked pipelines can be optimized later on.
+static void CreatePipelineLibrary(const VkDevice inDevice, const VkPipelineCache inPipelineCache, const VkGraphicsPipelineLibraryFlagsEXT inLibraryFlags,
+	VkGraphicsPipelineCreateInfo& inOutPipelineCreateInfo, VkPipeline& outLibrary)
+{
+	VkGraphicsPipelineLibraryCreateInfoEXT libraryCreateInfo{};
+	libraryCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+	libraryCreateInfo.flags = inLibraryFlags;
+
+	inOutPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	inOutPipelineCreateInfo.pNext = &libraryCreateInfo;
+	inOutPipelineCreateInfo.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+	inOutPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	FT_VK_CALL(vkCreateGraphicsPipelines(inDevice, inPipelineCache, 1, &inOutPipelineCreateInfo, nullptr, &outLibrary));
+}
+
+static void CreateFragmentShaderLibrary(const VkDevice inDevice, const VkPipelineCache inPipelineCache, const Swapchain* inSwapchain, const Shader* inFragmentShader,
+	const std::vector<SpecializationConstant>& inSpecializationConstants, const VkPipelineLayout inPipelineLayout, VkPipeline& outLibrary)
+{
+	VkPipelineShaderStageCreateInfo shaderStageCreateInfo = inFragmentShader->GetVkPipelineStageInfo();
+
+	SpecializationState specializationState;
+	FillSpecializationState(inSpecializationConstants, specializationState);
+	if (!inSpecializationConstants.empty())
+	{
+		shaderStageCreateInfo.pSpecializationInfo = &specializationState.Info;
+	}
+
+	FixedFunctionState fixedFunctionState;
+	FillFixedFunctionState(inSwapchain, fixedFunctionState);
+
+	VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+	pipelineCreateInfo.stageCount = 1;
+	pipelineCreateInfo.pStages = &shaderStageCreateInfo;
+	pipelineCreateInfo.pMultisampleState = &fixedFunctionState.MultisampleState;
+	pipelineCreateInfo.layout = inPipelineLayout;
+	pipelineCreateInfo.renderPass = inSwapchain->GetRenderPass();
+	pipelineCreateInfo.subpass = 0;
+
+	CreatePipelineLibrary(inDevice, inPipelineCache, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, pipelineCreateInfo, outLibrary);
+}
+
+// Fast link only stitches already compiled libraries together, the optimized link compiles them again as a whole.
+static void LinkGraphicsPipeline(const VkDevice inDevice, const VkPipelineCache inPipelineCache, PipelineLibrary* inPipelineLibrary, const VkPipeline inFragmentShaderLibrary,
+	const std::vector<VkPushConstantRange>& inPushConstantRanges, const VkPipelineLayout inPipelineLayout, const bool inOptimize, VkPipeline& outGraphicsPipeline)
+{
+	const VkPipeline libraries[] =
+	{
+		inPipelineLibrary->GetVertexInputLibrary(),
+		inPipelineLibrary->GetPreRasterizationLibrary(inPushConstantRanges),
+		inFragmentShaderLibrary,
+		inPipelineLibrary->GetFragmentOutputLibrary()
+	};
+
+	VkPipelineLibraryCreateInfoKHR libraryCreateInfo{};
+	libraryCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+	libraryCreateInfo.libraryCount = static_cast<uint32_t>(sizeof(libraries) / sizeof(libraries[0]));
+	libraryCreateInfo.pLibraries = libraries;
+
+	VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+	pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineCreateInfo.pNext = &libraryCreateInfo;
+	pipelineCreateInfo.flags = inOptimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+	pipelineCreateInfo.layout = inPipelineLayout;
+	pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+	FT_VK_CALL(vkCreateGraphicsPipelines(inDevice, inPipelineCache, 1, &pipelineCreateInfo, nullptr, &outGraphicsPipeline));
+}
+
+static bool ArePushConstantRangesEqual(const std::vector<VkPushConstantRange>& inLeftRanges, const std::vector<VkPushConstantRange>& inRightRanges)
+{
+	if (inLeftRanges.size() != inRightRanges.size())
+	{
+		return false;
+	}
+
+	for (size_t rangeIndex = 0; rangeIndex < inLeftRanges.size(); ++rangeIndex)
+	{
+		if (inLeftRanges[rangeIndex].stageFlags != inRightRanges[rangeIndex].stageFlags ||
+			inLeftRanges[rangeIndex].offset != inRightRanges[rangeIndex].offset ||
+			inLeftRanges[rangeIndex].size != inRightRanges[rangeIndex].size)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static std::vector<VkPushConstantRange> GetPushConstantRanges(const Shader* inVertexShader, const Shader* inFragmentShader)
+{
+	std::vector<VkPushConstantRange> pushConstantRanges;
+
+	const Shader* shaders[] = { inVertexShader, inFragmentShader };
+	for (const Shader* shader : shaders)
+	{
+		const VkPushConstantRange pushConstantRange = shader->GetPushConstantRange();
+		if (pushConstantRange.size > 0)
+		{
+			pushConstantRanges.push_back(pushConstantRange);
+		}
+	}
+
+	return pushConstantRanges;
+}
+
+PipelineLibrary::PipelineLibrary(const Device* inDevice, const Swapchain* inSwapchain, const Shader* inVertexShader)
+	: m_Device(inDevice)
+	, m_Swapchain(inSwapchain)
+	, m_VertexShader(inVertexShader)
+{
+	FixedFunctionState fixedFunctionState;
+	FillFixedFunctionState(m_Swapchain, fixedFunctionState);
+
+	{
+		VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+		pipelineCreateInfo.pVertexInputState = &fixedFunctionState.VertexInputState;
+		pipelineCreateInfo.pInputAssemblyState = &fixedFunctionState.InputAssemblyState;
+
+		CreatePipelineLibrary(m_Device->GetDevice(), m_Device->GetPipelineCache(), VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, pipelineCreateInfo, m_VertexInputLibrary);
+	}
+
+	{
+		VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+		pipelineCreateInfo.pMultisampleState = &fixedFunctionState.MultisampleState;
+		pipelineCreateInfo.pColorBlendState = &fixedFunctionState.ColorBlendState;
+		pipelineCreateInfo.renderPass = m_Swapchain->GetRenderPass();
+		pipelineCreateInfo.subpass = 0;
+
+		CreatePipelineLibrary(m_Device->GetDevice(), m_Device->GetPipelineCache(), VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, pipelineCreateInfo, m_FragmentOutputLibrary);
+	}
+}
+
+PipelineLibrary::~PipelineLibrary()
+{
+	for (const PreRasterizationLibrary& preRasterizationLibrary : m_PreRasterizationLibraries)
+	{
+		vkDestroyPipeline(m_Device->GetDevice(), preRasterizationLibrary.Library, nullptr);
+		vkDestroyPipelineLayout(m_Device->GetDevice(), preRasterizationLibrary.PipelineLayout, nullptr);
+	}
+
+	vkDestroyPipeline(m_Device->GetDevice(), m_FragmentOutputLibrary, nullptr);
+	vkDestroyPipeline(m_Device->GetDevice(), m_VertexInputLibrary, nullptr);
+}
+
+VkPipeline PipelineLibrary::GetPreRasterizationLibrary(const std::vector<VkPushConstantRange>& inPushConstantRanges)
+{
+	std::lock_guard<std::mutex> lock(m_PreRasterizationMutex);
+
+	for (const PreRasterizationLibrary& preRasterizationLibrary : m_PreRasterizationLibraries)
+	{
+		if (ArePushConstantRangesEqual(preRasterizationLibrary.PushConstantRanges, inPushConstantRanges))
+		{
+			return preRasterizationLibrary.Library;
+		}
+	}
+
+	PreRasterizationLibrary preRasterizationLibrary;
+	preRasterizationLibrary.PushConstantRanges = inPushConstantRanges;
+
+	// Vertex shader doesn't use descriptors, independent sets let its layout leave them out.
+	CreatePipelineLayout(m_Device->GetDevice(), std::vector<VkDescriptorSetLayout>(), inPushConstantRanges,
+		VK_PIPELINE_LAYOUT_CREATE_INDEPENDENT_SETS_BIT_EXT, preRasterizationLibrary.PipelineLayout);
+
+	FixedFunctionState fixedFunctionState;
+	FillFixedFunctionState(m_Swapchain, fixedFunctionState);
+
+	const VkPipelineShaderStageCreateInfo shaderStageCreateInfo = m_VertexShader->GetVkPipelineStageInfo();
+
+	VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+	pipelineCreateInfo.stageCount = 1;
+	pipelineCreateInfo.pStages = &shaderStageCreateInfo;
+	pipelineCreateInfo.pViewportState = &fixedFunctionState.ViewportState;
+	pipelineCreateInfo.pRasterizationState = &fixedFunctionState.RasterizationState;
+	pipelineCreateInfo.layout = preRasterizationLibrary.PipelineLayout;
+	pipelineCreateInfo.renderPass = m_Swapchain->GetRenderPass();
+	pipelineCreateInfo.subpass = 0;
+
+	CreatePipelineLibrary(m_Device->GetDevice(), m_Device->GetPipelineCache(), VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, pipelineCreateInfo, preRasterizationLibrary.Library);
+
+	m_PreRasterizationLibraries.push_back(preRasterizationLibrary);
+
+	return preRasterizationLibrary.Library;
+}
+
+Pipeline::Pipeline(const Device* inDevice, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader,
+	const std::vector<SpecializationConstant>& inSpecializationConstants, PipelineLibrary* inPipelineLibrary)
+	: m_Device(inDevice)
+	, m_PipelineLibrary(inPipelineLibrary)
+	, m_FragmentShaderLibrary(VK_NULL_HANDLE)
+{
+	const std::vector<VkPushConstantRange> pushConstantRanges = GetPushConstantRanges(inVertexShader, inFragmentShader);
+
+	if (!m_PipelineLibrary)
+	{
+		CreatePipelineLayout(m_Device->GetDevice(), inDescriptorSet->GetDescriptorSetLayouts(), pushConstantRanges, 0, m_PipelineLayout);
+		CreateGraphicsPipeline(m_Device->GetDevice(), m_Device->GetPipelineCache(), inSwapchain, inVertexShader, inFragmentShader, inSpecializationConstants, m_PipelineLayout, m_GraphicsPipeline);
+		return;
+	}
+
+	CreatePipelineLayout(m_Device->GetDevice(), inDescriptorSet->GetDescriptorSetLayouts(), pushConstantRanges, VK_PIPELINE_LAYOUT_CREATE_INDEPENDENT_SETS_BIT_EXT, m_PipelineLayout);
+	CreateFragmentShaderLibrary(m_Device->GetDevice(), m_Device->GetPipelineCache(), inSwapchain, inFragmentShader, inSpecializationConstants, m_PipelineLayout, m_FragmentShaderLibrary);
+	LinkGraphicsPipeline(m_Device->GetDevice(), m_Device->GetPipelineCache(), m_PipelineLibrary, m_FragmentShaderLibrary, pushConstantRanges, m_PipelineLayout, false, m_GraphicsPipeline);
+}
+
+Pipeline::Pipeline(const Device* inDevice, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader, PipelineLibrary* inPipelineLibrary,
+	const Pipeline* inFastLinkedPipeline)
+	: m_Device(inDevice)
+	, m_PipelineLibrary(inPipelineLibrary)
+	, m_FragmentShaderLibrary(VK_NULL_HANDLE)
+{
+	FT_CHECK(inFastLinkedPipeline->IsFastLinked(), "Only fast linked pipelines can be linked again with optimization.");
+
+	// Layout is compatible with the one of the fast linked pipeline, which can be destroyed independently of this one.
+	const std::vector<VkPushConstantRange> pushConstantRanges = GetPushConstantRanges(inVertexShader, inFragmentShader);
+	CreatePipelineLayout(m_Device->GetDevice(), inDescriptorSet->GetDescriptorSetLayouts(), pushConstantRanges, VK_PIPELINE_LAYOUT_CREATE_INDEPENDENT_SETS_BIT_EXT, m_PipelineLayout);
+	LinkGraphicsPipeline(m_Device->GetDevice(), m_Device->GetPipelineCache(), m_PipelineLibrary, inFastLinkedPipeline->m_FragmentShaderLibrary, pushConstantRanges, m_PipelineLayout, true, m_GraphicsPipeline);
 }
 
-Pipeline::Pipeline(const Device* inDevice, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader)
+Pipeline::Pipeline(const Device* inDevice, const Swapchain* inSwapchain, const VkDescriptorSetLayout inDescriptorSetLayout, const std::vector<VkPushConstantRange>& inPushConstantRanges,
+	const Shader* inVertexShader, const Shader* inFragmentShader)
 	: m_Device(inDevice)
+	, m_PipelineLibrary(nullptr)
+	, m_FragmentShaderLibrary(VK_NULL_HANDLE)
 {
-	CreatePipelineLayout(m_Device->GetDevice(), inDescriptorSet->GetDescriptorSetLayout(), m_PipelineLayout);
-	CreateGraphicsPipeline(m_Device->GetDevice(), inSwapchain, inVertexShader, inFragmentShader, m_PipelineLayout, m_GraphicsPipeline);
+	CreatePipelineLayout(m_Device->GetDevice(), std::vector<VkDescriptorSetLayout>(1, inDescriptorSetLayout), inPushConstantRanges, 0, m_PipelineLayout);
+	CreateGraphicsPipeline(m_Device->GetDevice(), m_Device->GetPipelineCache(), inSwapchain, inVertexShader, inFragmentShader, std::vector<SpecializationConstant>(), m_PipelineLayout, m_GraphicsPipeline);
 }
 
 Pipeline::~Pipeline()
 {
 	vkDestroyPipeline(m_Device->GetDevice(), m_GraphicsPipeline, nullptr);
+	vkDestroyPipeline(m_Device->GetDevice(), m_FragmentShaderLibrary, nullptr);
 	vkDestroyPipelineLayout(m_Device->GetDevice(), m_PipelineLayout, nullptr);
 }
 
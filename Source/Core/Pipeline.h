@@ -6,22 +6,71 @@ class Device;
 class Swapchain;
 class DescriptorSet;
 class Shader;
+struct SpecializationConstant;
+
+// Vertex input, pre-rasterization and fragment output parts of the pipeline never change between recompiles, so they are
+// created once per swapchain as graphics pipeline libraries. Only the fragment shader is compiled again and fast linked with them.
+class PipelineLibrary
+{
+public:
+	PipelineLibrary(const Device* inDevice, const Swapchain* inSwapchain, const Shader* inVertexShader);
+	~PipelineLibrary();
+	FT_DELETE_COPY_AND_MOVE(PipelineLibrary)
+
+public:
+	VkPipeline GetPreRasterizationLibrary(const std::vector<VkPushConstantRange>& inPushConstantRanges);
+
+public:
+	VkPipeline GetVertexInputLibrary() const { return m_VertexInputLibrary; }
+	VkPipeline GetFragmentOutputLibrary() const { return m_FragmentOutputLibrary; }
+
+private:
+	// Push constant ranges of the pre-rasterization layout have to match the fragment shader ones, so there's a library per range set.
+	struct PreRasterizationLibrary
+	{
+		std::vector<VkPushConstantRange> PushConstantRanges;
+		VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
+		VkPipeline Library = VK_NULL_HANDLE;
+	};
+
+	const Device* m_Device;
+	const Swapchain* m_Swapchain;
+	const Shader* m_VertexShader;
+	VkPipeline m_VertexInputLibrary;
+	VkPipeline m_FragmentOutputLibrary;
+
+	// Pipelines are created on the builder thread as well.
+	std::mutex m_PreRasterizationMutex;
+	std::vector<PreRasterizationLibrary> m_PreRasterizationLibraries;
+};
 
 class Pipeline
 {
 public:
-	Pipeline(const Device* inDevice, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader);
+	// Pipeline is fast linked from libraries when they are passed, otherwise it's created monolithically.
+	Pipeline(const Device* inDevice, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader,
+		const std::vector<SpecializationConstant>& inSpecializationConstants, PipelineLibrary* inPipelineLibrary);
+	// Links the fragment shader library of a fast linked pipeline again, this time with link time optimization.
+	Pipeline(const Device* inDevice, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader, PipelineLibrary* inPipelineLibrary,
+		const Pipeline* inFastLinkedPipeline);
+	Pipeline(const Device* inDevice, const Swapchain* inSwapchain, const VkDescriptorSetLayout inDescriptorSetLayout, const std::vector<VkPushConstantRange>& inPushConstantRanges,
+		const Shader* inVertexShader, const Shader* inFragmentShader);
 	~Pipeline();
 	FT_DELETE_COPY_AND_MOVE(Pipeline)
 
 public:
 	VkPipelineLayout GetPipelineLayout() const { return m_PipelineLayout; }
 	VkPipeline GetGraphicsPipeline() const { return m_GraphicsPipeline; }
+	bool IsFastLinked() const { return m_FragmentShaderLibrary != VK_NULL_HANDLE; }
 
 private:
 	const Device* m_Device;
+	PipelineLibrary* m_PipelineLibrary;
 	VkPipelineLayout m_PipelineLayout;
 	VkPipeline m_GraphicsPipeline;
+
+	// Kept only by fast linked pipelines, since it's linked again once the optimized pipeline is created.
+	VkPipeline m_FragmentShaderLibrary;
 };
 
 FT_END_NAMESPACE
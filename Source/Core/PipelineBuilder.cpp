@@ -0,0 +1,308 @@
+#include "PipelineBuilder.h"
+#include "Shader.h"
+#include "Pipeline.h"
+#include "Compiler/ShaderOptimizer.h"
+
+FT_BEGIN_NAMESPACE
+
+// Relaxed module is only needed while the pipeline is created, so it doesn't outlive the build. Result is null when the passes fail.
+static Pipeline* CreateRelaxedPipeline(const Device* inDevice, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader,
+	const Shader* inFragmentShader, const std::vector<SpecializationConstant>& inSpecializationConstants, const bool inConvertToHalf)
+{
+	std::vector<uint32_t> relaxedSpvCode;
+	std::string infoLog;
+	if (!ShaderOptimizer::RelaxPrecision(inFragmentShader->GetSpvCode(), inConvertToHalf, relaxedSpvCode, infoLog))
+	{
+		FT_LOG("Failed relaxing precision of the fragment shader, comparison is paused.\n%s", infoLog.c_str());
+		return nullptr;
+	}
+
+	// Relaxation doesn't touch specialization constant ids, so the values of the original module apply as they are.
+	Shader relaxedFragmentShader(inDevice, ShaderStage::Fragment, relaxedSpvCode);
+	return new Pipeline(inDevice, inSwapchain, inDescriptorSet, inVertexShader, &relaxedFragmentShader, inSpecializationConstants, nullptr);
+}
+
+PipelineBuilder::PipelineBuilder(const Device* inDevice)
+	: m_Device(inDevice)
+	, m_Generation(0)
+	, m_PrebuildGeneration(0)
+	, m_Busy(false)
+	, m_Quit(false)
+	, m_HasPendingRequest(false)
+	, m_HasResult(false)
+	, m_Result(nullptr)
+{
+	m_Thread = std::thread(&PipelineBuilder::Run, this);
+}
+
+PipelineBuilder::~PipelineBuilder()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_Condition.notify_one();
+	m_Thread.join();
+
+	delete(m_Result);
+	ClearPrebuilds();
+}
+
+void PipelineBuilder::Submit(const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader,
+	const std::vector<SpecializationConstant>& inSpecializationConstants, PipelineLibrary* inPipelineLibrary)
+{
+	Request request;
+	request.TargetSwapchain = inSwapchain;
+	request.TargetDescriptorSet = inDescriptorSet;
+	request.VertexShader = inVertexShader;
+	request.FragmentShader = inFragmentShader;
+	request.SpecializationConstants = inSpecializationConstants;
+	request.TargetPipelineLibrary = inPipelineLibrary;
+
+	SubmitRequest(request);
+}
+
+void PipelineBuilder::SubmitOptimization(const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader, PipelineLibrary* inPipelineLibrary,
+	const Pipeline* inFastLinkedPipeline)
+{
+	Request request;
+	request.TargetDescriptorSet = inDescriptorSet;
+	request.VertexShader = inVertexShader;
+	request.FragmentShader = inFragmentShader;
+	request.TargetPipelineLibrary = inPipelineLibrary;
+	request.FastLinkedPipeline = inFastLinkedPipeline;
+
+	SubmitRequest(request);
+}
+
+void PipelineBuilder::SubmitRelaxed(const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader,
+	const std::vector<SpecializationConstant>& inSpecializationConstants, const bool inConvertToHalf)
+{
+	Request request;
+	request.TargetSwapchain = inSwapchain;
+	request.TargetDescriptorSet = inDescriptorSet;
+	request.VertexShader = inVertexShader;
+	request.FragmentShader = inFragmentShader;
+	request.SpecializationConstants = inSpecializationConstants;
+	request.RelaxPrecision = true;
+	request.ConvertToHalf = inConvertToHalf;
+
+	SubmitRequest(request);
+}
+
+void PipelineBuilder::QueuePrebuild(const uint64_t inBundleKey, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader,
+	Shader* inFragmentShader, const std::vector<SpecializationConstant>& inSpecializationConstants)
+{
+	// Nothing waits on prebuilds, so they skip the pipeline library and are created fully optimized right away.
+	Request request;
+	request.TargetSwapchain = inSwapchain;
+	request.TargetDescriptorSet = inDescriptorSet;
+	request.VertexShader = inVertexShader;
+	request.FragmentShader = inFragmentShader;
+	request.SpecializationConstants = inSpecializationConstants;
+	request.Prebuild = true;
+	request.BundleKey = inBundleKey;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		request.Generation = m_PrebuildGeneration;
+		m_PrebuildRequests.push_back(std::move(request));
+	}
+
+	m_Condition.notify_one();
+}
+
+void PipelineBuilder::SubmitRequest(const Request& inRequest)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Request which didn't start yet is simply replaced, the one in flight is destroyed once it finishes.
+		m_PendingRequest = inRequest;
+		m_PendingRequest.Generation = ++m_Generation;
+		m_HasPendingRequest = true;
+
+		// Result of the previous generation was never handed out, so no frame could have used it.
+		delete(m_Result);
+		m_Result = nullptr;
+		m_HasResult = false;
+	}
+
+	m_Condition.notify_one();
+}
+
+void PipelineBuilder::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	// Request in flight still finishes, but its pipeline is destroyed by the worker, since its generation is stale.
+	++m_Generation;
+	++m_PrebuildGeneration;
+	m_HasPendingRequest = false;
+
+	delete(m_Result);
+	m_Result = nullptr;
+	m_HasResult = false;
+
+	ClearPrebuilds();
+}
+
+void PipelineBuilder::ClearPrebuilds()
+{
+	for (const Request& request : m_PrebuildRequests)
+	{
+		delete(request.FragmentShader);
+	}
+	m_PrebuildRequests.clear();
+
+	// Prebuilt bundles which weren't handed out were never used by a frame.
+	for (const PrebuiltBundle& prebuiltBundle : m_PrebuiltBundles)
+	{
+		delete(prebuiltBundle.Bundle.GraphicsPipeline);
+		delete(prebuiltBundle.Bundle.FragmentShader);
+	}
+	m_PrebuiltBundles.clear();
+}
+
+void PipelineBuilder::WaitIdle()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_ResultCondition.wait(lock, [this]() { return !m_Busy && !m_HasPendingRequest && m_PrebuildRequests.empty(); });
+}
+
+bool PipelineBuilder::TryGetResult(Pipeline*& outPipeline)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (!m_HasResult)
+	{
+		return false;
+	}
+
+	outPipeline = m_Result;
+	m_Result = nullptr;
+	m_HasResult = false;
+
+	return true;
+}
+
+bool PipelineBuilder::TryGetPrebuiltBundle(uint64_t& outBundleKey, PipelineBundle& outBundle)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (m_PrebuiltBundles.empty())
+	{
+		return false;
+	}
+
+	outBundleKey = m_PrebuiltBundles.front().BundleKey;
+	outBundle = m_PrebuiltBundles.front().Bundle;
+	m_PrebuiltBundles.pop_front();
+
+	return true;
+}
+
+Pipeline* PipelineBuilder::WaitResult()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_ResultCondition.wait(lock, [this]() { return m_HasResult; });
+
+	Pipeline* pipeline = m_Result;
+	m_Result = nullptr;
+	m_HasResult = false;
+
+	return pipeline;
+}
+
+void PipelineBuilder::Run()
+{
+	while (true)
+	{
+		Request request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_Quit || m_HasPendingRequest || !m_PrebuildRequests.empty(); });
+
+			if (m_Quit)
+			{
+				return;
+			}
+
+			// Submits are waited on by the renderer, so they go before any queued prebuild.
+			if (m_HasPendingRequest)
+			{
+				request = std::move(m_PendingRequest);
+				m_HasPendingRequest = false;
+			}
+			else
+			{
+				request = std::move(m_PrebuildRequests.front());
+				m_PrebuildRequests.pop_front();
+			}
+			m_Busy = true;
+		}
+
+		// Pipeline cache is internally synchronized, so it's shared with pipelines created on the main thread.
+		const auto buildStartTime = std::chrono::high_resolution_clock::now();
+		Pipeline* pipeline = nullptr;
+		if (request.RelaxPrecision)
+		{
+			pipeline = CreateRelaxedPipeline(m_Device, request.TargetSwapchain, request.TargetDescriptorSet, request.VertexShader, request.FragmentShader,
+				request.SpecializationConstants, request.ConvertToHalf);
+		}
+		else
+		{
+			pipeline = request.FastLinkedPipeline ?
+				new Pipeline(m_Device, request.TargetDescriptorSet, request.VertexShader, request.FragmentShader, request.TargetPipelineLibrary, request.FastLinkedPipeline) :
+				new Pipeline(m_Device, request.TargetSwapchain, request.TargetDescriptorSet, request.VertexShader, request.FragmentShader, request.SpecializationConstants,
+					request.TargetPipelineLibrary);
+		}
+		const auto buildEndTime = std::chrono::high_resolution_clock::now();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (request.Prebuild)
+			{
+				// Prebuilds are requested in bulk, so they aren't logged one by one.
+				if (pipeline && request.Generation == m_PrebuildGeneration)
+				{
+					PrebuiltBundle prebuiltBundle;
+					prebuiltBundle.BundleKey = request.BundleKey;
+					prebuiltBundle.Bundle.FragmentShader = const_cast<Shader*>(request.FragmentShader);
+					prebuiltBundle.Bundle.GraphicsPipeline = pipeline;
+					m_PrebuiltBundles.push_back(prebuiltBundle);
+				}
+				else
+				{
+					delete(pipeline);
+					delete(request.FragmentShader);
+				}
+			}
+			else if (request.Generation == m_Generation)
+			{
+				if (pipeline)
+				{
+					const char* buildKind = request.RelaxPrecision ? "relaxed" : (request.FastLinkedPipeline ? "optimized" : (pipeline->IsFastLinked() ? "fast linked" : "created"));
+					FT_LOG("Pipeline %s in background in %.2f ms.\n", buildKind, std::chrono::duration<double, std::milli>(buildEndTime - buildStartTime).count());
+				}
+
+				m_Result = pipeline;
+				m_HasResult = true;
+			}
+			else
+			{
+				delete(pipeline);
+			}
+
+			m_Busy = false;
+		}
+
+		m_ResultCondition.notify_all();
+	}
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Compiler/ShaderReflect.h"
+#include "PipelineBundleCache.h"
+
+FT_BEGIN_NAMESPACE
+
+class Device;
+class Swapchain;
+class DescriptorSet;
+class Shader;
+class Pipeline;
+class PipelineLibrary;
+
+// Creates graphics pipelines on a background thread, so drivers which take long to compile a shader don't block rendering.
+// Every submit supersedes the previous one, pipelines of superseded submits are destroyed by the worker and never handed out.
+// Prebuilds are queued instead and built in order once no submit is pending, each of them hands out its own bundle.
+// Everything passed to a submit has to stay alive until the builder isn't busy anymore.
+class PipelineBuilder
+{
+public:
+	PipelineBuilder(const Device* inDevice);
+	~PipelineBuilder();
+	FT_DELETE_COPY_AND_MOVE(PipelineBuilder)
+
+public:
+	void Submit(const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader,
+		const std::vector<SpecializationConstant>& inSpecializationConstants, PipelineLibrary* inPipelineLibrary);
+	void SubmitOptimization(const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader, PipelineLibrary* inPipelineLibrary,
+		const Pipeline* inFastLinkedPipeline);
+	void SubmitRelaxed(const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader, const Shader* inFragmentShader,
+		const std::vector<SpecializationConstant>& inSpecializationConstants, const bool inConvertToHalf);
+	void QueuePrebuild(const uint64_t inBundleKey, const Swapchain* inSwapchain, const DescriptorSet* inDescriptorSet, const Shader* inVertexShader,
+		Shader* inFragmentShader, const std::vector<SpecializationConstant>& inSpecializationConstants);
+	void Cancel();
+	void WaitIdle();
+	bool TryGetResult(Pipeline*& outPipeline);
+	bool TryGetPrebuiltBundle(uint64_t& outBundleKey, PipelineBundle& outBundle);
+	Pipeline* WaitResult();
+
+public:
+	bool IsBusy() const { return m_Busy; }
+
+private:
+	void Run();
+
+private:
+	struct Request
+	{
+		uint64_t Generation = 0;
+		const Swapchain* TargetSwapchain = nullptr;
+		const DescriptorSet* TargetDescriptorSet = nullptr;
+		const Shader* VertexShader = nullptr;
+		const Shader* FragmentShader = nullptr;
+		std::vector<SpecializationConstant> SpecializationConstants;
+		PipelineLibrary* TargetPipelineLibrary = nullptr;
+
+		// Set only for optimization requests, which link the fragment shader library of this pipeline again.
+		const Pipeline* FastLinkedPipeline = nullptr;
+
+		// Set only for relaxed requests, whose fragment shader is built from a relaxed precision copy of the module.
+		bool RelaxPrecision = false;
+		bool ConvertToHalf = false;
+
+		// Set only for prebuild requests, whose fragment shader is owned by the builder until the bundle is handed out.
+		bool Prebuild = false;
+		uint64_t BundleKey = 0;
+	};
+
+	struct PrebuiltBundle
+	{
+		uint64_t BundleKey = 0;
+		PipelineBundle Bundle;
+	};
+
+	void SubmitRequest(const Request& inRequest);
+	void ClearPrebuilds();
+
+private:
+	const Device* m_Device;
+	std::thread m_Thread;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::condition_variable m_ResultCondition;
+	uint64_t m_Generation;
+	uint64_t m_PrebuildGeneration;
+	std::atomic<bool> m_Busy;
+	bool m_Quit;
+	bool m_HasPendingRequest;
+	Request m_PendingRequest;
+	bool m_HasResult;
+	Pipeline* m_Result;
+	std::list<Request> m_PrebuildRequests;
+	std::list<PrebuiltBundle> m_PrebuiltBundles;
+};
+
+FT_END_NAMESPACE
@@ -0,0 +1,96 @@
+#include "PipelineBundleCache.h"
+
+FT_BEGIN_NAMESPACE
+
+PipelineBundleCache::PipelineBundleCache(const uint32_t inMaxBundleCount)
+	: m_MaxBundleCount(inMaxBundleCount)
+{
+}
+
+PipelineBundleCache::~PipelineBundleCache()
+{
+	FT_CHECK(m_Entries.empty(), "Pipeline bundles have to be cleared before the cache is destroyed.");
+}
+
+void PipelineBundleCache::Store(const uint64_t inKey, const PipelineBundle& inBundle, std::vector<PipelineBundle>& outEvictedBundles)
+{
+	if ((m_MaxBundleCount == 0 && m_PinnedKeys.count(inKey) == 0) || m_Entries.count(inKey) != 0)
+	{
+		outEvictedBundles.push_back(inBundle);
+		return;
+	}
+
+	Entry& entry = m_Entries[inKey];
+	entry.Bundle = inBundle;
+	entry.RecentIterator = m_RecentEntries.insert(m_RecentEntries.begin(), inKey);
+
+	EvictEntries(outEvictedBundles);
+}
+
+bool PipelineBundleCache::Take(const uint64_t inKey, PipelineBundle& outBundle)
+{
+	const auto entryIterator = m_Entries.find(inKey);
+	if (entryIterator == m_Entries.end())
+	{
+		return false;
+	}
+
+	// Active bundle is owned by the renderer, it comes back once it's replaced again.
+	outBundle = entryIterator->second.Bundle;
+	m_RecentEntries.erase(entryIterator->second.RecentIterator);
+	m_Entries.erase(entryIterator);
+
+	return true;
+}
+
+void PipelineBundleCache::Clear(std::vector<PipelineBundle>& outEvictedBundles)
+{
+	for (const auto& entryIterator : m_Entries)
+	{
+		outEvictedBundles.push_back(entryIterator.second.Bundle);
+	}
+
+	m_Entries.clear();
+	m_RecentEntries.clear();
+}
+
+void PipelineBundleCache::SetMaxBundleCount(const uint32_t inMaxBundleCount, std::vector<PipelineBundle>& outEvictedBundles)
+{
+	m_MaxBundleCount = inMaxBundleCount;
+	EvictEntries(outEvictedBundles);
+}
+
+void PipelineBundleCache::SetPinnedKeys(const std::set<uint64_t>& inPinnedKeys, std::vector<PipelineBundle>& outEvictedBundles)
+{
+	// Bundles which aren't pinned anymore count against the limit again.
+	m_PinnedKeys = inPinnedKeys;
+	EvictEntries(outEvictedBundles);
+}
+
+void PipelineBundleCache::EvictEntries(std::vector<PipelineBundle>& outEvictedBundles)
+{
+	size_t unpinnedBundleCount = 0;
+	for (const auto& entryIterator : m_Entries)
+	{
+		unpinnedBundleCount += m_PinnedKeys.count(entryIterator.first) == 0 ? 1 : 0;
+	}
+
+	// Walks from the least recently used bundle, pinned ones are skipped.
+	auto recentIterator = m_RecentEntries.end();
+	while (unpinnedBundleCount > m_MaxBundleCount && recentIterator != m_RecentEntries.begin())
+	{
+		--recentIterator;
+		if (m_PinnedKeys.count(*recentIterator) != 0)
+		{
+			continue;
+		}
+
+		const auto entryIterator = m_Entries.find(*recentIterator);
+		outEvictedBundles.push_back(entryIterator->second.Bundle);
+		m_Entries.erase(entryIterator);
+		recentIterator = m_RecentEntries.erase(recentIterator);
+		--unpinnedBundleCount;
+	}
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,55 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+class Shader;
+class Pipeline;
+
+// Fragment shader along with the pipeline and pipeline layout created from it. Descriptor sets aren't part of it, since they
+// point at the current resources and are cheap to create compared to the pipeline.
+struct PipelineBundle
+{
+	Shader* FragmentShader = nullptr;
+	Pipeline* GraphicsPipeline = nullptr;
+};
+
+// Keeps replaced pipeline bundles, so returning to a recent shader is a pointer swap instead of a rebuild. Drivers don't report
+// how much memory a pipeline takes, so the cache is bounded by bundle count and least recently used bundles are evicted past it.
+// Pinned keys, like the ones of shader variants, don't count against the limit and are never evicted while they stay pinned.
+// Evicted bundles are handed back instead of destroyed, since frames in flight might still use them.
+class PipelineBundleCache
+{
+public:
+	PipelineBundleCache(const uint32_t inMaxBundleCount);
+	~PipelineBundleCache();
+	FT_DELETE_COPY_AND_MOVE(PipelineBundleCache)
+
+public:
+	void Store(const uint64_t inKey, const PipelineBundle& inBundle, std::vector<PipelineBundle>& outEvictedBundles);
+	bool Take(const uint64_t inKey, PipelineBundle& outBundle);
+	void Clear(std::vector<PipelineBundle>& outEvictedBundles);
+	void SetMaxBundleCount(const uint32_t inMaxBundleCount, std::vector<PipelineBundle>& outEvictedBundles);
+	void SetPinnedKeys(const std::set<uint64_t>& inPinnedKeys, std::vector<PipelineBundle>& outEvictedBundles);
+
+public:
+	bool Contains(const uint64_t inKey) const { return m_Entries.count(inKey) != 0; }
+	uint32_t GetMaxBundleCount() const { return m_MaxBundleCount; }
+	uint32_t GetBundleCount() const { return static_cast<uint32_t>(m_Entries.size()); }
+
+private:
+	void EvictEntries(std::vector<PipelineBundle>& outEvictedBundles);
+
+private:
+	struct Entry
+	{
+		PipelineBundle Bundle;
+		std::list<uint64_t>::iterator RecentIterator;
+	};
+
+	uint32_t m_MaxBundleCount;
+	std::set<uint64_t> m_PinnedKeys;
+	std::map<uint64_t, Entry> m_Entries;
+	std::list<uint64_t> m_RecentEntries;
+};
+
+FT_END_NAMESPACE
@@ -0,0 +1,402 @@
+#include "PrecisionComparison.h"
+#include "Device.h"
+#include "Swapchain.h"
+#include "Shader.h"
+#include "Pipeline.h"
+#include "DescriptorSet.h"
+#include "CommandBuffer.h"
+#include "Compiler/ShaderCompiler.h"
+#include "Utility/ShaderFile.h"
+
+FT_BEGIN_NAMESPACE
+
+static const uint32_t QueriesPerFrame = 4;
+
+// Older timings fade out over roughly a second, single frames are too noisy to compare.
+static const double TimingSmoothing = 0.05;
+
+static const char* ViewFragmentShader =
+	"#version 450\n"
+	"\n"
+	"layout (location = 0) in vec2 inUV;\n"
+	"\n"
+	"layout (binding = 0) uniform sampler2D referenceImage;\n"
+	"layout (binding = 1) uniform sampler2D relaxedImage;\n"
+	"\n"
+	"layout (push_constant) uniform ViewParameters\n"
+	"{\n"
+	"	uint View;\n"
+	"	float ErrorScale;\n"
+	"} viewParameters;\n"
+	"\n"
+	"layout (location = 0) out vec4 outColor;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec4 reference = texture(referenceImage, inUV);\n"
+	"	vec4 relaxed = texture(relaxedImage, inUV);\n"
+	"\n"
+	"	if (viewParameters.View == 0u)\n"
+	"	{\n"
+	"		outColor = reference;\n"
+	"		return;\n"
+	"	}\n"
+	"\n"
+	"	if (viewParameters.View == 1u)\n"
+	"	{\n"
+	"		outColor = relaxed;\n"
+	"		return;\n"
+	"	}\n"
+	"\n"
+	"	float error = clamp(length(relaxed - reference) * viewParameters.ErrorScale, 0.0, 1.0);\n"
+	"	outColor = error > 0.0 ? vec4(mix(vec3(0.0, 0.0, 1.0), vec3(1.0, 1.0, 0.0), error), 1.0) : vec4(0.0, 0.0, 0.0, 1.0);\n"
+	"}\n";
+
+struct ViewParameters
+{
+	uint32_t View;
+	float ErrorScale;
+};
+
+// Bits above the valid ones are undefined, the masked difference also stays correct when the counter wraps around in between.
+static uint64_t GetTimestampDelta(const uint64_t inBeginTimestamp, const uint64_t inEndTimestamp, const uint32_t inValidBits)
+{
+	const uint64_t validMask = inValidBits >= 64 ? ~0ull : (1ull << inValidBits) - 1;
+	return ((inEndTimestamp & validMask) - (inBeginTimestamp & validMask)) & validMask;
+}
+
+static void CreateRenderPass(const VkDevice inDevice, const VkFormat inFormat, VkRenderPass& outRenderPass)
+{
+	// Same attachment as the swapchain render pass, so pipelines created for the swapchain are compatible with it.
+	VkAttachmentDescription colorAttachment{};
+	colorAttachment.format = inFormat;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkAttachmentReference colorAttachmentRef{};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	VkSubpassDescription subpass{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+
+	// Previous frame might still be sampling the image, and the next view draw has to see everything written.
+	std::array<VkSubpassDependency, 2> dependencies{};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	VkRenderPassCreateInfo renderPassCreateInfo{};
+	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.attachmentCount = 1;
+	renderPassCreateInfo.pAttachments = &colorAttachment;
+	renderPassCreateInfo.subpassCount = 1;
+	renderPassCreateInfo.pSubpasses = &subpass;
+	renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+	renderPassCreateInfo.pDependencies = dependencies.data();
+
+	FT_VK_CALL(vkCreateRenderPass(inDevice, &renderPassCreateInfo, nullptr, &outRenderPass));
+}
+
+static void CreateRenderTarget(const Device* inDevice, const VkRenderPass inRenderPass, const VkFormat inFormat, const VkExtent2D inExtent, VkImage& outImage, MemoryAllocation& outAllocation, VkImageView& outImageView, VkFramebuffer& outFramebuffer)
+{
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.extent.width = inExtent.width;
+	imageCreateInfo.extent.height = inExtent.height;
+	imageCreateInfo.extent.depth = 1;
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.format = inFormat;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	FT_VK_CALL(vkCreateImage(inDevice->GetDevice(), &imageCreateInfo, nullptr, &outImage));
+
+	VkMemoryRequirements memRequirements;
+	vkGetImageMemoryRequirements(inDevice->GetDevice(), outImage, &memRequirements);
+
+	outAllocation = inDevice->GetMemoryAllocator()->Allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryResourceKind::Optimal);
+
+	FT_VK_CALL(vkBindImageMemory(inDevice->GetDevice(), outImage, outAllocation.Memory, outAllocation.Offset));
+
+	VkImageViewCreateInfo imageViewCreateInfo{};
+	imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.image = outImage;
+	imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	imageViewCreateInfo.format = inFormat;
+	imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+	imageViewCreateInfo.subresourceRange.levelCount = 1;
+	imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+	imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+	FT_VK_CALL(vkCreateImageView(inDevice->GetDevice(), &imageViewCreateInfo, nullptr, &outImageView));
+
+	VkFramebufferCreateInfo framebufferCreateInfo{};
+	framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.renderPass = inRenderPass;
+	framebufferCreateInfo.attachmentCount = 1;
+	framebufferCreateInfo.pAttachments = &outImageView;
+	framebufferCreateInfo.width = inExtent.width;
+	framebufferCreateInfo.height = inExtent.height;
+	framebufferCreateInfo.layers = 1;
+
+	FT_VK_CALL(vkCreateFramebuffer(inDevice->GetDevice(), &framebufferCreateInfo, nullptr, &outFramebuffer));
+}
+
+static void CreateSampler(const VkDevice inDevice, VkSampler& outSampler)
+{
+	// Pixels are compared one to one, filtering would blur the error image.
+	VkSamplerCreateInfo samplerCreateInfo{};
+	samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerCreateInfo.magFilter = VK_FILTER_NEAREST;
+	samplerCreateInfo.minFilter = VK_FILTER_NEAREST;
+	samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.maxLod = 0.0f;
+	samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+
+	FT_VK_CALL(vkCreateSampler(inDevice, &samplerCreateInfo, nullptr, &outSampler));
+}
+
+static void CreateDescriptorSet(const VkDevice inDevice, const VkSampler inSampler, const VkImageView inReferenceImageView, const VkImageView inRelaxedImageView,
+	VkDescriptorSetLayout& outDescriptorSetLayout, VkDescriptorPool& outDescriptorPool, VkDescriptorSet& outDescriptorSet)
+{
+	std::array<VkDescriptorSetLayoutBinding, 2> layoutBindings{};
+	for (uint32_t bindingIndex = 0; bindingIndex < layoutBindings.size(); ++bindingIndex)
+	{
+		layoutBindings[bindingIndex].binding = bindingIndex;
+		layoutBindings[bindingIndex].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		layoutBindings[bindingIndex].descriptorCount = 1;
+		layoutBindings[bindingIndex].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	}
+
+	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
+	descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	descriptorSetLayoutCreateInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+	descriptorSetLayoutCreateInfo.pBindings = layoutBindings.data();
+
+	FT_VK_CALL(vkCreateDescriptorSetLayout(inDevice, &descriptorSetLayoutCreateInfo, nullptr, &outDescriptorSetLayout));
+
+	VkDescriptorPoolSize poolSize{};
+	poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSize.descriptorCount = static_cast<uint32_t>(layoutBindings.size());
+
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	poolInfo.maxSets = 1;
+
+	FT_VK_CALL(vkCreateDescriptorPool(inDevice, &poolInfo, nullptr, &outDescriptorPool));
+
+	VkDescriptorSetAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocateInfo.descriptorPool = outDescriptorPool;
+	allocateInfo.descriptorSetCount = 1;
+	allocateInfo.pSetLayouts = &outDescriptorSetLayout;
+
+	FT_VK_CALL(vkAllocateDescriptorSets(inDevice, &allocateInfo, &outDescriptorSet));
+
+	// Images are written once per frame before they are sampled, so a single set serves every frame.
+	std::array<VkDescriptorImageInfo, 2> imageInfos{};
+	imageInfos[0].sampler = inSampler;
+	imageInfos[0].imageView = inReferenceImageView;
+	imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfos[1].sampler = inSampler;
+	imageInfos[1].imageView = inRelaxedImageView;
+	imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+	for (uint32_t bindingIndex = 0; bindingIndex < descriptorWrites.size(); ++bindingIndex)
+	{
+		descriptorWrites[bindingIndex].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[bindingIndex].dstSet = outDescriptorSet;
+		descriptorWrites[bindingIndex].dstBinding = bindingIndex;
+		descriptorWrites[bindingIndex].dstArrayElement = 0;
+		descriptorWrites[bindingIndex].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrites[bindingIndex].descriptorCount = 1;
+		descriptorWrites[bindingIndex].pImageInfo = &imageInfos[bindingIndex];
+	}
+
+	vkUpdateDescriptorSets(inDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+static void DestroyRenderTarget(const Device* inDevice, const VkImage inImage, const MemoryAllocation& inAllocation, const VkImageView inImageView, const VkFramebuffer inFramebuffer)
+{
+	vkDestroyFramebuffer(inDevice->GetDevice(), inFramebuffer, nullptr);
+	vkDestroyImageView(inDevice->GetDevice(), inImageView, nullptr);
+	vkDestroyImage(inDevice->GetDevice(), inImage, nullptr);
+	inDevice->GetMemoryAllocator()->Free(inAllocation);
+}
+
+PrecisionComparison::PrecisionComparison(const Device* inDevice, const Swapchain* inSwapchain, const Shader* inVertexShader)
+	: m_Device(inDevice)
+	, m_Extent(inSwapchain->GetExtent())
+	, m_QueryPool(VK_NULL_HANDLE)
+	, m_QueriesWritten(inSwapchain->GetImageCount(), false)
+	, m_HasTimings(false)
+	, m_ReferenceTime(0.0)
+	, m_RelaxedTime(0.0)
+{
+	const VkDevice device = m_Device->GetDevice();
+
+	CreateRenderPass(device, inSwapchain->GetFormat(), m_RenderPass);
+	CreateRenderTarget(m_Device, m_RenderPass, inSwapchain->GetFormat(), m_Extent, m_ReferenceTarget.Image, m_ReferenceTarget.Memory, m_ReferenceTarget.ImageView, m_ReferenceTarget.Framebuffer);
+	CreateRenderTarget(m_Device, m_RenderPass, inSwapchain->GetFormat(), m_Extent, m_RelaxedTarget.Image, m_RelaxedTarget.Memory, m_RelaxedTarget.ImageView, m_RelaxedTarget.Framebuffer);
+	CreateSampler(device, m_Sampler);
+	CreateDescriptorSet(device, m_Sampler, m_ReferenceTarget.ImageView, m_RelaxedTarget.ImageView, m_DescriptorSetLayout, m_DescriptorPool, m_DescriptorSet);
+
+	const ShaderCompileResult compileResult = ShaderCompiler::Compile(ShaderLanguage::GLSL, ShaderStage::Fragment, ViewFragmentShader);
+	FT_CHECK(compileResult.Status == ShaderCompileStatus::Success, "Failed %s precision comparison shader.", ShaderCompiler::GetStatusText(compileResult.Status));
+
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(ViewParameters);
+
+	m_ViewShader = new Shader(m_Device, ShaderStage::Fragment, compileResult.SpvCode);
+	m_ViewPipeline = new Pipeline(m_Device, inSwapchain, m_DescriptorSetLayout, { pushConstantRange }, inVertexShader, m_ViewShader);
+
+	if (m_Device->AreTimestampsSupported())
+	{
+		VkQueryPoolCreateInfo queryPoolCreateInfo{};
+		queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolCreateInfo.queryCount = QueriesPerFrame * inSwapchain->GetImageCount();
+
+		FT_VK_CALL(vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &m_QueryPool));
+	}
+}
+
+PrecisionComparison::~PrecisionComparison()
+{
+	const VkDevice device = m_Device->GetDevice();
+
+	if (m_QueryPool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(device, m_QueryPool, nullptr);
+	}
+
+	delete(m_ViewPipeline);
+	delete(m_ViewShader);
+
+	vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+	vkDestroySampler(device, m_Sampler, nullptr);
+
+	DestroyRenderTarget(m_Device, m_RelaxedTarget.Image, m_RelaxedTarget.Memory, m_RelaxedTarget.ImageView, m_RelaxedTarget.Framebuffer);
+	DestroyRenderTarget(m_Device, m_ReferenceTarget.Image, m_ReferenceTarget.Memory, m_ReferenceTarget.ImageView, m_ReferenceTarget.Framebuffer);
+
+	vkDestroyRenderPass(device, m_RenderPass, nullptr);
+}
+
+void PrecisionComparison::RenderVariants(CommandBuffer* inCommandBuffer, const Pipeline* inReferencePipeline, const Pipeline* inRelaxedPipeline, const DescriptorSet* inDescriptorSet,
+	const std::vector<unsigned char>& inPushConstants)
+{
+	const uint32_t imageIndex = inCommandBuffer->GetCurrentIndex();
+	const VkCommandBuffer commandBuffer = inCommandBuffer->GetCommandBuffer(imageIndex);
+	const uint32_t firstQuery = QueriesPerFrame * imageIndex;
+
+	if (m_QueryPool != VK_NULL_HANDLE)
+	{
+		ReadTimings(imageIndex);
+		vkCmdResetQueryPool(commandBuffer, m_QueryPool, firstQuery, QueriesPerFrame);
+	}
+
+	const Pipeline* pipelines[] = { inReferencePipeline, inRelaxedPipeline };
+	const VkFramebuffer framebuffers[] = { m_ReferenceTarget.Framebuffer, m_RelaxedTarget.Framebuffer };
+
+	for (uint32_t variantIndex = 0; variantIndex < 2; ++variantIndex)
+	{
+		if (m_QueryPool != VK_NULL_HANDLE)
+		{
+			// Variants would otherwise overlap on the GPU and their timings would include each other.
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_QueryPool, firstQuery + 2 * variantIndex);
+		}
+
+		inCommandBuffer->BeginRenderPass(m_RenderPass, framebuffers[variantIndex], m_Extent);
+		inCommandBuffer->BindPipeline(pipelines[variantIndex]);
+		inCommandBuffer->BindDescriptorSets(inDescriptorSet);
+		if (!inPushConstants.empty())
+		{
+			inCommandBuffer->PushConstants(VK_SHADER_STAGE_FRAGMENT_BIT, static_cast<uint32_t>(inPushConstants.size()), inPushConstants.data());
+		}
+		inCommandBuffer->Draw();
+		inCommandBuffer->EndRenderPass();
+
+		if (m_QueryPool != VK_NULL_HANDLE)
+		{
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_QueryPool, firstQuery + 2 * variantIndex + 1);
+		}
+	}
+
+	m_QueriesWritten[imageIndex] = m_QueryPool != VK_NULL_HANDLE;
+}
+
+void PrecisionComparison::DrawView(CommandBuffer* inCommandBuffer, const PrecisionView inView, const float inErrorScale) const
+{
+	const VkCommandBuffer commandBuffer = inCommandBuffer->GetCommandBuffer(inCommandBuffer->GetCurrentIndex());
+
+	ViewParameters viewParameters;
+	viewParameters.View = static_cast<uint32_t>(inView);
+	viewParameters.ErrorScale = inErrorScale;
+
+	inCommandBuffer->BindPipeline(m_ViewPipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_ViewPipeline->GetPipelineLayout(), 0, 1, &m_DescriptorSet, 0, nullptr);
+	inCommandBuffer->PushConstants(VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(ViewParameters), &viewParameters);
+	inCommandBuffer->Draw();
+}
+
+void PrecisionComparison::ReadTimings(const uint32_t inImageIndex)
+{
+	if (!m_QueriesWritten[inImageIndex])
+	{
+		return;
+	}
+
+	// Results are read without waiting, a frame whose queries aren't available yet is simply skipped.
+	uint64_t timestamps[QueriesPerFrame];
+	const VkResult result = vkGetQueryPoolResults(m_Device->GetDevice(), m_QueryPool, QueriesPerFrame * inImageIndex, QueriesPerFrame,
+		sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS)
+	{
+		return;
+	}
+
+	const uint32_t validBits = m_Device->GetTimestampValidBits();
+	const double nanosecondsPerTick = static_cast<double>(m_Device->GetTimestampPeriod());
+	const double referenceTime = static_cast<double>(GetTimestampDelta(timestamps[0], timestamps[1], validBits)) * nanosecondsPerTick / 1000000.0;
+	const double relaxedTime = static_cast<double>(GetTimestampDelta(timestamps[2], timestamps[3], validBits)) * nanosecondsPerTick / 1000000.0;
+
+	m_ReferenceTime = m_HasTimings ? m_ReferenceTime + TimingSmoothing * (referenceTime - m_ReferenceTime) : referenceTime;
+	m_RelaxedTime = m_HasTimings ? m_RelaxedTime + TimingSmoothing * (relaxedTime - m_RelaxedTime) : relaxedTime;
+	m_HasTimings = true;
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+
+FT_BEGIN_NAMESPACE
+
+enum class PrecisionView : uint8_t
+{
+	Reference,
+	Relaxed,
+	Error,
+
+	Count
+};
+
+class Device;
+class Swapchain;
+class Shader;
+class Pipeline;
+class DescriptorSet;
+class CommandBuffer;
+
+// Renders the full precision and the relaxed precision fragment shader into their own images, measures both on the GPU
+// and shows either of them or their per-pixel difference. Targets match the swapchain, so it's recreated along with it.
+class PrecisionComparison
+{
+public:
+	PrecisionComparison(const Device* inDevice, const Swapchain* inSwapchain, const Shader* inVertexShader);
+	~PrecisionComparison();
+	FT_DELETE_COPY_AND_MOVE(PrecisionComparison)
+
+public:
+	void RenderVariants(CommandBuffer* inCommandBuffer, const Pipeline* inReferencePipeline, const Pipeline* inRelaxedPipeline, const DescriptorSet* inDescriptorSet,
+		const std::vector<unsigned char>& inPushConstants);
+	void DrawView(CommandBuffer* inCommandBuffer, const PrecisionView inView, const float inErrorScale) const;
+
+public:
+	bool HasTimings() const { return m_HasTimings; }
+	double GetReferenceTime() const { return m_ReferenceTime; }
+	double GetRelaxedTime() const { return m_RelaxedTime; }
+
+private:
+	void ReadTimings(const uint32_t inImageIndex);
+
+private:
+	struct RenderTarget
+	{
+		VkImage Image = VK_NULL_HANDLE;
+		MemoryAllocation Memory;
+		VkImageView ImageView = VK_NULL_HANDLE;
+		VkFramebuffer Framebuffer = VK_NULL_HANDLE;
+	};
+
+	const Device* m_Device;
+	VkExtent2D m_Extent;
+	VkRenderPass m_RenderPass;
+	RenderTarget m_ReferenceTarget;
+	RenderTarget m_RelaxedTarget;
+	VkSampler m_Sampler;
+	VkDescriptorSetLayout m_DescriptorSetLayout;
+	VkDescriptorPool m_DescriptorPool;
+	VkDescriptorSet m_DescriptorSet;
+	Shader* m_ViewShader;
+	Pipeline* m_ViewPipeline;
+	VkQueryPool m_QueryPool;
+	std::vector<bool> m_QueriesWritten;
+	bool m_HasTimings;
+	double m_ReferenceTime;
+	double m_RelaxedTime;
+};
+
+FT_END_NAMESPACE
@@ -7,6 +7,8 @@
 #include "Sampler.h"
 #include "CombinedImageSampler.h"
 #include "UniformBuffer.h"
+#include "StorageBuffer.h"
+#include "TextureArray.h"
 #include "Binding.hpp"
 #include "Resource.hpp"
 #include "Shader.h"
@@ -14,17 +16,161 @@
 #include "DescriptorSet.h"
 #include "CommandBuffer.h"
 #include "ResourceContainer.h"
+#include "PrecisionComparison.h"
+#include "PipelineBuilder.h"
+#include "PipelineBundleCache.h"
 #include "Compiler/ShaderCompiler.h"
+#include "Compiler/ShaderCompileClient.h"
+#include "Compiler/ShaderVariantCompiler.h"
 #include "Utility/ShaderFile.h"
 #include "Utility/DefaultShader.h"
+#include "Utility/Hash.hpp"
 
 FT_BEGIN_NAMESPACE
 
+static const uint64_t InvalidShaderVariantHash = 0;
+
+static rapidjson::Value SerializeSpecializationValue(const SpecializationConstant& inSpecializationConstant, rapidjson::Document::AllocatorType& inAllocator)
+{
+	rapidjson::Value valueJson;
+
+	switch (inSpecializationConstant.Type)
+	{
+	case SpecializationConstantType::Bool:
+		valueJson.SetBool(inSpecializationConstant.Value != 0);
+		break;
+
+	case SpecializationConstantType::Int:
+		valueJson.SetInt(static_cast<int32_t>(inSpecializationConstant.Value));
+		break;
+
+	case SpecializationConstantType::UInt:
+		valueJson.SetUint(inSpecializationConstant.Value);
+		break;
+
+	case SpecializationConstantType::Float:
+	{
+		float value = 0.0f;
+		memcpy(&value, &inSpecializationConstant.Value, sizeof(float));
+		valueJson.SetFloat(value);
+		break;
+	}
+
+	default:
+		FT_FAIL("Unsupported SpecializationConstantType.");
+	}
+
+	return valueJson;
+}
+
+static bool DeserializeSpecializationValue(const int inType, const rapidjson::Value& inValueJson, SpecializationConstant& outSpecializationConstant)
+{
+	if (inType < 0 || inType >= static_cast<int>(SpecializationConstantType::Count))
+	{
+		return false;
+	}
+
+	outSpecializationConstant.Type = static_cast<SpecializationConstantType>(inType);
+
+	switch (outSpecializationConstant.Type)
+	{
+	case SpecializationConstantType::Bool:
+		if (!inValueJson.IsBool())
+		{
+			return false;
+		}
+		outSpecializationConstant.Value = inValueJson.GetBool() ? 1 : 0;
+		return true;
+
+	case SpecializationConstantType::Int:
+		if (!inValueJson.IsInt())
+		{
+			return false;
+		}
+		outSpecializationConstant.Value = static_cast<uint32_t>(inValueJson.GetInt());
+		return true;
+
+	case SpecializationConstantType::UInt:
+		if (!inValueJson.IsUint())
+		{
+			return false;
+		}
+		outSpecializationConstant.Value = inValueJson.GetUint();
+		return true;
+
+	case SpecializationConstantType::Float:
+	{
+		if (!inValueJson.IsNumber())
+		{
+			return false;
+		}
+		const float value = inValueJson.GetFloat();
+		memcpy(&outSpecializationConstant.Value, &value, sizeof(float));
+		return true;
+	}
+
+	default:
+		return false;
+	}
+}
+
+static uint64_t HashSpvCode(const std::vector<uint32_t>& inSpvCode)
+{
+	return HashBytes(inSpvCode.data(), sizeof(uint32_t) * inSpvCode.size());
+}
+
+// Covers everything the descriptor set, the pipeline layout and the resources are created from, shaders with the same hash can share them.
+static uint64_t HashPipelineLayout(const Shader* inShader)
+{
+	const std::vector<Binding>& bindings = inShader->GetBindings();
+
+	uint64_t hash = HashValue(bindings.size());
+	hash = HashValue(inShader->GetPushConstantSize(), hash);
+	for (const Binding& binding : bindings)
+	{
+		const char* name = binding.ReflectDescriptorBinding.name;
+
+		hash = HashValue(binding.ReflectDescriptorBinding.set, hash);
+		hash = HashValue(binding.DescriptorSetBinding.binding, hash);
+		hash = HashValue(binding.DescriptorSetBinding.descriptorType, hash);
+		hash = HashValue(binding.DescriptorSetBinding.descriptorCount, hash);
+		hash = HashValue(binding.DescriptorSetBinding.stageFlags, hash);
+		hash = HashValue(binding.ReflectDescriptorBinding.count, hash);
+		hash = HashValue(binding.ReflectDescriptorBinding.block.padded_size, hash);
+		hash = HashString(name ? name : "", hash);
+	}
+
+	return hash;
+}
+
 Renderer::Renderer(Window* inWindow, ShaderFile* inFragmentShaderFile)
 	: m_Window(inWindow)
 	, m_FragmentShaderFile(inFragmentShaderFile)
+	, m_PrecisionComparison(nullptr)
+	, m_RelaxedPipeline(nullptr)
+	, m_RelaxedPipelineBuildPending(false)
+	, m_PrecisionView(PrecisionView::Error)
+	, m_PrecisionErrorScale(16.0f)
+	, m_PipelineBuildPending(false)
+	, m_MetaDataSavePending(false)
+	, m_PipelineOptimizationPending(false)
+	, m_PendingPipelineBundleKey(0)
+	, m_PendingFragmentShader(nullptr)
+	, m_PendingDescriptorSet(nullptr)
+	, m_VariantPrebuildState(0)
+	, m_FrameIndex(0)
 {
 	m_Device = new Device(m_Window);
+
+	// Shaders the device can't create fail to compile, so the previous shader keeps running instead.
+	ShaderDeviceLimits deviceLimits;
+	deviceLimits.MaxPushConstantsSize = m_Device->GetMaxPushConstantsSize();
+	deviceLimits.DescriptorIndexingSupported = m_Device->IsDescriptorIndexingSupported();
+	ShaderCompiler::SetDeviceLimits(deviceLimits);
+	m_PipelineBuilder = new PipelineBuilder(m_Device);
+	m_RelaxedPipelineBuilder = new PipelineBuilder(m_Device);
+	m_VariantPipelineBuilder = new PipelineBuilder(m_Device);
+	m_PipelineBundleCache = new PipelineBundleCache(0);
 	m_Swapchain = new Swapchain(m_Device, m_Window);
 
 	{
@@ -36,8 +182,18 @@ Renderer::Renderer(Window* inWindow, ShaderFile* inFragmentShaderFile)
 		m_VertexShader = new Shader(m_Device, ShaderStage::Vertex, compileResult.SpvCode);
 	}
 
+	m_PipelineLibrary = m_Device->IsGraphicsPipelineLibrarySupported() ? new PipelineLibrary(m_Device, m_Swapchain, m_VertexShader) : nullptr;
+
 	{
-		ShaderCompileResult compileResult = ShaderCompiler::Compile(m_FragmentShaderFile->GetLanguage(), ShaderStage::Fragment, m_FragmentShaderFile->GetSourceCode());
+		ShaderCompileOptions compileOptions;
+		compileOptions.SourcePath = m_FragmentShaderFile->GetPath();
+		compileOptions.OptimizationLevel = m_FragmentShaderFile->GetOptimizationLevel();
+		compileOptions.Defines = ShaderVariants::GetPermutationDefines(m_FragmentShaderFile->GetVariantDefines(),
+			ShaderVariants::GetSelectedPermutation(m_FragmentShaderFile->GetVariantDefines()));
+
+		ShaderCompileResult compileResult = m_FragmentShaderFile->IsPrecompiled() ?
+			ShaderCompiler::LoadPrecompiled(ShaderStage::Fragment, m_FragmentShaderFile->GetSpvCode()) :
+			ShaderCompileClient::Compile(m_FragmentShaderFile->GetLanguage(), ShaderStage::Fragment, m_FragmentShaderFile->GetSourceCode(), compileOptions);
 		const char* status = ShaderCompiler::GetStatusText(compileResult.Status);
 		if (!compileResult.InfoLog.empty())
 		{
@@ -46,30 +202,53 @@ Renderer::Renderer(Window* inWindow, ShaderFile* inFragmentShaderFile)
 
 		if (compileResult.Status != ShaderCompileStatus::Success)
 		{
-			compileResult = ShaderCompiler::Compile(m_FragmentShaderFile->GetLanguage(), ShaderStage::Fragment, GetDefaultFragmentShader(m_FragmentShaderFile->GetLanguage()));
+			// There's no default SPIR-V shader, the GLSL one is used for precompiled shaders.
+			const ShaderLanguage defaultShaderLanguage = m_FragmentShaderFile->IsPrecompiled() ? ShaderLanguage::GLSL : m_FragmentShaderFile->GetLanguage();
+			compileResult = ShaderCompiler::Compile(defaultShaderLanguage, ShaderStage::Fragment, GetDefaultFragmentShader(defaultShaderLanguage));
 			FT_LOG("Failed %s fragment shader %s, default shader will be used instead.\n", status, m_FragmentShaderFile->GetName().c_str());
 
 		}
 
 		m_FragmentShader = new Shader(m_Device, ShaderStage::Fragment, compileResult.SpvCode);
+		m_FragmentShaderHash = HashSpvCode(compileResult.SpvCode);
+		m_PipelineLayoutHash = HashPipelineLayout(m_FragmentShader);
+		m_PipelineBundleKey = GetPipelineBundleKey(m_FragmentShaderHash);
+		UpdatePushConstantMemory();
 	}
 
 	m_ResourceContainer = new ResourceContainer(m_Device, m_Swapchain);
 	m_ResourceContainer->UpdateBindings(m_FragmentShader->GetBindings());
 
 	m_DescriptorSet = new DescriptorSet(m_Device, m_Swapchain, m_ResourceContainer->GetDescriptors());
-	m_Pipeline = new Pipeline(m_Device, m_Swapchain, m_DescriptorSet, m_VertexShader, m_FragmentShader);
+
+	const auto pipelineStartTime = std::chrono::high_resolution_clock::now();
+	m_Pipeline = new Pipeline(m_Device, m_Swapchain, m_DescriptorSet, m_VertexShader, m_FragmentShader, GetShaderSpecializationConstants(m_FragmentShader), nullptr);
+	const auto pipelineEndTime = std::chrono::high_resolution_clock::now();
+	FT_LOG("Startup pipeline created in %.2f ms.\n", std::chrono::duration<double, std::milli>(pipelineEndTime - pipelineStartTime).count());
+
 	m_CommandBuffer = new CommandBuffer(m_Device, m_Swapchain);
 }
 
 Renderer::~Renderer()
 {
+	FinishPipelineBuilds();
+	m_VariantPipelineBuilder->Cancel();
+	m_VariantPipelineBuilder->WaitIdle();
+	delete(m_PipelineBuilder);
+	delete(m_RelaxedPipelineBuilder);
+	DestroySupersededObjects();
+	delete(m_VariantPipelineBuilder);
+
 	delete(m_FragmentShaderFile);
 	delete(m_FragmentShader);
 	delete(m_VertexShader);
 
+	ClearPipelineBundles();
 	CleanupSwapchain();
+	DestroyRetiredObjects(true);
 
+	delete(m_DescriptorSet);
+	delete(m_PipelineBundleCache);
 	delete(m_ResourceContainer);
 	delete(m_Swapchain);
 	delete(m_Device);
@@ -88,6 +267,13 @@ void Renderer::DrawFrame()
 
 	const uint32_t imageIndex = imageAcquireResult.ImageIndex;
 
+	// Fence of the acquired frame was waited on, so objects retired enough frames ago aren't in use anymore.
+	DestroyRetiredObjects(false);
+	ProcessPipelineBuild();
+
+	// Sets of the acquired image aren't used by any frame in flight, so bindings changed in the meantime are written now.
+	m_DescriptorSet->FlushDescriptorWrites(imageIndex);
+
 	UpdateUniformBuffersDeviceMemory(imageIndex);
 	FillCommandBuffers(imageIndex);
 
@@ -100,6 +286,8 @@ void Renderer::DrawFrame()
 	{
 		FT_CHECK(presentStatus == SwapchainStatus::Success, "Swapchain present failed.");
 	}
+
+	++m_FrameIndex;
 }
 
 void Renderer::WaitDeviceToFinish()
@@ -114,27 +302,162 @@ void Renderer::WaitQueueToFinish()
 
 void Renderer::UpdateFragmentShaderFile(ShaderFile* inFragmentShaderFile)
 {
+	// Deferred save belongs to the previous file, so it's written before the file is replaced.
+	if (m_MetaDataSavePending)
+	{
+		WaitPipelineBuild();
+	}
+
 	delete(m_FragmentShaderFile);
 	m_FragmentShaderFile = inFragmentShaderFile;
+
+	// Overridden values belong to the previous shader, the new one starts from its own defaults.
+	m_SpecializationValues.clear();
+
+	// Even an identical module has to be specialized again, without the overridden values.
+	m_FragmentShaderHash = InvalidShaderVariantHash;
 }
 
-void Renderer::OnFragmentShaderRecompiled(const std::vector<uint32_t>& inSpvCode)
+ShaderRebuild Renderer::OnFragmentShaderRecompiled(const std::vector<uint32_t>& inSpvCode)
 {
-	WaitQueueToFinish();
+	// Edits which don't change the module, like comments or unused code, don't touch anything. Variants are compiled
+	// again either way and replace the current ones once they are done.
+	const Shader* fragmentShader = m_PendingFragmentShader ? m_PendingFragmentShader : m_FragmentShader;
+	if (HashSpvCode(inSpvCode) == m_FragmentShaderHash && inSpvCode == fragmentShader->GetSpvCode())
+	{
+		++m_ShaderRebuildStatistics.Unchanged;
+		return ShaderRebuild::None;
+	}
 
-	delete(m_FragmentShader);
-	m_FragmentShader = new Shader(m_Device, ShaderStage::Fragment, inSpvCode);
+	// Variants were compiled from the previous source code, new ones are handed over once they are compiled.
+	ClearShaderVariants();
 
-	m_ResourceContainer->UpdateBindings(m_FragmentShader->GetBindings());
+	const ShaderRebuild shaderRebuild = ApplyFragmentShader(inSpvCode);
+	if (shaderRebuild == ShaderRebuild::Restored)
+	{
+		++m_ShaderRebuildStatistics.Restored;
+	}
+	else if (shaderRebuild == ShaderRebuild::Pipeline)
+	{
+		++m_ShaderRebuildStatistics.PipelineRebuilds;
+	}
+	else
+	{
+		++m_ShaderRebuildStatistics.FullRebuilds;
+	}
 
-	RecreateDescriptorSet();
+	return shaderRebuild;
+}
 
-	delete(m_Pipeline);
-	m_Pipeline = new Pipeline(m_Device, m_Swapchain, m_DescriptorSet, m_VertexShader, m_FragmentShader);
+void Renderer::UpdateShaderVariants(const std::vector<ShaderVariantResult>& inVariantResults)
+{
+	ClearShaderVariants();
+
+	m_ShaderVariantHashes.resize(inVariantResults.size(), InvalidShaderVariantHash);
+	for (const ShaderVariantResult& variantResult : inVariantResults)
+	{
+		if (variantResult.CompileResult.Status != ShaderCompileStatus::Success)
+		{
+			continue;
+		}
+
+		// Defines which don't affect the generated code end up with the same module, which is kept only once.
+		const uint64_t spvHash = HashSpvCode(variantResult.CompileResult.SpvCode);
+		m_ShaderVariantHashes[variantResult.PermutationIndex] = spvHash;
+
+		std::vector<uint32_t>& spvCode = m_ShaderVariants[spvHash];
+		if (spvCode.empty())
+		{
+			spvCode = variantResult.CompileResult.SpvCode;
+		}
+	}
+
+	PrebuildShaderVariants();
+}
+
+bool Renderer::SelectShaderVariant(const uint32_t inPermutationIndex)
+{
+	if (inPermutationIndex >= m_ShaderVariantHashes.size() || m_ShaderVariantHashes[inPermutationIndex] == InvalidShaderVariantHash)
+	{
+		return false;
+	}
+
+	const uint64_t spvHash = m_ShaderVariantHashes[inPermutationIndex];
+	if (spvHash == m_FragmentShaderHash)
+	{
+		return true;
+	}
+
+	// Variant is applied like any other edit, so a prebuilt one is restored from the cache right away. Variants whose
+	// prebuild didn't finish yet, or which change the pipeline layout, are built while the active pipeline keeps rendering.
+	ApplyFragmentShader(m_ShaderVariants[spvHash]);
+
+	return true;
+}
+
+void Renderer::ClearShaderVariants()
+{
+	m_ShaderVariants.clear();
+	m_ShaderVariantHashes.clear();
+
+	m_VariantPipelineBuilder->Cancel();
+	m_VariantPrebuildState = 0;
+
+	// Bundles of the old variants stay cached, but they are evicted like any other once they aren't pinned.
+	std::vector<PipelineBundle> evictedBundles;
+	m_PipelineBundleCache->SetPinnedKeys(std::set<uint64_t>(), evictedBundles);
+	RetirePipelineBundles(evictedBundles);
+}
+
+void Renderer::PrebuildShaderVariants()
+{
+	// Prebuilds of the same layout and specialization values are either queued or done already.
+	const uint64_t prebuildState = HashValue(m_PipelineLayoutHash, GetPipelineBundleKey(0));
+	if (m_ShaderVariants.empty() || prebuildState == m_VariantPrebuildState)
+	{
+		return;
+	}
+
+	m_VariantPipelineBuilder->Cancel();
+	m_VariantPrebuildState = prebuildState;
+
+	const uint64_t activePipelineBundleKey = m_PipelineBuildPending ? m_PendingPipelineBundleKey : m_PipelineBundleKey;
+	const DescriptorSet* descriptorSet = m_PendingDescriptorSet ? m_PendingDescriptorSet : m_DescriptorSet;
+
+	std::set<uint64_t> variantBundleKeys;
+	for (const auto& variantIterator : m_ShaderVariants)
+	{
+		const uint64_t variantBundleKey = GetPipelineBundleKey(variantIterator.first);
+		variantBundleKeys.insert(variantBundleKey);
+		if (variantBundleKey == activePipelineBundleKey || m_PipelineBundleCache->Contains(variantBundleKey))
+		{
+			continue;
+		}
+
+		// Descriptor sets are created along with the resources of their bindings, so variants which change the layout
+		// can't be built up front and are built once they are selected instead.
+		Shader* fragmentShader = new Shader(m_Device, ShaderStage::Fragment, variantIterator.second);
+		if (HashPipelineLayout(fragmentShader) != m_PipelineLayoutHash)
+		{
+			delete(fragmentShader);
+			continue;
+		}
+
+		m_VariantPipelineBuilder->QueuePrebuild(variantBundleKey, m_Swapchain, descriptorSet, m_VertexShader, fragmentShader,
+			GetShaderSpecializationConstants(fragmentShader));
+	}
+
+	// Every variant stays cached regardless of the bundle limit, which only bounds bundles of edits.
+	std::vector<PipelineBundle> evictedBundles;
+	m_PipelineBundleCache->SetPinnedKeys(variantBundleKeys, evictedBundles);
+	RetirePipelineBundles(evictedBundles);
 }
 
 bool Renderer::TryApplyMetaData()
 {
+	// Meta data belongs to the latest shader, so its pipeline has to be published first.
+	FinishPipelineBuilds();
+
 	std::string metaDataFilePath = m_FragmentShaderFile->GetPath() + ".meta";
 	std::string metaDataJson = ReadFile(metaDataFilePath);
 	
@@ -152,6 +475,17 @@ bool Renderer::TryApplyMetaData()
 		return false;
 	}
 
+	// Optional, since it was added after the rest of the meta data.
+	if (documentJson.HasMember("SpecializationConstants") && ApplySpecializationConstantsMetaData(documentJson["SpecializationConstants"]))
+	{
+		RecreateSpecializedPipelines();
+	}
+
+	if (documentJson.HasMember("PushConstants"))
+	{
+		ApplyPushConstantsMetaData(documentJson["PushConstants"]);
+	}
+
 	const rapidjson::Value& descriptorsJson = documentJson["Descriptors"];
 	if (!descriptorsJson.IsArray())
 	{
@@ -159,8 +493,7 @@ bool Renderer::TryApplyMetaData()
 		return false;
 	}
 
-	WaitQueueToFinish();
-
+	// Replaced resources are retired, so frames in flight keep sampling them until they finish.
 	uint32_t descriptorIndex = 0;
 	for (const auto& descriptorJson : descriptorsJson.GetArray())
 	{
@@ -198,8 +531,8 @@ bool Renderer::TryApplyMetaData()
 			}
 
 			// TODO: Validate ImagePath and Sampler.
-			m_ResourceContainer->UpdateImage(descriptorIndex, imagePath);
-			m_ResourceContainer->UpdateSampler(descriptorIndex, samplerInfo);
+			RetireResources(m_ResourceContainer->UpdateImage(descriptorIndex, imagePath));
+			RetireResources(m_ResourceContainer->UpdateSampler(descriptorIndex, samplerInfo));
 			break;
 		}
 
@@ -213,7 +546,7 @@ bool Renderer::TryApplyMetaData()
 			}
 
 			// TODO: Validate ImagePath.
-			m_ResourceContainer->UpdateImage(descriptorIndex, imagePath);
+			RetireResources(m_ResourceContainer->UpdateImage(descriptorIndex, imagePath));
 			break;
 		}
 
@@ -227,7 +560,7 @@ bool Renderer::TryApplyMetaData()
 			}
 
 			// TODO: Validate Sampler.
-			m_ResourceContainer->UpdateSampler(descriptorIndex, samplerInfo);
+			RetireResources(m_ResourceContainer->UpdateSampler(descriptorIndex, samplerInfo));
 			break;
 		}
 
@@ -246,25 +579,109 @@ bool Renderer::TryApplyMetaData()
 			break;
 		}
 
+		case ResourceType::StorageBuffer:
+		{
+			std::string dataPath;
+			if (!DeserializeStorageBuffer(resourceJson, dataPath))
+			{
+				FT_LOG("Failed deserializing StorageBuffer from a json file %s.\n", metaDataFilePath.c_str());
+				return false;
+			}
+
+			RetireResources(m_ResourceContainer->UpdateStorageBuffer(descriptorIndex, dataPath));
+			break;
+		}
+
+		case ResourceType::TextureArray:
+		{
+			std::vector<std::string> imagePaths;
+			SamplerInfo samplerInfo;
+			if (!DeserializeTextureArray(resourceJson, imagePaths, samplerInfo))
+			{
+				FT_LOG("Failed deserializing TextureArray from a json file %s.\n", metaDataFilePath.c_str());
+				return false;
+			}
+
+			RetireResources(m_ResourceContainer->UpdateTextureArray(descriptorIndex, imagePaths, samplerInfo));
+			break;
+		}
+
 		default:
 			FT_LOG("Failed parsing ResourceType from a json file %s.\n", metaDataFilePath.c_str());
 			return false;
 		}
 
+		// Meta data only replaces resources, bindings stay the same, so the set is rewritten instead of created again.
+		// Written right away, so descriptors replaced before a malformed entry don't keep pointing at retired resources.
+		m_DescriptorSet->UpdateDescriptor(m_ResourceContainer->GetDescriptors()[descriptorIndex]);
+
 		++descriptorIndex;
 	}
 
-	RecreateDescriptorSet();
-
 	return true;
 }
 
 void Renderer::SaveMetaData()
 {
+	// Push constant layout comes from the shader being built, so the meta data is written once its pipeline is published.
+	// Render loop keeps going in the meantime instead of waiting for the build.
+	if (m_PipelineBuildPending)
+	{
+		m_MetaDataSavePending = true;
+		return;
+	}
+
+	WriteMetaData();
+}
+
+void Renderer::WriteMetaData()
+{
+	m_MetaDataSavePending = false;
+
 	rapidjson::Document documentJson(rapidjson::kObjectType);
 
 	rapidjson::Value descriptorsJson = m_ResourceContainer->Serialize(documentJson.GetAllocator());
 	documentJson.AddMember("Descriptors", descriptorsJson, documentJson.GetAllocator());
+	documentJson.AddMember("OptimizationLevel", static_cast<int>(m_FragmentShaderFile->GetOptimizationLevel()), documentJson.GetAllocator());
+
+	rapidjson::Value variantsJson(rapidjson::kArrayType);
+	for (const ShaderVariantDefine& variantDefine : m_FragmentShaderFile->GetVariantDefines())
+	{
+		rapidjson::Value valuesJson(rapidjson::kArrayType);
+		for (const std::string& value : variantDefine.Values)
+		{
+			rapidjson::Value valueJson(value.c_str(), documentJson.GetAllocator());
+			valuesJson.PushBack(valueJson, documentJson.GetAllocator());
+		}
+
+		rapidjson::Value defineJson(rapidjson::kObjectType);
+		rapidjson::Value nameJson(variantDefine.Name.c_str(), documentJson.GetAllocator());
+		defineJson.AddMember("Name", nameJson, documentJson.GetAllocator());
+		defineJson.AddMember("Values", valuesJson, documentJson.GetAllocator());
+		defineJson.AddMember("Selected", variantDefine.SelectedValue, documentJson.GetAllocator());
+
+		variantsJson.PushBack(defineJson, documentJson.GetAllocator());
+	}
+	documentJson.AddMember("Variants", variantsJson, documentJson.GetAllocator());
+
+	rapidjson::Value specializationConstantsJson(rapidjson::kArrayType);
+	for (const auto& specializationValueIterator : m_SpecializationValues)
+	{
+		const SpecializationConstant& specializationConstant = specializationValueIterator.second;
+
+		rapidjson::Value specializationConstantJson(rapidjson::kObjectType);
+		rapidjson::Value nameJson(specializationConstant.Name.c_str(), documentJson.GetAllocator());
+		specializationConstantJson.AddMember("Id", specializationConstant.ConstantId, documentJson.GetAllocator());
+		specializationConstantJson.AddMember("Name", nameJson, documentJson.GetAllocator());
+		specializationConstantJson.AddMember("Type", static_cast<int>(specializationConstant.Type), documentJson.GetAllocator());
+		specializationConstantJson.AddMember("Value", SerializeSpecializationValue(specializationConstant, documentJson.GetAllocator()), documentJson.GetAllocator());
+
+		specializationConstantsJson.PushBack(specializationConstantJson, documentJson.GetAllocator());
+	}
+	documentJson.AddMember("SpecializationConstants", specializationConstantsJson, documentJson.GetAllocator());
+
+	rapidjson::Value pushConstantsJson = SerializeUniformBuffer(m_PushConstantMemory.size(), m_PushConstantMemory.data(), m_PushConstantVectorState.data(), documentJson.GetAllocator());
+	documentJson.AddMember("PushConstants", pushConstantsJson, documentJson.GetAllocator());
 
 	rapidjson::StringBuffer buffer;
 	rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
@@ -276,20 +693,107 @@ void Renderer::SaveMetaData()
 	WriteFile(metaDataFilePath, metaDataJson);
 }
 
+void Renderer::UpdateSpecializationConstant(const SpecializationConstant& inSpecializationConstant)
+{
+	// Only the value is stored, pipelines are specialized again once the edit is applied.
+	m_SpecializationValues[inSpecializationConstant.ConstantId] = inSpecializationConstant;
+}
+
+void Renderer::ApplySpecializationConstants()
+{
+	// Overridden values are part of the bundle key, so an unchanged key means the pipeline is already specialized with them.
+	const uint64_t pipelineBundleKey = m_PipelineBuildPending ? m_PendingPipelineBundleKey : m_PipelineBundleKey;
+	if (GetPipelineBundleKey(m_FragmentShaderHash) == pipelineBundleKey)
+	{
+		return;
+	}
+
+	RecreateSpecializedPipelines();
+}
+
+void Renderer::ResetSpecializationConstants()
+{
+	m_SpecializationValues.clear();
+	ApplySpecializationConstants();
+}
+
+std::vector<SpecializationConstant> Renderer::GetSpecializationConstants() const
+{
+	return GetShaderSpecializationConstants(m_FragmentShader);
+}
+
+const SpvReflectBlockVariable* Renderer::GetPushConstantBlock() const
+{
+	return m_FragmentShader->GetPushConstantBlock();
+}
+
 void Renderer::UpdateImageDescriptor(const uint32_t inDescriptorIndex, const std::string& inPath)
 {
-	m_ResourceContainer->UpdateImage(inDescriptorIndex, inPath);
+	WaitPipelineBuild();
+
+	// Replaced image might still be sampled by frames in flight, so it's retired instead of waiting for the queue.
+	RetireResources(m_ResourceContainer->UpdateImage(inDescriptorIndex, inPath));
+
+	// Layouts stay the same, so only the sets holding the descriptor are written again instead of recreating all of them.
+	m_DescriptorSet->UpdateDescriptor(m_ResourceContainer->GetDescriptors()[inDescriptorIndex]);
 }
 
 void Renderer::UpdateSamplerDescriptor(const uint32_t inDescriptorIndex, const SamplerInfo& inSamplerInfo)
 {
-	m_ResourceContainer->UpdateSampler(inDescriptorIndex, inSamplerInfo);
+	WaitPipelineBuild();
+
+	RetireResources(m_ResourceContainer->UpdateSampler(inDescriptorIndex, inSamplerInfo));
+	m_DescriptorSet->UpdateDescriptor(m_ResourceContainer->GetDescriptors()[inDescriptorIndex]);
 }
 
-void Renderer::RecreateDescriptorSet()
+void Renderer::UpdateStorageBufferDescriptor(const uint32_t inDescriptorIndex, const std::string& inDataPath)
 {
-	delete(m_DescriptorSet);
-	m_DescriptorSet = new DescriptorSet(m_Device, m_Swapchain, m_ResourceContainer->GetDescriptors());
+	WaitPipelineBuild();
+
+	RetireResources(m_ResourceContainer->UpdateStorageBuffer(inDescriptorIndex, inDataPath));
+	m_DescriptorSet->UpdateDescriptor(m_ResourceContainer->GetDescriptors()[inDescriptorIndex]);
+}
+
+void Renderer::UpdateTextureArrayFolderDescriptor(const uint32_t inDescriptorIndex, const std::string& inFolderPath)
+{
+	WaitPipelineBuild();
+
+	RetireResources(m_ResourceContainer->UpdateTextureArrayFolder(inDescriptorIndex, inFolderPath));
+	m_DescriptorSet->UpdateDescriptor(m_ResourceContainer->GetDescriptors()[inDescriptorIndex]);
+}
+
+void Renderer::UpdateTextureArrayImageDescriptor(const uint32_t inDescriptorIndex, const uint32_t inSlot, const std::string& inPath)
+{
+	WaitPipelineBuild();
+
+	RetireResources(m_ResourceContainer->UpdateTextureArrayImage(inDescriptorIndex, inSlot, inPath));
+	m_DescriptorSet->UpdateDescriptor(m_ResourceContainer->GetDescriptors()[inDescriptorIndex]);
+}
+
+void Renderer::SetPrecisionComparison(const bool inEnabled)
+{
+	if (inEnabled == (m_PrecisionComparison != nullptr))
+	{
+		return;
+	}
+
+	if (!inEnabled)
+	{
+		// Build in flight still finishes, its pipeline is destroyed by the builder.
+		m_RelaxedPipelineBuilder->Cancel();
+		m_RelaxedPipelineBuildPending = false;
+
+		WaitQueueToFinish();
+
+		DestroyRelaxedPipeline();
+		delete(m_PrecisionComparison);
+		m_PrecisionComparison = nullptr;
+
+		return;
+	}
+
+	m_PrecisionComparison = new PrecisionComparison(m_Device, m_Swapchain, m_VertexShader);
+	RecreateRelaxedPipeline();
 }
 
 std::vector<Descriptor> Renderer::GetDescriptors() const
@@ -308,13 +812,462 @@ void Renderer::UpdateUniformBuffersDeviceMemory(uint32_t inCurrentImage)
 	}
 }
 
+ShaderRebuild Renderer::ApplyFragmentShader(const std::vector<uint32_t>& inSpvCode)
+{
+	const uint64_t spvHash = HashSpvCode(inSpvCode);
+	const uint64_t pipelineBundleKey = GetPipelineBundleKey(spvHash);
+
+	// Recently replaced shaders come with their pipeline, so nothing has to be created for them.
+	PipelineBundle pipelineBundle;
+	const bool restored = m_PipelineBundleCache->Take(pipelineBundleKey, pipelineBundle);
+
+	// Nothing frames in flight use is touched here, active objects are rendered until the new pipeline is published.
+	Shader* fragmentShader = restored ? pipelineBundle.FragmentShader : new Shader(m_Device, ShaderStage::Fragment, inSpvCode);
+	m_FragmentShaderHash = spvHash;
+
+	// Descriptors reference reflection data owned by the shader, so they are updated even when resources stay untouched.
+	// Replaced resources might still be read by frames in flight, they are retired along with the active pipeline.
+	const std::vector<Resource> retiredResources = m_ResourceContainer->UpdateBindings(fragmentShader->GetBindings());
+	m_PendingRetiredResources.insert(m_PendingRetiredResources.end(), retiredResources.begin(), retiredResources.end());
+
+	// Same layout keeps the descriptor set, only the pipeline itself is created again.
+	const uint64_t pipelineLayoutHash = HashPipelineLayout(fragmentShader);
+	const bool keepDescriptorSet = pipelineLayoutHash == m_PipelineLayoutHash;
+	m_PipelineLayoutHash = pipelineLayoutHash;
+
+	SetPendingPipelineObjects(fragmentShader, keepDescriptorSet ? nullptr : new DescriptorSet(m_Device, m_Swapchain, m_ResourceContainer->GetDescriptors()), pipelineBundleKey);
+	PrebuildShaderVariants();
+
+	if (restored)
+	{
+		// Build of a previous edit is of no use anymore, the restored pipeline is published right away.
+		m_PipelineBuilder->Cancel();
+		PublishPipeline(pipelineBundle.GraphicsPipeline);
+
+		return ShaderRebuild::Restored;
+	}
+
+	m_PipelineBuilder->Submit(m_Swapchain, m_PendingDescriptorSet ? m_PendingDescriptorSet : m_DescriptorSet,
+		m_VertexShader, m_PendingFragmentShader, GetShaderSpecializationConstants(m_PendingFragmentShader), m_PipelineLibrary);
+
+	return keepDescriptorSet ? ShaderRebuild::Pipeline : ShaderRebuild::Full;
+}
+
+uint64_t Renderer::GetPipelineBundleKey(const uint64_t inSpvHash) const
+{
+	// Overridden values are baked into the pipeline, the same module specialized differently is another pipeline.
+	uint64_t key = inSpvHash;
+	for (const auto& specializationValueIterator : m_SpecializationValues)
+	{
+		key = HashValue(specializationValueIterator.first, key);
+		key = HashValue(specializationValueIterator.second.Type, key);
+		key = HashValue(specializationValueIterator.second.Value, key);
+	}
+
+	return key;
+}
+
+void Renderer::SetPendingPipelineObjects(Shader* inFragmentShader, DescriptorSet* inDescriptorSet, const uint64_t inPipelineBundleKey)
+{
+	// Pending objects of an unfinished build were never rendered with, so they only wait for the builder to let go of them.
+	if (m_PendingFragmentShader)
+	{
+		m_SupersededFragmentShaders.push_back(m_PendingFragmentShader);
+	}
+	m_PendingFragmentShader = inFragmentShader;
+
+	if (inDescriptorSet)
+	{
+		if (m_PendingDescriptorSet)
+		{
+			m_SupersededDescriptorSets.push_back(m_PendingDescriptorSet);
+		}
+		m_PendingDescriptorSet = inDescriptorSet;
+
+		// Queued prebuilds target the replaced descriptor set, they are queued again for the new layout.
+		m_VariantPipelineBuilder->Cancel();
+		m_VariantPrebuildState = 0;
+	}
+
+	// Optimization of the active pipeline is superseded as well, it would be replaced right after anyway.
+	m_PendingPipelineBundleKey = inPipelineBundleKey;
+	m_PipelineBuildPending = true;
+	m_PipelineOptimizationPending = false;
+}
+
+void Renderer::ProcessPipelineBuild()
+{
+	Pipeline* pipeline = nullptr;
+	if ((m_PipelineBuildPending || m_PipelineOptimizationPending) && m_PipelineBuilder->TryGetResult(pipeline))
+	{
+		PublishPipeline(pipeline);
+	}
+
+	// Null when relaxing precision failed, comparison stays paused until the next shader.
+	Pipeline* relaxedPipeline = nullptr;
+	if (m_RelaxedPipelineBuildPending && m_RelaxedPipelineBuilder->TryGetResult(relaxedPipeline))
+	{
+		m_RelaxedPipeline = relaxedPipeline;
+		m_RelaxedPipelineBuildPending = false;
+	}
+
+	uint64_t variantBundleKey = 0;
+	PipelineBundle variantBundle;
+	while (m_VariantPipelineBuilder->TryGetPrebuiltBundle(variantBundleKey, variantBundle))
+	{
+		// Variant might have been selected and built on its own in the meantime, then its prebuilt bundle is of no use.
+		std::vector<PipelineBundle> evictedBundles;
+		if (variantBundleKey == m_PipelineBundleKey || (m_PipelineBuildPending && variantBundleKey == m_PendingPipelineBundleKey))
+		{
+			evictedBundles.push_back(variantBundle);
+		}
+		else
+		{
+			m_PipelineBundleCache->Store(variantBundleKey, variantBundle, evictedBundles);
+		}
+		RetirePipelineBundles(evictedBundles);
+	}
+
+	if (!m_PipelineBuilder->IsBusy())
+	{
+		DestroySupersededObjects();
+	}
+}
+
+void Renderer::WaitPipelineBuild()
+{
+	if (!m_PipelineBuildPending)
+	{
+		return;
+	}
+
+	PublishPipeline(m_PipelineBuilder->WaitResult());
+	DestroySupersededObjects();
+}
+
+void Renderer::SubmitPipelineOptimization()
+{
+	if (!m_Pipeline->IsFastLinked())
+	{
+		return;
+	}
+
+	// Fast linked pipeline is rendered right away, the optimized one replaces it once it's linked.
+	m_PipelineOptimizationPending = true;
+	m_PipelineBuilder->SubmitOptimization(m_DescriptorSet, m_VertexShader, m_FragmentShader, m_PipelineLibrary, m_Pipeline);
+}
+
+void Renderer::FinishPipelineBuilds()
+{
+	WaitPipelineBuild();
+
+	// Optimization links the active pipeline, so it has to be done before anything it's linked from is replaced.
+	if (m_PipelineOptimizationPending)
+	{
+		PublishPipeline(m_PipelineBuilder->WaitResult());
+	}
+}
+
+void Renderer::PublishPipeline(Pipeline* inPipeline)
+{
+	// Frames in flight were recorded with the active objects, so they are retired instead of destroyed.
+	RetiredObjects& retiredObjects = GetRetiredObjects();
+
+	if (!m_PipelineBuildPending)
+	{
+		// Optimized pipeline is linked from the same shader and layouts, so nothing else changes.
+		retiredObjects.Pipelines.push_back(m_Pipeline);
+		m_Pipeline = inPipeline;
+		m_PipelineOptimizationPending = false;
+		return;
+	}
+
+	// Replaced shader and pipeline are kept in the cache instead, which retires them once they are evicted.
+	StorePipelineBundle();
+
+	retiredObjects.Resources.insert(retiredObjects.Resources.end(), m_PendingRetiredResources.begin(), m_PendingRetiredResources.end());
+	m_PendingRetiredResources.clear();
+
+	if (m_PendingDescriptorSet)
+	{
+		retiredObjects.DescriptorSets.push_back(m_DescriptorSet);
+		m_DescriptorSet = m_PendingDescriptorSet;
+		m_PendingDescriptorSet = nullptr;
+	}
+
+	m_Pipeline = inPipeline;
+	m_FragmentShader = m_PendingFragmentShader;
+	m_PipelineBundleKey = m_PendingPipelineBundleKey;
+	m_PendingFragmentShader = nullptr;
+	m_PipelineBuildPending = false;
+
+	UpdatePushConstantMemory();
+	RecreateRelaxedPipeline();
+	SubmitPipelineOptimization();
+
+	if (m_MetaDataSavePending)
+	{
+		WriteMetaData();
+	}
+}
+
+void Renderer::StorePipelineBundle()
+{
+	PipelineBundle pipelineBundle;
+	pipelineBundle.FragmentShader = m_FragmentShader;
+	pipelineBundle.GraphicsPipeline = m_Pipeline;
+
+	std::vector<PipelineBundle> evictedBundles;
+	m_PipelineBundleCache->Store(m_PipelineBundleKey, pipelineBundle, evictedBundles);
+	RetirePipelineBundles(evictedBundles);
+}
+
+void Renderer::RetireResources(const std::vector<Resource>& inResources)
+{
+	RetiredObjects& retiredObjects = GetRetiredObjects();
+	retiredObjects.Resources.insert(retiredObjects.Resources.end(), inResources.begin(), inResources.end());
+}
+
+void Renderer::RetirePipelineBundles(const std::vector<PipelineBundle>& inPipelineBundles)
+{
+	RetiredObjects& retiredObjects = GetRetiredObjects();
+	for (const PipelineBundle& pipelineBundle : inPipelineBundles)
+	{
+		retiredObjects.Pipelines.push_back(pipelineBundle.GraphicsPipeline);
+		retiredObjects.Shaders.push_back(pipelineBundle.FragmentShader);
+	}
+}
+
+void Renderer::ClearPipelineBundles()
+{
+	std::vector<PipelineBundle> evictedBundles;
+	m_PipelineBundleCache->Clear(evictedBundles);
+	RetirePipelineBundles(evictedBundles);
+}
+
+void Renderer::SetMaxPipelineBundleCount(const uint32_t inMaxBundleCount)
+{
+	std::vector<PipelineBundle> evictedBundles;
+	m_PipelineBundleCache->SetMaxBundleCount(inMaxBundleCount, evictedBundles);
+	RetirePipelineBundles(evictedBundles);
+}
+
+void Renderer::DestroySupersededObjects()
+{
+	for (Shader* fragmentShader : m_SupersededFragmentShaders)
+	{
+		delete(fragmentShader);
+	}
+	m_SupersededFragmentShaders.clear();
+
+	// Cancelled prebuild in flight might still be building against a superseded descriptor set.
+	if (m_VariantPipelineBuilder->IsBusy())
+	{
+		return;
+	}
+
+	for (DescriptorSet* descriptorSet : m_SupersededDescriptorSets)
+	{
+		delete(descriptorSet);
+	}
+	m_SupersededDescriptorSets.clear();
+}
+
+Renderer::RetiredObjects& Renderer::GetRetiredObjects()
+{
+	if (m_RetiredObjects.empty() || m_RetiredObjects.back().FrameIndex != m_FrameIndex)
+	{
+		m_RetiredObjects.push_back(RetiredObjects());
+		m_RetiredObjects.back().FrameIndex = m_FrameIndex;
+	}
+
+	return m_RetiredObjects.back();
+}
+
+void Renderer::DestroyRetiredObjects(const bool inForce)
+{
+	// Cancelled builds might still be linking a pipeline which was retired in the meantime, relaxed builds read the retired shader
+	// and prebuilds the retired descriptor set.
+	if (!inForce && (m_PipelineBuilder->IsBusy() || m_RelaxedPipelineBuilder->IsBusy() || m_VariantPipelineBuilder->IsBusy()))
+	{
+		return;
+	}
+
+	// Frame which reuses the slot of the last frame recording retired objects waits on its fence first.
+	const uint64_t maxFramesInFlight = m_Swapchain->GetMaxFramesInFlight();
+	while (!m_RetiredObjects.empty() && (inForce || m_FrameIndex >= m_RetiredObjects.front().FrameIndex + maxFramesInFlight))
+	{
+		RetiredObjects& retiredObjects = m_RetiredObjects.front();
+
+		for (Pipeline* pipeline : retiredObjects.Pipelines)
+		{
+			delete(pipeline);
+		}
+
+		for (Shader* shader : retiredObjects.Shaders)
+		{
+			delete(shader);
+		}
+
+		for (DescriptorSet* descriptorSet : retiredObjects.DescriptorSets)
+		{
+			delete(descriptorSet);
+		}
+
+		for (const Resource& resource : retiredObjects.Resources)
+		{
+			ResourceContainer::DeleteResource(resource);
+		}
+
+		m_RetiredObjects.pop_front();
+	}
+}
+
+std::vector<SpecializationConstant> Renderer::GetShaderSpecializationConstants(const Shader* inShader) const
+{
+	std::vector<SpecializationConstant> specializationConstants = inShader->GetSpecializationConstants();
+	for (SpecializationConstant& specializationConstant : specializationConstants)
+	{
+		// Value is kept only while the constant keeps its type, reinterpreting the bits would be meaningless.
+		const auto specializationValueIterator = m_SpecializationValues.find(specializationConstant.ConstantId);
+		if (specializationValueIterator != m_SpecializationValues.end() &&
+			specializationValueIterator->second.Type == specializationConstant.Type)
+		{
+			specializationConstant.Value = specializationValueIterator->second.Value;
+		}
+	}
+
+	return specializationConstants;
+}
+
+bool Renderer::ApplySpecializationConstantsMetaData(const rapidjson::Value& inSpecializationConstantsJson)
+{
+	if (!inSpecializationConstantsJson.IsArray())
+	{
+		FT_LOG("Failed parsing SpecializationConstants from meta data of %s.\n", m_FragmentShaderFile->GetName().c_str());
+		return false;
+	}
+
+	bool anyApplied = false;
+	for (const rapidjson::Value& specializationConstantJson : inSpecializationConstantsJson.GetArray())
+	{
+		SpecializationConstant specializationConstant;
+		if (!specializationConstantJson.IsObject() ||
+			!specializationConstantJson.HasMember("Id") || !specializationConstantJson["Id"].IsUint() ||
+			!specializationConstantJson.HasMember("Type") || !specializationConstantJson["Type"].IsInt() ||
+			!specializationConstantJson.HasMember("Value") ||
+			!DeserializeSpecializationValue(specializationConstantJson["Type"].GetInt(), specializationConstantJson["Value"], specializationConstant))
+		{
+			FT_LOG("Skipping invalid specialization constant in meta data of %s.\n", m_FragmentShaderFile->GetName().c_str());
+			continue;
+		}
+
+		specializationConstant.ConstantId = specializationConstantJson["Id"].GetUint();
+		if (specializationConstantJson.HasMember("Name") && specializationConstantJson["Name"].IsString())
+		{
+			specializationConstant.Name = specializationConstantJson["Name"].GetString();
+		}
+
+		m_SpecializationValues[specializationConstant.ConstantId] = specializationConstant;
+		anyApplied = true;
+	}
+
+	return anyApplied;
+}
+
+void Renderer::ApplyPushConstantsMetaData(const rapidjson::Value& inPushConstantsJson)
+{
+	size_t size = 0;
+	unsigned char* proxyMemory = nullptr;
+	unsigned char* vectorState = nullptr;
+	if (!inPushConstantsJson.IsObject() || !DeserializeUniformBuffer(inPushConstantsJson, size, proxyMemory, vectorState))
+	{
+		FT_LOG("Failed parsing PushConstants from meta data of %s.\n", m_FragmentShaderFile->GetName().c_str());
+	}
+	else if (size != m_PushConstantMemory.size())
+	{
+		FT_LOG("Skipping PushConstants from meta data of %s, since the block size has changed.\n", m_FragmentShaderFile->GetName().c_str());
+	}
+	else
+	{
+		m_PushConstantMemory.assign(proxyMemory, proxyMemory + size);
+		m_PushConstantVectorState.assign(vectorState, vectorState + size);
+	}
+
+	delete[](vectorState);
+	delete[](proxyMemory);
+}
+
+void Renderer::UpdatePushConstantMemory()
+{
+	// Values are kept while the block keeps its size, the same way uniform buffers survive recompilation.
+	const size_t pushConstantSize = m_FragmentShader->GetPushConstantSize();
+	if (pushConstantSize == m_PushConstantMemory.size())
+	{
+		return;
+	}
+
+	m_PushConstantMemory.assign(pushConstantSize, 0);
+	m_PushConstantVectorState.assign(pushConstantSize, 0);
+}
+
+void Renderer::RecreateSpecializedPipelines()
+{
+	// Same module is applied again with the new values, so its layout and descriptor set are kept and only the pipeline is built,
+	// on the builder thread. Pending optimization is cancelled, the new pipeline is optimized once it's published.
+	const Shader* fragmentShader = m_PendingFragmentShader ? m_PendingFragmentShader : m_FragmentShader;
+	const std::vector<uint32_t> spvCode = fragmentShader->GetSpvCode();
+	ApplyFragmentShader(spvCode);
+}
+
+void Renderer::RecreateRelaxedPipeline()
+{
+	if (!m_PrecisionComparison)
+	{
+		return;
+	}
+
+	DestroyRelaxedPipeline();
+
+	// Half floats are used only where the device can execute them, RelaxedPrecision decorations are always valid.
+	const bool convertToHalf = m_Device->IsShaderFloat16Supported();
+
+	// Relaxation passes and the monolithic build run on their own builder, comparison is paused until the pipeline is done.
+	m_RelaxedPipelineBuildPending = true;
+	m_RelaxedPipelineBuilder->SubmitRelaxed(m_Swapchain, m_DescriptorSet, m_VertexShader, m_FragmentShader, GetShaderSpecializationConstants(m_FragmentShader), convertToHalf);
+}
+
+void Renderer::DestroyRelaxedPipeline()
+{
+	if (!m_RelaxedPipeline)
+	{
+		return;
+	}
+
+	// Relaxed pipeline is recorded every frame, so it can still be in use.
+	RetiredObjects& retiredObjects = GetRetiredObjects();
+	retiredObjects.Pipelines.push_back(m_RelaxedPipeline);
+	m_RelaxedPipeline = nullptr;
+}
+
 void Renderer::CleanupSwapchain()
 {
 	m_Swapchain->Cleanup();
 
 	delete(m_CommandBuffer);
 	delete(m_Pipeline);
-	delete(m_DescriptorSet);
+
+	// Libraries bake the viewport and the render pass, so they are created again along with the swapchain.
+	delete(m_PipelineLibrary);
+	m_PipelineLibrary = nullptr;
+
+	DestroyRelaxedPipeline();
+
+	if (m_PrecisionComparison)
+	{
+		delete(m_PrecisionComparison);
+		m_PrecisionComparison = nullptr;
+	}
 }
 
 void Renderer::RecreateSwapchain()
@@ -327,32 +1280,87 @@ void Renderer::RecreateSwapchain()
 		glfwWaitEvents();
 	}
 
+	// Pending pipeline was created for the old swapchain, it's published first so everything is recreated together.
+	FinishPipelineBuilds();
+
+	// Relaxed pipeline is built for the old render pass too, it's submitted again along with the precision comparison.
+	m_RelaxedPipelineBuilder->Cancel();
+	m_RelaxedPipelineBuilder->WaitIdle();
+	m_RelaxedPipelineBuildPending = false;
+
+	// Prebuilds target the old render pass as well, they are queued again once the swapchain is recreated.
+	m_VariantPipelineBuilder->Cancel();
+	m_VariantPipelineBuilder->WaitIdle();
+	m_VariantPrebuildState = 0;
+
 	vkDeviceWaitIdle(m_Device->GetDevice());
 
+	// Cached pipelines are baked for the old swapchain as well.
+	ClearPipelineBundles();
+
+	const bool precisionComparisonEnabled = m_PrecisionComparison != nullptr;
 	CleanupSwapchain();
+	DestroyRetiredObjects(true);
 
 	m_Swapchain->Recreate();
 
+	m_PipelineLibrary = m_Device->IsGraphicsPipelineLibrarySupported() ? new PipelineLibrary(m_Device, m_Swapchain, m_VertexShader) : nullptr;
+
 	m_ResourceContainer->RecreateUniformBuffers();
 
-	m_DescriptorSet = new DescriptorSet(m_Device, m_Swapchain, m_ResourceContainer->GetDescriptors());
-	m_Pipeline = new Pipeline(m_Device, m_Swapchain, m_DescriptorSet, m_VertexShader, m_FragmentShader);
+	// Bindings didn't change, only uniform buffers were created again and the image count might differ.
+	m_DescriptorSet->Recreate(m_Swapchain, m_ResourceContainer->GetDescriptors());
 	m_CommandBuffer = new CommandBuffer(m_Device, m_Swapchain);
 
+	const auto pipelineStartTime = std::chrono::high_resolution_clock::now();
+
+	m_Pipeline = new Pipeline(m_Device, m_Swapchain, m_DescriptorSet, m_VertexShader, m_FragmentShader, GetShaderSpecializationConstants(m_FragmentShader), nullptr);
+
+	if (precisionComparisonEnabled)
+	{
+		SetPrecisionComparison(true);
+	}
+
+	const auto pipelineEndTime = std::chrono::high_resolution_clock::now();
+	FT_LOG("Resize pipelines created in %.2f ms.\n", std::chrono::duration<double, std::milli>(pipelineEndTime - pipelineStartTime).count());
+
+	PrebuildShaderVariants();
+
 	ImGui_ImplVulkan_SetMinImageCount(m_Swapchain->GetImageCount());
 }
 
 void Renderer::FillCommandBuffers(uint32_t inSwapchainImageIndex)
 {
-	m_CommandBuffer->Begin(inSwapchainImageIndex, m_Swapchain);
-	m_CommandBuffer->BindPipeline(m_Pipeline);
-	m_CommandBuffer->BindDescriptorSet(m_DescriptorSet);
-	m_CommandBuffer->Draw();
+	m_CommandBuffer->Begin(inSwapchainImageIndex);
+
+	const bool comparePrecision = m_PrecisionComparison && m_RelaxedPipeline;
+	if (comparePrecision)
+	{
+		m_PrecisionComparison->RenderVariants(m_CommandBuffer, m_Pipeline, m_RelaxedPipeline, m_DescriptorSet, m_PushConstantMemory);
+	}
+
+	m_CommandBuffer->BeginRenderPass(m_Swapchain->GetRenderPass(), m_Swapchain->GetFramebuffer(inSwapchainImageIndex), m_Swapchain->GetExtent());
+
+	if (comparePrecision)
+	{
+		m_PrecisionComparison->DrawView(m_CommandBuffer, m_PrecisionView, m_PrecisionErrorScale);
+	}
+	else
+	{
+		m_CommandBuffer->BindPipeline(m_Pipeline);
+		m_CommandBuffer->BindDescriptorSets(m_DescriptorSet);
+		if (!m_PushConstantMemory.empty())
+		{
+			m_CommandBuffer->PushConstants(VK_SHADER_STAGE_FRAGMENT_BIT, static_cast<uint32_t>(m_PushConstantMemory.size()), m_PushConstantMemory.data());
+		}
+		m_CommandBuffer->Draw();
+	}
 
 	ImDrawData* drawData = ImGui::GetDrawData();
 	VkCommandBuffer commandBuffer = m_CommandBuffer->GetCommandBuffer(inSwapchainImageIndex);
 	ImGui_ImplVulkan_RenderDrawData(drawData, commandBuffer);
 
+	m_CommandBuffer->EndRenderPass();
 	m_CommandBuffer->End();
 }
 
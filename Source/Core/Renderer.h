@@ -1,19 +1,45 @@
 #pragma once
 
 #include "Descriptor.hpp"
+#include "PrecisionComparison.h"
+#include "Compiler/ShaderReflect.h"
 
 FT_BEGIN_NAMESPACE
 
+// How much of the rendering state a new fragment shader module required to rebuild.
+enum class ShaderRebuild : uint8_t
+{
+	None,
+	Pipeline,
+	Full,
+	Restored,
+
+	Count
+};
+
+struct ShaderRebuildStatistics
+{
+	uint64_t Unchanged = 0;
+	uint64_t PipelineRebuilds = 0;
+	uint64_t FullRebuilds = 0;
+	uint64_t Restored = 0;
+};
+
 class Window;
 class Device;
 class Swapchain;
 class Shader;
 class ShaderFile;
 class Pipeline;
+class PipelineLibrary;
 class DescriptorSet;
 class CommandBuffer;
 class ResourceContainer;
+class PipelineBuilder;
+class PipelineBundleCache;
+struct PipelineBundle;
 struct SamplerInfo;
+struct ShaderVariantResult;
 
 class Renderer
 {
@@ -27,21 +53,68 @@ public:
 	void WaitDeviceToFinish();
 	void WaitQueueToFinish();
 	void UpdateFragmentShaderFile(ShaderFile* inFragmentShaderFile);
-	void OnFragmentShaderRecompiled(const std::vector<uint32_t>& inSpvCode);
+	ShaderRebuild OnFragmentShaderRecompiled(const std::vector<uint32_t>& inSpvCode);
+	void UpdateShaderVariants(const std::vector<ShaderVariantResult>& inVariantResults);
+	bool SelectShaderVariant(const uint32_t inPermutationIndex);
+	void ClearShaderVariants();
+	void UpdateSpecializationConstant(const SpecializationConstant& inSpecializationConstant);
+	void ApplySpecializationConstants();
+	void ResetSpecializationConstants();
 	bool TryApplyMetaData();
 	void SaveMetaData();
 	void UpdateImageDescriptor(const uint32_t inDescriptorIndex, const std::string& inPath);
 	void UpdateSamplerDescriptor(const uint32_t inDescriptorIndex, const SamplerInfo& inSamplerInfo);
+	void UpdateStorageBufferDescriptor(const uint32_t inDescriptorIndex, const std::string& inDataPath);
+	void UpdateTextureArrayFolderDescriptor(const uint32_t inDescriptorIndex, const std::string& inFolderPath);
+	void UpdateTextureArrayImageDescriptor(const uint32_t inDescriptorIndex, const uint32_t inSlot, const std::string& inPath);
 	void UpdateUniformBuffersDeviceMemory(uint32_t inCurrentImage);
-	void RecreateDescriptorSet();
+	void SetPrecisionComparison(const bool inEnabled);
+	void SetMaxPipelineBundleCount(const uint32_t inMaxBundleCount);
+	void SetPrecisionView(const PrecisionView inView) { m_PrecisionView = inView; }
+	void SetPrecisionErrorScale(const float inErrorScale) { m_PrecisionErrorScale = inErrorScale; }
 
 public:
 	Device* GetDevice() const { return m_Device; }
 	Swapchain* GetSwapchain() const { return m_Swapchain; }
 	ShaderFile* GetFragmentShaderFile() const { return m_FragmentShaderFile; }
 	std::vector<Descriptor> GetDescriptors() const;
+	std::vector<SpecializationConstant> GetSpecializationConstants() const;
+	uint32_t GetShaderVariantCount() const { return static_cast<uint32_t>(m_ShaderVariantHashes.size()); }
+	uint32_t GetUniqueShaderVariantCount() const { return static_cast<uint32_t>(m_ShaderVariants.size()); }
+	ShaderRebuildStatistics GetShaderRebuildStatistics() const { return m_ShaderRebuildStatistics; }
+	const PrecisionComparison* GetPrecisionComparison() const { return m_PrecisionComparison; }
+	bool HasRelaxedPipeline() const { return m_RelaxedPipeline != nullptr; }
+	bool IsRelaxedPipelineBuildPending() const { return m_RelaxedPipelineBuildPending; }
+	PrecisionView GetPrecisionView() const { return m_PrecisionView; }
+	float GetPrecisionErrorScale() const { return m_PrecisionErrorScale; }
+	const SpvReflectBlockVariable* GetPushConstantBlock() const;
+	unsigned char* GetPushConstantMemory() { return m_PushConstantMemory.data(); }
+	unsigned char* GetPushConstantVectorState() { return m_PushConstantVectorState.data(); }
 
 private:
+	ShaderRebuild ApplyFragmentShader(const std::vector<uint32_t>& inSpvCode);
+	std::vector<SpecializationConstant> GetShaderSpecializationConstants(const Shader* inShader) const;
+	bool ApplySpecializationConstantsMetaData(const rapidjson::Value& inSpecializationConstantsJson);
+	void ApplyPushConstantsMetaData(const rapidjson::Value& inPushConstantsJson);
+	void UpdatePushConstantMemory();
+	void WriteMetaData();
+	void RecreateSpecializedPipelines();
+	void PrebuildShaderVariants();
+	void RecreateRelaxedPipeline();
+	void DestroyRelaxedPipeline();
+	uint64_t GetPipelineBundleKey(const uint64_t inSpvHash) const;
+	void SetPendingPipelineObjects(Shader* inFragmentShader, DescriptorSet* inDescriptorSet, const uint64_t inPipelineBundleKey);
+	void ProcessPipelineBuild();
+	void WaitPipelineBuild();
+	void SubmitPipelineOptimization();
+	void FinishPipelineBuilds();
+	void PublishPipeline(Pipeline* inPipeline);
+	void StorePipelineBundle();
+	void RetireResources(const std::vector<Resource>& inResources);
+	void RetirePipelineBundles(const std::vector<PipelineBundle>& inPipelineBundles);
+	void ClearPipelineBundles();
+	void DestroySupersededObjects();
+	void DestroyRetiredObjects(const bool inForce);
 	void CleanupSwapchain();
 	void RecreateSwapchain();
 	void FillCommandBuffers(uint32_t inSwapchainImageIndex);
@@ -57,6 +130,75 @@ private:
 	DescriptorSet* m_DescriptorSet;
 	CommandBuffer* m_CommandBuffer;
 	ResourceContainer* m_ResourceContainer;
+
+private:
+	// Fragment shader whose pipeline is still being created, the active one is rendered until the pipeline is done.
+	// Descriptor set is only pending when the pipeline layout changed, otherwise the active one is kept.
+	PipelineBuilder* m_PipelineBuilder;
+	bool m_PipelineBuildPending;
+
+	// Meta data saved while a build was pending, it's written along with the pipeline publish.
+	bool m_MetaDataSavePending;
+
+	// Null when graphics pipeline libraries aren't supported. Fast linked pipelines are replaced by optimized ones once they are linked.
+	PipelineLibrary* m_PipelineLibrary;
+	bool m_PipelineOptimizationPending;
+
+	Shader* m_PendingFragmentShader;
+	DescriptorSet* m_PendingDescriptorSet;
+	std::vector<Resource> m_PendingRetiredResources;
+
+	// Replaced fragment shaders and their pipelines, keyed by SPIR-V and overridden specialization values.
+	PipelineBundleCache* m_PipelineBundleCache;
+	uint64_t m_PipelineBundleKey;
+	uint64_t m_PendingPipelineBundleKey;
+
+	// Pending objects replaced by a newer submit never reached a frame, they only wait for the builder to let go of them.
+	std::vector<Shader*> m_SupersededFragmentShaders;
+	std::vector<DescriptorSet*> m_SupersededDescriptorSets;
+
+	// Objects which frames in flight might still use, destroyed once every frame recorded before their retirement has finished.
+	struct RetiredObjects
+	{
+		uint64_t FrameIndex = 0;
+		std::vector<Pipeline*> Pipelines;
+		std::vector<Shader*> Shaders;
+		std::vector<DescriptorSet*> DescriptorSets;
+		std::vector<Resource> Resources;
+	};
+
+	RetiredObjects& GetRetiredObjects();
+
+	uint64_t m_FrameIndex;
+	std::list<RetiredObjects> m_RetiredObjects;
+
+private:
+	uint64_t m_FragmentShaderHash;
+	uint64_t m_PipelineLayoutHash;
+	ShaderRebuildStatistics m_ShaderRebuildStatistics;
+	// Compiled variant modules keyed by SPIR-V hash. Their pipelines are prebuilt on a builder of their own and pinned in the
+	// bundle cache, prebuilds are queued again once the pipeline layout or the overridden specialization values change.
+	std::map<uint64_t, std::vector<uint32_t>> m_ShaderVariants;
+	std::vector<uint64_t> m_ShaderVariantHashes;
+	PipelineBuilder* m_VariantPipelineBuilder;
+	uint64_t m_VariantPrebuildState;
+
+	// Values changed by the user, keyed by constant id. Everything else uses the default from the shader.
+	std::map<uint32_t, SpecializationConstant> m_SpecializationValues;
+
+	// Host copy of the fragment push constant block, recorded straight into the command buffer every frame.
+	std::vector<unsigned char> m_PushConstantMemory;
+	std::vector<unsigned char> m_PushConstantVectorState;
+
+private:
+	// Pipeline of a relaxed precision copy of the active fragment shader, only alive while the comparison is enabled.
+	// It has its own builder, so relaxing and building it never delays the active pipeline.
+	PrecisionComparison* m_PrecisionComparison;
+	PipelineBuilder* m_RelaxedPipelineBuilder;
+	Pipeline* m_RelaxedPipeline;
+	bool m_RelaxedPipelineBuildPending;
+	PrecisionView m_PrecisionView;
+	float m_PrecisionErrorScale;
 };
 
 FT_END_NAMESPACE
@@ -8,6 +8,8 @@ enum class ResourceType
 	Image,
 	Sampler,
 	UniformBuffer,
+	StorageBuffer,
+	TextureArray,
 
 	Count
 };
@@ -16,6 +18,8 @@ class CombinedImageSampler;
 class Image;
 class Sampler;
 class UniformBuffer;
+class StorageBuffer;
+class TextureArray;
 
 union ResourceHandle
 {
@@ -23,6 +27,8 @@ union ResourceHandle
 	Image* Image;
 	Sampler* Sampler;
 	UniformBuffer* UniformBuffer;
+	StorageBuffer* StorageBuffer;
+	TextureArray* TextureArray;
 };
 
 struct Resource
@@ -4,8 +4,11 @@
 #include "Sampler.h"
 #include "CombinedImageSampler.h"
 #include "UniformBuffer.h"
+#include "StorageBuffer.h"
+#include "TextureArray.h"
 #include "Descriptor.hpp"
 #include "Utility/ImageFile.h"
+#include "Compiler/ShaderReflect.h"
 
 FT_BEGIN_NAMESPACE
 
@@ -14,7 +17,8 @@ static const std::string DefaultImagePath = GetAbsolutePath("icon");
 
 ResourceContainer::ResourceContainer(const Device* inDevice, const Swapchain* inSwapchain)
 	: m_Device(inDevice)
-	, m_Swapchain(inSwapchain) {}
+	, m_Swapchain(inSwapchain)
+	, m_UniformBufferRing(new UniformBufferRing(inDevice, inSwapchain)) {}
 
 ResourceContainer::~ResourceContainer()
 {
@@ -22,6 +26,8 @@ ResourceContainer::~ResourceContainer()
 	{
 		DeleteResource(descriptor.Resource);
 	}
+
+	delete(m_UniformBufferRing);
 }
 
 rapidjson::Value ResourceContainer::Serialize(rapidjson::Document::AllocatorType& inAllocator)
@@ -65,6 +71,19 @@ rapidjson::Value ResourceContainer::Serialize(rapidjson::Document::AllocatorType
 			break;
 		}
 
+		case ResourceType::StorageBuffer:
+		{
+			resourceJson = SerializeStorageBuffer(resourceHandle.StorageBuffer->GetDataPath(), inAllocator);
+			break;
+		}
+
+		case ResourceType::TextureArray:
+		{
+			const TextureArray* textureArray = resourceHandle.TextureArray;
+			resourceJson = SerializeTextureArray(textureArray->GetImagePaths(), textureArray->GetSampler()->GetInfo(), inAllocator);
+			break;
+		}
+
 		default:
 			FT_FAIL("Unsupported ResourceType.");
 		}
@@ -100,30 +119,39 @@ static ResourceType GetResourceType(const VkDescriptorType inDescriptorType)
 	case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
 		return ResourceType::UniformBuffer;
 
+	case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+		return ResourceType::StorageBuffer;
+
 	default:
 		FT_FAIL("Unsupported VkDescriptorType.");
 	}
 }
 
+// Only valid for freshly reflected bindings, since runtime arrays are recognized through the reflected type description.
+static ResourceType GetBindingResourceType(const Binding& inBinding)
+{
+	if (IsRuntimeArrayBinding(inBinding.ReflectDescriptorBinding))
+	{
+		return ResourceType::TextureArray;
+	}
+
+	return GetResourceType(inBinding.DescriptorSetBinding.descriptorType);
+}
+
 void ResourceContainer::RecreateUniformBuffers()
 {
-	const uint32_t swapchainImageCount = m_Swapchain->GetImageCount();
+	if (m_UniformBufferRing->GetRegionCount() == m_Swapchain->GetImageCount())
+	{
+		return;
+	}
 
-	for (auto& descriptor : m_Descriptors)
+	// Every swapchain image has a region of its own, so the ring is created again and buffers upload their whole contents.
+	m_UniformBufferRing->Recreate(m_Swapchain);
+	for (const auto& descriptor : m_Descriptors)
 	{
-		Resource& resource = descriptor.Resource;
-		if (resource.Type == ResourceType::UniformBuffer)
+		if (descriptor.Resource.Type == ResourceType::UniformBuffer)
 		{
-			UniformBuffer*& uniformBuffer = resource.Handle.UniformBuffer;
-			if (uniformBuffer->GetBufferCount() == swapchainImageCount)
-			{
-				continue;
-			}
-
-			const uint32_t bufferSize = uniformBuffer->GetSize();
-			DeleteResource(resource);
-
-			uniformBuffer = new UniformBuffer(m_Device, m_Swapchain, bufferSize);
+			descriptor.Resource.Handle.UniformBuffer->ResetRegions();
 		}
 	}
 }
@@ -133,7 +161,13 @@ static uint32_t GetUniformBufferSize(const SpvReflectDescriptorBinding inReflect
 	return inReflectDescriptorBinding.block.padded_size * inReflectDescriptorBinding.count;
 }
 
-static ResourceHandle CreateResource(const Device* inDevice, const Swapchain* inSwapchain, const ResourceType inResourceType, const SpvReflectDescriptorBinding inReflectDescriptorBinding)
+// Runtime arrays don't count into the block size, so this is only the fixed part which the buffer has to cover.
+static uint32_t GetStorageBufferMinSize(const SpvReflectDescriptorBinding inReflectDescriptorBinding)
+{
+	return inReflectDescriptorBinding.block.padded_size;
+}
+
+static ResourceHandle CreateResource(const Device* inDevice, UniformBufferRing* inUniformBufferRing, const ResourceType inResourceType, const SpvReflectDescriptorBinding inReflectDescriptorBinding)
 {
 	ResourceHandle handle;
 
@@ -164,7 +198,21 @@ static ResourceHandle CreateResource(const Device* inDevice, const Swapchain* in
 	case ResourceType::UniformBuffer:
 	{
 		const uint32_t bufferSize = GetUniformBufferSize(inReflectDescriptorBinding);
-		handle.UniformBuffer = new UniformBuffer(inDevice, inSwapchain, bufferSize);
+		handle.UniformBuffer = new UniformBuffer(inUniformBufferRing, bufferSize);
+		break;
+	}
+
+	case ResourceType::StorageBuffer:
+	{
+		handle.StorageBuffer = new StorageBuffer(inDevice, "", GetStorageBufferMinSize(inReflectDescriptorBinding));
+		break;
+	}
+
+	case ResourceType::TextureArray:
+	{
+		const std::vector<std::string> imagePaths = { DefaultImagePath };
+		const SamplerInfo samplerInfo{};
+		handle.TextureArray = new TextureArray(inDevice, g_RuntimeArrayCapacity, imagePaths, samplerInfo, DefaultImagePath);
 		break;
 	}
 
@@ -175,99 +223,220 @@ static ResourceHandle CreateResource(const Device* inDevice, const Swapchain* in
 	return handle;
 }
 
+// Images and samplers sharing a binding, like HLSL textures and their samplers, are used as a single combined image sampler.
 static void MergeBindings(std::vector<Binding>& inOutBindings)
 {
-	for (auto iterator = inOutBindings.begin(); iterator != inOutBindings.end(); ++iterator)
+	std::map<std::pair<uint32_t, uint32_t>, size_t> samplerIndices;
+	for (size_t bindingIndex = 0; bindingIndex < inOutBindings.size(); ++bindingIndex)
+	{
+		const Binding& binding = inOutBindings[bindingIndex];
+		if (GetResourceType(binding.DescriptorSetBinding.descriptorType) == ResourceType::Sampler)
+		{
+			samplerIndices.emplace(std::make_pair(binding.ReflectDescriptorBinding.set, binding.DescriptorSetBinding.binding), bindingIndex);
+		}
+	}
+
+	if (samplerIndices.empty())
+	{
+		return;
+	}
+
+	std::vector<bool> mergedSamplers(inOutBindings.size(), false);
+	for (Binding& binding : inOutBindings)
 	{
-		const ResourceType resourceType = GetResourceType(iterator->DescriptorSetBinding.descriptorType);
-		if (resourceType != ResourceType::Image)
+		if (GetResourceType(binding.DescriptorSetBinding.descriptorType) != ResourceType::Image)
 		{
 			continue;
 		}
 
-		for (auto samplerIterator = inOutBindings.begin(); samplerIterator != inOutBindings.end(); ++samplerIterator)
+		const auto samplerIterator = samplerIndices.find(std::make_pair(binding.ReflectDescriptorBinding.set, binding.DescriptorSetBinding.binding));
+		if (samplerIterator != samplerIndices.end() && !mergedSamplers[samplerIterator->second])
 		{
-			const ResourceType possibleSamplerType = GetResourceType(samplerIterator->DescriptorSetBinding.descriptorType);
-			if (possibleSamplerType == ResourceType::Sampler &&
-				iterator->DescriptorSetBinding.binding == samplerIterator->DescriptorSetBinding.binding)
-			{
-				inOutBindings.erase(samplerIterator);
-				iterator->DescriptorSetBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-				break;
-			}
+			mergedSamplers[samplerIterator->second] = true;
+			binding.DescriptorSetBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		}
 	}
+
+	// Merged samplers are compacted away in a single pass, instead of erasing them one by one.
+	size_t keptBindingCount = 0;
+	for (size_t bindingIndex = 0; bindingIndex < inOutBindings.size(); ++bindingIndex)
+	{
+		if (!mergedSamplers[bindingIndex])
+		{
+			inOutBindings[keptBindingCount++] = inOutBindings[bindingIndex];
+		}
+	}
+
+	inOutBindings.resize(keptBindingCount);
 }
 
-void ResourceContainer::UpdateBindings(std::vector<Binding> inBindings)
+static DescriptorKey GetDescriptorKey(const Binding& inBinding)
 {
-	MergeBindings(inBindings);
+	const SpvReflectDescriptorBinding& reflectDescriptorBinding = inBinding.ReflectDescriptorBinding;
+
+	DescriptorKey descriptorKey;
+	descriptorKey.Set = reflectDescriptorBinding.set;
+	descriptorKey.Binding = inBinding.DescriptorSetBinding.binding;
+	descriptorKey.Name = reflectDescriptorBinding.name ? reflectDescriptorBinding.name : "";
+	descriptorKey.Type = GetBindingResourceType(inBinding);
+	descriptorKey.Size = descriptorKey.Type == ResourceType::UniformBuffer ? GetUniformBufferSize(reflectDescriptorBinding) : 0;
+	return descriptorKey;
+}
 
-	// TODO: Implement NullResource for all non implemented resources in order to prevent crashes.
-	for (uint32_t descriptorIndex = 0; descriptorIndex < m_Descriptors.size(); ++descriptorIndex)
-	{
-		Descriptor& descriptor = m_Descriptors[descriptorIndex];
-		Resource& resource = descriptor.Resource;
+static const size_t UnmatchedDescriptor = static_cast<size_t>(-1);
 
-		if (descriptorIndex >= inBindings.size())
+// Pairs every still unmatched new descriptor with an unmatched previous one that has the same key, in O(n log n).
+template<typename Key, typename KeyGetter>
+static void MatchDescriptors(const std::vector<DescriptorKey>& inPreviousKeys, const std::vector<DescriptorKey>& inKeys, KeyGetter inGetKey, const bool inRequireName,
+	std::vector<bool>& inOutPreviousMatched, std::vector<size_t>& inOutMatches)
+{
+	std::map<Key, size_t> previousIndices;
+	for (size_t previousIndex = 0; previousIndex < inPreviousKeys.size(); ++previousIndex)
+	{
+		if (!inOutPreviousMatched[previousIndex] && (!inRequireName || !inPreviousKeys[previousIndex].Name.empty()))
 		{
-			DeleteResource(resource);
-			break;
+			previousIndices.emplace(inGetKey(inPreviousKeys[previousIndex]), previousIndex);
 		}
+	}
 
-		const Binding& newBinding = inBindings[descriptorIndex];
-		const ResourceType newResourceType = GetResourceType(newBinding.DescriptorSetBinding.descriptorType);
+	for (size_t keyIndex = 0; keyIndex < inKeys.size(); ++keyIndex)
+	{
+		if (inOutMatches[keyIndex] != UnmatchedDescriptor || (inRequireName && inKeys[keyIndex].Name.empty()))
+		{
+			continue;
+		}
 
-		if (newResourceType != resource.Type ||
-			(resource.Type == ResourceType::UniformBuffer &&
-				resource.Handle.UniformBuffer->GetSize() != GetUniformBufferSize(newBinding.ReflectDescriptorBinding)))
+		const auto previousIterator = previousIndices.find(inGetKey(inKeys[keyIndex]));
+		if (previousIterator == previousIndices.end())
 		{
-			DeleteResource(resource);
-			resource.Handle = CreateResource(m_Device, m_Swapchain, newResourceType, newBinding.ReflectDescriptorBinding);
-			resource.Type = newResourceType;
+			continue;
 		}
 
-		descriptor.Binding = newBinding;
+		inOutMatches[keyIndex] = previousIterator->second;
+		inOutPreviousMatched[previousIterator->second] = true;
+		previousIndices.erase(previousIterator);
+	}
+}
+
+// Resources follow their descriptor by identity instead of position, so adding or removing a binding keeps loaded images
+// and uniform values of all the others. Only descriptors without a compatible predecessor get a new resource. Resources
+// which are replaced are returned instead of deleted, since descriptor sets of frames in flight might still use them.
+std::vector<Resource> ResourceContainer::UpdateBindings(std::vector<Binding> inBindings)
+{
+	MergeBindings(inBindings);
+
+	std::vector<DescriptorKey> descriptorKeys;
+	descriptorKeys.reserve(inBindings.size());
+	for (const Binding& binding : inBindings)
+	{
+		descriptorKeys.push_back(GetDescriptorKey(binding));
 	}
 
-	const size_t oldDescriptorCount = m_Descriptors.size();
-	m_Descriptors.resize(inBindings.size());
+	std::vector<bool> previousMatched(m_DescriptorKeys.size(), false);
+	std::vector<size_t> matches(descriptorKeys.size(), UnmatchedDescriptor);
+
+	typedef std::tuple<uint32_t, uint32_t, std::string, ResourceType, uint32_t> ExactKey;
+	MatchDescriptors<ExactKey>(m_DescriptorKeys, descriptorKeys, [](const DescriptorKey& inKey)
+		{
+			return ExactKey(inKey.Set, inKey.Binding, inKey.Name, inKey.Type, inKey.Size);
+		}, false, previousMatched, matches);
+
+	// Binding moved, which happens to every following binding when one is inserted and bindings are assigned automatically.
+	typedef std::tuple<std::string, ResourceType, uint32_t> MovedKey;
+	MatchDescriptors<MovedKey>(m_DescriptorKeys, descriptorKeys, [](const DescriptorKey& inKey)
+		{
+			return MovedKey(inKey.Name, inKey.Type, inKey.Size);
+		}, true, previousMatched, matches);
+
+	// Renamed in place.
+	typedef std::tuple<uint32_t, uint32_t, ResourceType, uint32_t> RenamedKey;
+	MatchDescriptors<RenamedKey>(m_DescriptorKeys, descriptorKeys, [](const DescriptorKey& inKey)
+		{
+			return RenamedKey(inKey.Set, inKey.Binding, inKey.Type, inKey.Size);
+		}, false, previousMatched, matches);
 
-	for (uint32_t descriptorIndex = oldDescriptorCount; descriptorIndex < m_Descriptors.size(); ++descriptorIndex)
+	std::vector<Resource> retiredResources;
+	std::vector<Descriptor> descriptors(inBindings.size());
+	for (size_t descriptorIndex = 0; descriptorIndex < descriptors.size(); ++descriptorIndex)
 	{
-		Descriptor& descriptor = m_Descriptors[descriptorIndex];
-		Resource& resource = descriptor.Resource;
+		Descriptor& descriptor = descriptors[descriptorIndex];
+		descriptor.Index = static_cast<uint32_t>(descriptorIndex);
+		descriptor.Binding = inBindings[descriptorIndex];
 
-		descriptor.Index = descriptorIndex;
+		if (matches[descriptorIndex] != UnmatchedDescriptor)
+		{
+			descriptor.Resource = m_Descriptors[matches[descriptorIndex]].Resource;
+
+			// Loaded data is kept when the fixed part of the block grows, the buffer is only padded up to the new size.
+			const uint32_t storageBufferMinSize = GetStorageBufferMinSize(descriptor.Binding.ReflectDescriptorBinding);
+			if (descriptor.Resource.Type == ResourceType::StorageBuffer && descriptor.Resource.Handle.StorageBuffer->GetSize() < storageBufferMinSize)
+			{
+				const std::string dataPath = descriptor.Resource.Handle.StorageBuffer->GetDataPath();
+				retiredResources.push_back(descriptor.Resource);
+				descriptor.Resource.Handle.StorageBuffer = new StorageBuffer(m_Device, dataPath, storageBufferMinSize);
+			}
 
-		const Binding& newBinding = inBindings[descriptorIndex];
-		descriptor.Binding = newBinding;
+			continue;
+		}
 
-		const ResourceType newResourceType = GetResourceType(newBinding.DescriptorSetBinding.descriptorType);
-		
-		resource.Handle = CreateResource(m_Device, m_Swapchain, newResourceType, newBinding.ReflectDescriptorBinding);
-		resource.Type = newResourceType;
+		// TODO: Implement NullResource for all non implemented resources in order to prevent crashes.
+		descriptor.Resource.Type = descriptorKeys[descriptorIndex].Type;
+		descriptor.Resource.Handle = CreateResource(m_Device, m_UniformBufferRing, descriptor.Resource.Type, descriptor.Binding.ReflectDescriptorBinding);
 	}
+
+	for (size_t previousIndex = 0; previousIndex < m_Descriptors.size(); ++previousIndex)
+	{
+		if (!previousMatched[previousIndex])
+		{
+			retiredResources.push_back(m_Descriptors[previousIndex].Resource);
+		}
+	}
+
+	m_Descriptors.swap(descriptors);
+	m_DescriptorKeys.swap(descriptorKeys);
+
+	return retiredResources;
 }
 
-void ResourceContainer::UpdateImage(const uint32_t inDescriptorIndex, const std::string& inPath)
+static void AddRetiredImage(Image* inImage, std::vector<Resource>& inOutRetiredResources)
+{
+	if (inImage)
+	{
+		Resource resource;
+		resource.Type = ResourceType::Image;
+		resource.Handle.Image = inImage;
+		inOutRetiredResources.push_back(resource);
+	}
+}
+
+static void AddRetiredSampler(Sampler* inSampler, std::vector<Resource>& inOutRetiredResources)
+{
+	Resource resource;
+	resource.Type = ResourceType::Sampler;
+	resource.Handle.Sampler = inSampler;
+	inOutRetiredResources.push_back(resource);
+}
+
+// Resources and their parts replaced by the updates below are returned instead of deleted, like the ones of UpdateBindings.
+std::vector<Resource> ResourceContainer::UpdateImage(const uint32_t inDescriptorIndex, const std::string& inPath)
 {
 	FT_CHECK(inDescriptorIndex < m_Descriptors.size(), "BindingIndex is out of bounds.");
 
 	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
 	const ImageFile imageFile(inPath);
 
+	std::vector<Resource> retiredResources;
 	switch (resource.Type)
 	{
 	case ResourceType::CombinedImageSampler:
 	{
-		resource.Handle.CombinedImageSampler->UpdateImage(imageFile);
+		AddRetiredImage(resource.Handle.CombinedImageSampler->UpdateImage(imageFile), retiredResources);
 		break;
 	}
 
 	case ResourceType::Image:
 	{
-		DeleteResource(resource);
+		retiredResources.push_back(resource);
 		resource.Handle.Image = new Image(m_Device, imageFile);
 
 		break;
@@ -276,25 +445,34 @@ void ResourceContainer::UpdateImage(const uint32_t inDescriptorIndex, const std:
 	default:
 		FT_FAIL("Unsupported ResourceType.");
 	}
+
+	return retiredResources;
 }
 
-void ResourceContainer::UpdateSampler(const uint32_t inDescriptorIndex, const SamplerInfo& inSamplerInfo)
+std::vector<Resource> ResourceContainer::UpdateSampler(const uint32_t inDescriptorIndex, const SamplerInfo& inSamplerInfo)
 {
 	FT_CHECK(inDescriptorIndex < m_Descriptors.size(), "BindingIndex is out of bounds.");
 
 	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
 
+	std::vector<Resource> retiredResources;
 	switch (resource.Type)
 	{
 	case ResourceType::CombinedImageSampler:
 	{
-		resource.Handle.CombinedImageSampler->UpdateSampler(inSamplerInfo);
+		AddRetiredSampler(resource.Handle.CombinedImageSampler->UpdateSampler(inSamplerInfo), retiredResources);
 		break;
 	}
 
-	case ResourceType::Image:
+	case ResourceType::TextureArray:
+	{
+		AddRetiredSampler(resource.Handle.TextureArray->UpdateSampler(inSamplerInfo), retiredResources);
+		break;
+	}
+
+	case ResourceType::Sampler:
 	{
-		DeleteResource(resource);
+		retiredResources.push_back(resource);
 		resource.Handle.Sampler = new Sampler(m_Device, inSamplerInfo);
 
 		break;
@@ -303,6 +481,8 @@ void ResourceContainer::UpdateSampler(const uint32_t inDescriptorIndex, const Sa
 	default:
 		FT_FAIL("Unsupported ResourceType.");
 	}
+
+	return retiredResources;
 }
 
 void ResourceContainer::UpdateUniformBuffer(const uint32_t inDescriptorIndex, const size_t inSize,
@@ -313,8 +493,78 @@ void ResourceContainer::UpdateUniformBuffer(const uint32_t inDescriptorIndex, co
 	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
 	FT_CHECK(resource.Type == ResourceType::UniformBuffer, "Tried updating non UniformBuffer resource.");
 
-	DeleteResource(resource);
-	resource.Handle.UniformBuffer = new UniformBuffer(m_Device, m_Swapchain, inSize, inProxyMemory, inVectorState);
+	// Buffer is kept, its range in the ring is only suballocated again when the size differs.
+	resource.Handle.UniformBuffer->UpdateMemory(inSize, inProxyMemory, inVectorState);
+}
+
+std::vector<Resource> ResourceContainer::UpdateStorageBuffer(const uint32_t inDescriptorIndex, const std::string& inDataPath)
+{
+	FT_CHECK(inDescriptorIndex < m_Descriptors.size(), "BindingIndex is out of bounds.");
+
+	const Descriptor& descriptor = m_Descriptors[inDescriptorIndex];
+	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
+	FT_CHECK(resource.Type == ResourceType::StorageBuffer, "Tried updating non StorageBuffer resource.");
+
+	const std::vector<Resource> retiredResources = { resource };
+	resource.Handle.StorageBuffer = new StorageBuffer(m_Device, inDataPath, GetStorageBufferMinSize(descriptor.Binding.ReflectDescriptorBinding));
+
+	return retiredResources;
+}
+
+std::vector<Resource> ResourceContainer::UpdateTextureArray(const uint32_t inDescriptorIndex, const std::vector<std::string>& inImagePaths, const SamplerInfo& inSamplerInfo)
+{
+	FT_CHECK(inDescriptorIndex < m_Descriptors.size(), "BindingIndex is out of bounds.");
+
+	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
+	FT_CHECK(resource.Type == ResourceType::TextureArray, "Tried updating non TextureArray resource.");
+
+	// Array is loaded in place, slots its descriptor set already holds beyond the new images are pointed at the default image.
+	TextureArray* textureArray = resource.Handle.TextureArray;
+	const std::vector<std::string> imagePaths(inImagePaths.begin(), inImagePaths.begin() + std::min<size_t>(inImagePaths.size(), textureArray->GetCapacity()));
+
+	std::vector<Resource> retiredResources;
+	AddRetiredSampler(textureArray->UpdateSampler(inSamplerInfo), retiredResources);
+
+	std::vector<Image*> replacedImages;
+	textureArray->LoadImages(imagePaths, replacedImages);
+	for (Image* image : replacedImages)
+	{
+		AddRetiredImage(image, retiredResources);
+	}
+
+	return retiredResources;
+}
+
+std::vector<Resource> ResourceContainer::UpdateTextureArrayFolder(const uint32_t inDescriptorIndex, const std::string& inFolderPath)
+{
+	FT_CHECK(inDescriptorIndex < m_Descriptors.size(), "BindingIndex is out of bounds.");
+
+	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
+	FT_CHECK(resource.Type == ResourceType::TextureArray, "Tried updating non TextureArray resource.");
+
+	std::vector<Image*> replacedImages;
+	resource.Handle.TextureArray->LoadFolder(inFolderPath, replacedImages);
+
+	std::vector<Resource> retiredResources;
+	for (Image* image : replacedImages)
+	{
+		AddRetiredImage(image, retiredResources);
+	}
+
+	return retiredResources;
+}
+
+std::vector<Resource> ResourceContainer::UpdateTextureArrayImage(const uint32_t inDescriptorIndex, const uint32_t inSlot, const std::string& inPath)
+{
+	FT_CHECK(inDescriptorIndex < m_Descriptors.size(), "BindingIndex is out of bounds.");
+
+	Resource& resource = m_Descriptors[inDescriptorIndex].Resource;
+	FT_CHECK(resource.Type == ResourceType::TextureArray, "Tried updating non TextureArray resource.");
+
+	std::vector<Resource> retiredResources;
+	AddRetiredImage(resource.Handle.TextureArray->UpdateImage(inSlot, inPath), retiredResources);
+
+	return retiredResources;
 }
 
 void ResourceContainer::DeleteResource(const Resource& inResource)
@@ -345,6 +595,14 @@ void ResourceContainer::DeleteResource(const Resource& inResource)
 		delete(Handle.UniformBuffer);
 		break;
 
+	case ResourceType::StorageBuffer:
+		delete(Handle.StorageBuffer);
+		break;
+
+	case ResourceType::TextureArray:
+		delete(Handle.TextureArray);
+		break;
+
 	default:
 		FT_FAIL("Unsupported ResourceType.");
 	}
@@ -4,10 +4,22 @@ FT_BEGIN_NAMESPACE
 
 class Device;
 class Swapchain;
+class UniformBufferRing;
 struct SamplerInfo;
 struct Binding;
 struct Resource;
 struct Descriptor;
+enum class ResourceType;
+
+// Identity of a descriptor across shader recompiles. Names are copied, reflection data of the previous shader might be gone already.
+struct DescriptorKey
+{
+	uint32_t Set = 0;
+	uint32_t Binding = 0;
+	std::string Name;
+	ResourceType Type;
+	uint32_t Size = 0;
+};
 
 class ResourceContainer
 {
@@ -22,22 +34,28 @@ public:
 
 public:
 	void RecreateUniformBuffers();
-	void UpdateBindings(std::vector<Binding> inBindings);
-	void UpdateImage(const uint32_t inDescriptorIndex, const std::string& inPath);
-	void UpdateSampler(const uint32_t inDescriptorIndex, const SamplerInfo& inSamplerInfo);
+	std::vector<Resource> UpdateBindings(std::vector<Binding> inBindings);
+	std::vector<Resource> UpdateImage(const uint32_t inDescriptorIndex, const std::string& inPath);
+	std::vector<Resource> UpdateSampler(const uint32_t inDescriptorIndex, const SamplerInfo& inSamplerInfo);
 	void UpdateUniformBuffer(const uint32_t inDescriptorIndex, const size_t inSize,
 		unsigned char* inProxyMemory, unsigned char* inVectorState);
+	std::vector<Resource> UpdateStorageBuffer(const uint32_t inDescriptorIndex, const std::string& inDataPath);
+	std::vector<Resource> UpdateTextureArray(const uint32_t inDescriptorIndex, const std::vector<std::string>& inImagePaths, const SamplerInfo& inSamplerInfo);
+	std::vector<Resource> UpdateTextureArrayFolder(const uint32_t inDescriptorIndex, const std::string& inFolderPath);
+	std::vector<Resource> UpdateTextureArrayImage(const uint32_t inDescriptorIndex, const uint32_t inSlot, const std::string& inPath);
 
 public:
-	const std::vector<Descriptor>& GetDescriptors() const { return m_Descriptors; }
+	static void DeleteResource(const Resource& inResource);
 
-private:
-	void DeleteResource(const Resource& inResource);
+public:
+	const std::vector<Descriptor>& GetDescriptors() const { return m_Descriptors; }
 
 private:
 	const Device* m_Device;
 	const Swapchain* m_Swapchain;
+	UniformBufferRing* m_UniformBufferRing;
 	std::vector<Descriptor> m_Descriptors;
+	std::vector<DescriptorKey> m_DescriptorKeys;
 };
 
 FT_END_NAMESPACE
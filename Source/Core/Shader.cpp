@@ -34,7 +34,10 @@ Shader::Shader(const Device* inDevice, const ShaderStage inStage, const std::vec
 	: m_Stage(inStage)
 	, m_CodeEntry(inCodeEntry)
 	, m_Device(inDevice)
+	, m_SpvCode(inSpvCode)
 	, m_Bindings(ReflectShader(inSpvCode, GetShaderStageFlag(m_Stage), m_ReflectModule))
+	, m_PushConstantBlock(ReflectPushConstantBlock(m_ReflectModule))
+	, m_SpecializationConstants(ReflectSpecializationConstants(inSpvCode))
 {
 	CreateShader(inDevice->GetDevice(), inSpvCode, m_Module);
 }
@@ -55,4 +58,14 @@ VkPipelineShaderStageCreateInfo Shader::GetVkPipelineStageInfo() const
 	return pipelineStageCreateInfo;
 }
 
+VkPushConstantRange Shader::GetPushConstantRange() const
+{
+	// Range always starts at zero, so the whole block can be pushed at once, including members with an explicit offset.
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = GetShaderStageFlag(m_Stage);
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = GetPushConstantSize();
+	return pushConstantRange;
+}
+
 FT_END_NAMESPACE
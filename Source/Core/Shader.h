@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Binding.hpp"
+#include "Compiler/ShaderReflect.h"
 
 FT_BEGIN_NAMESPACE
 
@@ -24,20 +25,28 @@ public:
 
 public:
 	VkPipelineShaderStageCreateInfo GetVkPipelineStageInfo() const;
+	VkPushConstantRange GetPushConstantRange() const;
 
 public:
 	ShaderStage GetStage() const { return m_Stage; }
 	std::string GetCodeEntry() const { return m_CodeEntry; }
 	VkShaderModule GetModule() const { return m_Module; }
+	const std::vector<uint32_t>& GetSpvCode() const { return m_SpvCode; }
 	const std::vector<Binding>& GetBindings() const { return m_Bindings; }
+	const std::vector<SpecializationConstant>& GetSpecializationConstants() const { return m_SpecializationConstants; }
+	const SpvReflectBlockVariable* GetPushConstantBlock() const { return m_PushConstantBlock; }
+	uint32_t GetPushConstantSize() const { return m_PushConstantBlock != nullptr ? m_PushConstantBlock->padded_size : 0; }
 
 private:
 	const Device* m_Device;
 	ShaderStage m_Stage;
 	std::string m_CodeEntry;
 	VkShaderModule m_Module;
+	std::vector<uint32_t> m_SpvCode;
 	SpvReflectShaderModule m_ReflectModule;
 	std::vector<Binding> m_Bindings;
+	const SpvReflectBlockVariable* m_PushConstantBlock;
+	std::vector<SpecializationConstant> m_SpecializationConstants;
 };
 
 FT_END_NAMESPACE
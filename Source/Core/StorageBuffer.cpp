@@ -0,0 +1,143 @@
+#include "StorageBuffer.h"
+#include "Device.h"
+#include "Buffer.h"
+#include "Utility/MappedFile.h"
+
+FT_BEGIN_NAMESPACE
+
+// Upper bound of host visible memory used while streaming, data files can be much larger than this.
+static const size_t StagingChunkSize = 64 * 1024 * 1024;
+
+// Storage buffer offsets and sizes have to be multiples of 4 bytes.
+static const size_t StorageBufferAlignment = 4;
+
+rapidjson::Value SerializeStorageBuffer(const std::string& inDataPath, rapidjson::Document::AllocatorType& inAllocator)
+{
+	rapidjson::Value json(rapidjson::kObjectType);
+
+	rapidjson::Value dataPathJson(inDataPath.empty() ? "" : GetRelativePath(inDataPath).c_str(), inAllocator);
+	json.AddMember("Path", dataPathJson, inAllocator);
+
+	return json;
+}
+
+bool DeserializeStorageBuffer(const rapidjson::Value& inStorageBufferJson, std::string& outDataPath)
+{
+	if (!inStorageBufferJson.HasMember("Path") || !inStorageBufferJson["Path"].IsString())
+	{
+		FT_LOG("Failed StorageBuffer Path deserialization.\n");
+		return false;
+	}
+
+	const std::string dataPath = inStorageBufferJson["Path"].GetString();
+	outDataPath = dataPath.empty() ? dataPath : GetAbsolutePath(dataPath);
+
+	return true;
+}
+
+static size_t AlignSize(const size_t inSize)
+{
+	return (inSize + StorageBufferAlignment - 1) & ~(StorageBufferAlignment - 1);
+}
+
+static void StreamToBuffer(const Device* inDevice, const MappedFile& inMappedFile, const Buffer* inBuffer)
+{
+	const size_t stagingSize = std::min(AlignSize(inMappedFile.GetSize()), StagingChunkSize);
+	Buffer stagingBuffer(inDevice, stagingSize, BufferUsageFlags::TransferSrc);
+	unsigned char* stagingData = static_cast<unsigned char*>(stagingBuffer.Map());
+
+	// Pages are read straight from the mapping into the staging memory, so the file is never copied on the heap.
+	for (size_t offset = 0; offset < inMappedFile.GetSize(); offset += stagingSize)
+	{
+		const size_t chunkSize = std::min(stagingSize, inMappedFile.GetSize() - offset);
+		memcpy(stagingData, inMappedFile.GetData() + offset, chunkSize);
+
+		// Last chunk of a file with an unaligned size is padded with zeros up to the next multiple of 4 bytes.
+		const size_t alignedChunkSize = AlignSize(chunkSize);
+		memset(stagingData + chunkSize, 0, alignedChunkSize - chunkSize);
+
+		VkBufferCopy bufferCopy{};
+		bufferCopy.srcOffset = 0;
+		bufferCopy.dstOffset = offset;
+		bufferCopy.size = alignedChunkSize;
+
+		const VkCommandBuffer commandBuffer = inDevice->BeginSingleTimeCommands();
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer.GetBuffer(), inBuffer->GetBuffer(), 1, &bufferCopy);
+		inDevice->EndSingleTimeCommands(commandBuffer);
+	}
+
+	stagingBuffer.Unmap();
+}
+
+static void FillBuffer(const Device* inDevice, const Buffer* inBuffer, const VkDeviceSize inOffset, const VkDeviceSize inSize)
+{
+	const VkCommandBuffer commandBuffer = inDevice->BeginSingleTimeCommands();
+	vkCmdFillBuffer(commandBuffer, inBuffer->GetBuffer(), inOffset, inSize, 0);
+	inDevice->EndSingleTimeCommands(commandBuffer);
+}
+
+StorageBuffer::StorageBuffer(const Device* inDevice, const std::string& inDataPath, const size_t inMinSize)
+	: m_Device(inDevice)
+	, m_Buffer(nullptr)
+	, m_Size(0)
+	, m_MinSize(AlignSize(std::max(inMinSize, StorageBufferAlignment)))
+	, m_DataPath(inDataPath)
+	, m_DataModificationTime(0)
+{
+	std::unique_ptr<MappedFile> mappedFile;
+	if (!m_DataPath.empty())
+	{
+		FileInfo fileInfo;
+		if (QueryFileInfo(m_DataPath, fileInfo))
+		{
+			m_DataModificationTime = fileInfo.ModificationTime;
+		}
+
+		mappedFile.reset(new MappedFile(m_DataPath));
+		if (!mappedFile->IsValid())
+		{
+			mappedFile.reset();
+		}
+		else if (mappedFile->GetSize() > inDevice->GetMaxStorageBufferRange())
+		{
+			FT_LOG("Data file %s is %zu bytes, which exceeds the device storage buffer range of %u bytes.\n",
+				m_DataPath.c_str(), mappedFile->GetSize(), inDevice->GetMaxStorageBufferRange());
+			mappedFile.reset();
+		}
+	}
+
+	const size_t dataSize = mappedFile ? mappedFile->GetSize() : 0;
+	m_Size = std::max(AlignSize(dataSize), m_MinSize);
+
+	m_Buffer = new Buffer(m_Device, m_Size, BufferUsageFlags::Storage | BufferUsageFlags::TransferDst, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	if (mappedFile)
+	{
+		StreamToBuffer(m_Device, *mappedFile, m_Buffer);
+	}
+
+	// Part of the block which the file doesn't cover reads as zeros, instead of whatever was left in the memory.
+	const size_t filledSize = AlignSize(dataSize);
+	if (filledSize < m_Size)
+	{
+		FillBuffer(m_Device, m_Buffer, filledSize, VK_WHOLE_SIZE);
+	}
+}
+
+StorageBuffer::~StorageBuffer()
+{
+	delete(m_Buffer);
+}
+
+bool StorageBuffer::IsDataModified() const
+{
+	if (m_DataPath.empty())
+	{
+		return false;
+	}
+
+	FileInfo fileInfo;
+	return QueryFileInfo(m_DataPath, fileInfo) && fileInfo.ModificationTime != m_DataModificationTime;
+}
+
+FT_END_NAMESPACE
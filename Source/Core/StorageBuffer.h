@@ -0,0 +1,39 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+rapidjson::Value SerializeStorageBuffer(const std::string& inDataPath, rapidjson::Document::AllocatorType& inAllocator);
+bool DeserializeStorageBuffer(const rapidjson::Value& inStorageBufferJson, std::string& outDataPath);
+
+class Device;
+class Buffer;
+
+// Device local buffer filled with the raw contents of a data file. Without a file, or when it can't be loaded,
+// the buffer is zeroed and only as large as the fixed part of the shader block.
+class StorageBuffer
+{
+public:
+	StorageBuffer(const Device* inDevice, const std::string& inDataPath, const size_t inMinSize);
+	~StorageBuffer();
+	FT_DELETE_COPY_AND_MOVE(StorageBuffer)
+
+public:
+	bool IsDataModified() const;
+
+public:
+	Buffer* GetBuffer() const { return m_Buffer; }
+	size_t GetSize() const { return m_Size; }
+	size_t GetMinSize() const { return m_MinSize; }
+	const std::string& GetDataPath() const { return m_DataPath; }
+	bool HasData() const { return !m_DataPath.empty(); }
+
+private:
+	const Device* m_Device;
+	Buffer* m_Buffer;
+	size_t m_Size;
+	size_t m_MinSize;
+	std::string m_DataPath;
+	int64_t m_DataModificationTime;
+};
+
+FT_END_NAMESPACE
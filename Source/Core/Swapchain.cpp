@@ -315,6 +315,11 @@ void Swapchain::Cleanup()
 	vkDestroySwapchainKHR(m_Device->GetDevice(), m_Swapchain, nullptr);
 }
 
+uint32_t Swapchain::GetMaxFramesInFlight() const
+{
+	return static_cast<uint32_t>(MaxFramesInFlight);
+}
+
 SwapchainImageAcquireResult Swapchain::AcquireNextImage()
 {
 	vkWaitForFences(m_Device->GetDevice(), 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
@@ -334,6 +339,12 @@ SwapchainImageAcquireResult Swapchain::AcquireNextImage()
 	}
 	else
 	{
+		// Image might still be rendered by a frame of another slot, its descriptor sets and command buffer are rewritten right after.
+		if (m_ImagesInFlight[imageIndex] != VK_NULL_HANDLE)
+		{
+			FT_VK_CALL(vkWaitForFences(m_Device->GetDevice(), 1, &m_ImagesInFlight[imageIndex], VK_TRUE, UINT64_MAX));
+		}
+
 		imageAcquireResult.ImageIndex = imageIndex;
 		imageAcquireResult.Status = SwapchainStatus::Success;
 	}
@@ -343,11 +354,6 @@ SwapchainImageAcquireResult Swapchain::AcquireNextImage()
 
 SwapchainStatus Swapchain::Present(const uint32_t inImageIndex, const CommandBuffer* inCommandBuffer)
 {
-	if (m_ImagesInFlight[inImageIndex] != VK_NULL_HANDLE)
-	{
-		FT_VK_CALL(vkWaitForFences(m_Device->GetDevice(), 1, &m_ImagesInFlight[inImageIndex], VK_TRUE, UINT64_MAX));
-	}
-
 	m_ImagesInFlight[inImageIndex] = m_InFlightFences[m_CurrentFrame];
 
 	VkSubmitInfo submitInfo{};
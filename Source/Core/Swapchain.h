@@ -43,6 +43,8 @@ public:
 	VkRenderPass GetRenderPass() const { return m_RenderPass; }
 	VkFramebuffer GetFramebuffer(const uint32_t inIndex) const { return m_Framebuffers[inIndex]; }
 	VkExtent2D GetExtent() const { return m_Extent; }
+	VkFormat GetFormat() const { return m_Format; }
+	uint32_t GetMaxFramesInFlight() const;
 
 private:
 	const Device* m_Device;
@@ -0,0 +1,198 @@
+#include "TextureArray.h"
+#include "Image.h"
+#include "Sampler.h"
+#include "Device.h"
+#include "Utility/ImageFile.h"
+#include "Utility/FileExplorer.h"
+
+FT_BEGIN_NAMESPACE
+
+rapidjson::Value SerializeTextureArray(const std::vector<std::string>& inImagePaths, const SamplerInfo& inSamplerInfo, rapidjson::Document::AllocatorType& inAllocator)
+{
+	rapidjson::Value json(rapidjson::kObjectType);
+
+	rapidjson::Value imagesJson(rapidjson::kArrayType);
+	for (const std::string& imagePath : inImagePaths)
+	{
+		rapidjson::Value imageJson = SerializeImage(imagePath, inAllocator);
+		imagesJson.PushBack(imageJson, inAllocator);
+	}
+
+	rapidjson::Value samplerJson = SerializeSampler(inSamplerInfo, inAllocator);
+
+	json.AddMember("Images", imagesJson, inAllocator);
+	json.AddMember("Sampler", samplerJson, inAllocator);
+
+	return json;
+}
+
+bool DeserializeTextureArray(const rapidjson::Value& inTextureArrayJson, std::vector<std::string>& outImagePaths, SamplerInfo& outSamplerInfo)
+{
+	if (!inTextureArrayJson.HasMember("Images") || !inTextureArrayJson["Images"].IsArray())
+	{
+		FT_LOG("Failed TextureArray Images deserialization.\n");
+		return false;
+	}
+
+	outImagePaths.clear();
+	for (const rapidjson::Value& imageJson : inTextureArrayJson["Images"].GetArray())
+	{
+		std::string imagePath;
+		if (!imageJson.IsObject() || !DeserializeImage(imageJson, imagePath))
+		{
+			FT_LOG("Failed Image deserialization.\n");
+			return false;
+		}
+
+		outImagePaths.push_back(imagePath);
+	}
+
+	if (!inTextureArrayJson["Sampler"].IsObject() ||
+		!DeserializeSampler(inTextureArrayJson["Sampler"], outSamplerInfo))
+	{
+		FT_LOG("Failed Sampler deserialization.\n");
+		return false;
+	}
+
+	return true;
+}
+
+static void CreateDescriptorInfo(const VkImageView inImageView, const VkSampler inSampler, VkDescriptorImageInfo& outDescriptorInfo)
+{
+	outDescriptorInfo = {};
+	outDescriptorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	outDescriptorInfo.imageView = inImageView;
+	outDescriptorInfo.sampler = inSampler;
+}
+
+TextureArray::TextureArray(const Device* inDevice, const uint32_t inCapacity, const std::vector<std::string>& inImagePaths, const SamplerInfo& inSamplerInfo,
+	const std::string& inDefaultImagePath)
+	: m_Device(inDevice)
+	, m_Capacity(inCapacity)
+	, m_DefaultImage(new Image(inDevice, ImageFile(inDefaultImagePath)))
+	, m_Sampler(new Sampler(inDevice, inSamplerInfo))
+{
+	std::vector<Image*> replacedImages;
+	LoadImages(inImagePaths, replacedImages);
+}
+
+TextureArray::~TextureArray()
+{
+	for (const Image* image : m_Images)
+	{
+		delete(image);
+	}
+
+	delete(m_DefaultImage);
+	delete(m_Sampler);
+}
+
+void TextureArray::LoadFolder(const std::string& inFolderPath, std::vector<Image*>& outReplacedImages)
+{
+	std::vector<FileInfo> files;
+	if (!ListFiles(inFolderPath, files))
+	{
+		FT_LOG("Failed listing %s folder.\n", inFolderPath.c_str());
+		return;
+	}
+
+	std::vector<std::string> imagePaths;
+	for (const FileInfo& file : files)
+	{
+		if (FileExplorer::IsImageFile(file.Path))
+		{
+			imagePaths.push_back(file.Path);
+		}
+	}
+
+	// Directory listing order is platform dependent, slots are assigned alphabetically so shaders can rely on them.
+	std::sort(imagePaths.begin(), imagePaths.end());
+
+	if (imagePaths.size() > m_Capacity)
+	{
+		FT_LOG("Folder %s has %u images, only the first %u are loaded.\n", inFolderPath.c_str(), static_cast<uint32_t>(imagePaths.size()), m_Capacity);
+		imagePaths.resize(m_Capacity);
+	}
+
+	LoadImages(imagePaths, outReplacedImages);
+}
+
+void TextureArray::LoadImages(const std::vector<std::string>& inImagePaths, std::vector<Image*>& outReplacedImages)
+{
+	ClearImages(outReplacedImages);
+
+	for (const std::string& imagePath : inImagePaths)
+	{
+		UpdateImage(GetCount(), imagePath);
+	}
+}
+
+Image* TextureArray::UpdateImage(const uint32_t inSlot, const std::string& inImagePath)
+{
+	FT_CHECK(inSlot <= GetCount() && inSlot < m_Capacity, "Texture array slot is out of bounds.");
+
+	const ImageFile imageFile(inImagePath);
+	Image* image = new Image(m_Device, imageFile);
+	Image* replacedImage = nullptr;
+
+	if (inSlot == GetCount())
+	{
+		m_Images.push_back(image);
+
+		// Slot might have been written before and vacated since, then its descriptor info is reused.
+		if (m_DescriptorInfos.size() < m_Images.size())
+		{
+			m_DescriptorInfos.emplace_back();
+		}
+	}
+	else
+	{
+		replacedImage = m_Images[inSlot];
+		m_Images[inSlot] = image;
+	}
+
+	CreateDescriptorInfo(image->GetImageView(), m_Sampler->GetSampler(), m_DescriptorInfos[inSlot]);
+
+	return replacedImage;
+}
+
+Sampler* TextureArray::UpdateSampler(const SamplerInfo& inSamplerInfo)
+{
+	Sampler* replacedSampler = m_Sampler;
+	m_Sampler = new Sampler(m_Device, inSamplerInfo);
+
+	for (uint32_t slot = 0; slot < GetDescriptorCount(); ++slot)
+	{
+		const Image* image = slot < GetCount() ? m_Images[slot] : m_DefaultImage;
+		CreateDescriptorInfo(image->GetImageView(), m_Sampler->GetSampler(), m_DescriptorInfos[slot]);
+	}
+
+	return replacedSampler;
+}
+
+std::vector<std::string> TextureArray::GetImagePaths() const
+{
+	std::vector<std::string> imagePaths;
+	imagePaths.reserve(m_Images.size());
+
+	for (const Image* image : m_Images)
+	{
+		imagePaths.push_back(image->GetPath());
+	}
+
+	return imagePaths;
+}
+
+void TextureArray::ClearImages(std::vector<Image*>& outReplacedImages)
+{
+	outReplacedImages.insert(outReplacedImages.end(), m_Images.begin(), m_Images.end());
+	m_Images.clear();
+
+	// Descriptor set still holds the written slots, they are pointed at the default image instead of the replaced views.
+	for (VkDescriptorImageInfo& descriptorInfo : m_DescriptorInfos)
+	{
+		CreateDescriptorInfo(m_DefaultImage->GetImageView(), m_Sampler->GetSampler(), descriptorInfo);
+	}
+}
+
+FT_END_NAMESPACE
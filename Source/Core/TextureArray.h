@@ -0,0 +1,52 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+class Device;
+class Image;
+class Sampler;
+struct SamplerInfo;
+
+rapidjson::Value SerializeTextureArray(const std::vector<std::string>& inImagePaths, const SamplerInfo& inSamplerInfo, rapidjson::Document::AllocatorType& inAllocator);
+bool DeserializeTextureArray(const rapidjson::Value& inTextureArrayJson, std::vector<std::string>& outImagePaths, SamplerInfo& outSamplerInfo);
+
+// Images of a runtime sized combined image sampler array, all sharing one sampler. The array is partially bound,
+// so only the first GetCount() of the GetCapacity() slots hold an image. Slots vacated by loading fewer images point at
+// the default image, so the first GetDescriptorCount() slots written into the descriptor set never reference a destroyed view.
+// Replaced images and samplers are handed back instead of destroyed, since frames in flight might still sample them.
+class TextureArray
+{
+public:
+	TextureArray(const Device* inDevice, const uint32_t inCapacity, const std::vector<std::string>& inImagePaths, const SamplerInfo& inSamplerInfo,
+		const std::string& inDefaultImagePath);
+	~TextureArray();
+	FT_DELETE_COPY_AND_MOVE(TextureArray)
+
+public:
+	void LoadFolder(const std::string& inFolderPath, std::vector<Image*>& outReplacedImages);
+	void LoadImages(const std::vector<std::string>& inImagePaths, std::vector<Image*>& outReplacedImages);
+	Image* UpdateImage(const uint32_t inSlot, const std::string& inImagePath);
+	Sampler* UpdateSampler(const SamplerInfo& inSamplerInfo);
+
+public:
+	uint32_t GetCount() const { return static_cast<uint32_t>(m_Images.size()); }
+	uint32_t GetCapacity() const { return m_Capacity; }
+	uint32_t GetDescriptorCount() const { return static_cast<uint32_t>(m_DescriptorInfos.size()); }
+	const Image* GetImage(const uint32_t inSlot) const { return m_Images[inSlot]; }
+	const Sampler* GetSampler() const { return m_Sampler; }
+	const VkDescriptorImageInfo* GetDescriptorInfos() const { return m_DescriptorInfos.data(); }
+	std::vector<std::string> GetImagePaths() const;
+
+private:
+	void ClearImages(std::vector<Image*>& outReplacedImages);
+
+private:
+	const Device* m_Device;
+	uint32_t m_Capacity;
+	std::vector<Image*> m_Images;
+	const Image* m_DefaultImage;
+	Sampler* m_Sampler;
+	std::vector<VkDescriptorImageInfo> m_DescriptorInfos;
+};
+
+FT_END_NAMESPACE
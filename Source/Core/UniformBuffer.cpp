@@ -1,7 +1,4 @@
 #include "UniformBuffer.h"
-#include "Device.h"
-#include "Swapchain.h"
-#include "Buffer.h"
 
 FT_BEGIN_NAMESPACE
 
@@ -66,38 +63,114 @@ bool DeserializeUniformBuffer(const rapidjson::Value& inUniformBufferJson, size_
 	return true;
 }
 
-UniformBuffer::UniformBuffer(const Device* inDevice, const Swapchain* inSwapchain, const size_t inSize,
+UniformBuffer::UniformBuffer(UniformBufferRing* inRing, const size_t inSize,
 	unsigned char* inProxyMemory, unsigned char* inVectorState)
-	: m_Size(inSize)
+	: m_Ring(inRing)
 	, m_ProxyMemory(inProxyMemory != nullptr ? inProxyMemory : new unsigned char[inSize]())
 	, m_VectorState(inVectorState != nullptr ? inVectorState : new unsigned char[inSize]())
+	, m_Size(inSize)
 {
-	m_Buffers.resize(inSwapchain->GetImageCount());
-	for (uint32_t imageIndex = 0; imageIndex < inSwapchain->GetImageCount(); ++imageIndex)
+	Allocate();
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	m_Ring->Free(m_Allocation);
+
+	delete[](m_VectorState);
+	delete[](m_ProxyMemory);
+}
+
+void UniformBuffer::UpdateMemory(const size_t inSize, unsigned char* inProxyMemory, unsigned char* inVectorState)
+{
+	delete[](m_VectorState);
+	delete[](m_ProxyMemory);
+
+	m_ProxyMemory = inProxyMemory;
+	m_VectorState = inVectorState;
+
+	// Same sized block keeps its range, the changed bytes are found and uploaded like any other edit.
+	if (inSize == m_Size)
 	{
-		m_Buffers[imageIndex] = new Buffer(inDevice, m_Size, BufferUsageFlags::Uniform);
-		m_Buffers[imageIndex]->Map();
+		return;
 	}
+
+	// Callers wait for the queue first, so the previous range can be reused right away.
+	m_Ring->Free(m_Allocation);
+	m_Size = inSize;
+	Allocate();
 }
 
-UniformBuffer::~UniformBuffer()
+void UniformBuffer::ResetRegions()
+{
+	const uint32_t regionCount = m_Ring->GetRegionCount();
+	const VkBuffer buffer = m_Ring->GetBuffer(m_Allocation);
+	const VkDeviceSize regionSize = m_Ring->GetRegionSize(m_Allocation);
+
+	m_DescriptorInfos.resize(regionCount);
+	for (uint32_t regionIndex = 0; regionIndex < regionCount; ++regionIndex)
+	{
+		VkDescriptorBufferInfo& descriptorInfo = m_DescriptorInfos[regionIndex];
+		descriptorInfo.buffer = buffer;
+		descriptorInfo.offset = regionIndex * regionSize + m_Allocation.Offset;
+		descriptorInfo.range = std::max<VkDeviceSize>(m_Size, 1);
+	}
+
+	// Regions were never written, or their contents are gone along with the previous buffer.
+	DirtyRange dirtyRange;
+	dirtyRange.End = m_Size;
+	m_DirtyRanges.assign(regionCount, dirtyRange);
+}
+
+void UniformBuffer::UpdateDeviceMemory(const uint32_t inCurrentImage)
 {
-	for (uint32_t bufferIndex = 0; bufferIndex < m_Buffers.size(); ++bufferIndex)
+	// Values are edited in place, so changes since the last frame are found by comparing against the previous copy.
+	// Scanning host memory is much cheaper than writing unchanged bytes into mapped device memory.
+	size_t changedBegin = 0;
+	while (changedBegin < m_Size && m_ProxyMemory[changedBegin] == m_ShadowMemory[changedBegin])
 	{
-		delete(m_Buffers[bufferIndex]);
+		++changedBegin;
 	}
 
-	m_Buffers.clear();
-	delete[](m_VectorState);
-	delete[](m_ProxyMemory);
+	if (changedBegin < m_Size)
+	{
+		size_t changedEnd = m_Size;
+		while (m_ProxyMemory[changedEnd - 1] == m_ShadowMemory[changedEnd - 1])
+		{
+			--changedEnd;
+		}
+
+		memcpy(m_ShadowMemory.data() + changedBegin, m_ProxyMemory + changedBegin, changedEnd - changedBegin);
+
+		// Regions of other images are written once their frames come around again.
+		for (DirtyRange& dirtyRange : m_DirtyRanges)
+		{
+			const bool isEmpty = dirtyRange.Begin >= dirtyRange.End;
+			dirtyRange.Begin = isEmpty ? changedBegin : std::min(dirtyRange.Begin, changedBegin);
+			dirtyRange.End = isEmpty ? changedEnd : std::max(dirtyRange.End, changedEnd);
+		}
+	}
+
+	DirtyRange& dirtyRange = m_DirtyRanges[inCurrentImage];
+	if (dirtyRange.Begin >= dirtyRange.End)
+	{
+		return;
+	}
+
+	memcpy(m_Ring->GetHostVisibleData(m_Allocation, inCurrentImage) + dirtyRange.Begin, m_ProxyMemory + dirtyRange.Begin, dirtyRange.End - dirtyRange.Begin);
+	dirtyRange = DirtyRange();
+}
+
+uint32_t UniformBuffer::GetDynamicOffset(const uint32_t inImageIndex) const
+{
+	return static_cast<uint32_t>(inImageIndex * m_Ring->GetRegionSize(m_Allocation));
 }
 
-void UniformBuffer::UpdateDeviceMemory(uint32_t inCurrentImage)
+void UniformBuffer::Allocate()
 {
-	// Map/Unmap each frame should be slower on Vulkan, but rather mapping the memory only once in constructor.
-	// This is called persistently mapped memory.
-	// Faster for the driver to deal with and easier to use. This is not tested.
-	memcpy(m_Buffers[inCurrentImage]->GetHostVisibleData(), m_ProxyMemory, m_Size);
+	m_Allocation = m_Ring->Allocate(m_Size);
+	m_ShadowMemory.assign(m_ProxyMemory, m_ProxyMemory + m_Size);
+	ResetRegions();
 }
 
 FT_END_NAMESPACE
@@ -1,39 +1,59 @@
 #pragma once
 
-FT_BEGIN_NAMESPACE
+#include "UniformBufferRing.h"
 
-class Device;
-class Swapchain;
-class Buffer;
+FT_BEGIN_NAMESPACE
 
 rapidjson::Value SerializeUniformBuffer(const size_t inSize, const unsigned char* inProxyMemory,
 	const unsigned char* inVectorState, rapidjson::Document::AllocatorType& inAllocator);
 bool DeserializeUniformBuffer(const rapidjson::Value& inImageJson, size_t& outSize,
 	unsigned char*& outProxyMemory, unsigned char*& outVectorState);
 
+// Uniform block edited through a proxy copy in host memory. Device memory is suballocated from the ring, and only the
+// bytes which changed since a region was last written are copied into it.
 class UniformBuffer
 {
 public:
-	UniformBuffer(const Device* inDevice, const Swapchain* inSwapchain, const size_t inSize,
+	UniformBuffer(UniformBufferRing* inRing, const size_t inSize,
 		unsigned char* inProxyMemory = nullptr, unsigned char* inVectorState = nullptr);
 	~UniformBuffer();
 	FT_DELETE_COPY_AND_MOVE(UniformBuffer)
 
 public:
-	void UpdateDeviceMemory(uint32_t inCurrentImage);
+	void UpdateMemory(const size_t inSize, unsigned char* inProxyMemory, unsigned char* inVectorState);
+	void ResetRegions();
+	void UpdateDeviceMemory(const uint32_t inCurrentImage);
 
 public:
-	Buffer* GetBuffer(const uint32_t inBufferIndex) const { return m_Buffers[inBufferIndex]; }
-	size_t GetBufferCount() const { return m_Buffers.size(); }
+	const VkDescriptorBufferInfo* GetDescriptorInfo(const uint32_t inImageIndex) const { return &m_DescriptorInfos[inImageIndex]; }
+	uint32_t GetDynamicOffset(const uint32_t inImageIndex) const;
 	size_t GetSize() const { return m_Size; }
 	unsigned char* GetProxyMemory() const {	return m_ProxyMemory; }
 	unsigned char* GetVectorState() const {	return m_VectorState; }
 
 private:
-	std::vector<Buffer*> m_Buffers;
+	void Allocate();
+
+private:
+	// Range of bytes a region is missing, empty once its begin reaches the end.
+	struct DirtyRange
+	{
+		size_t Begin = 0;
+		size_t End = 0;
+	};
+
+	UniformBufferRing* m_Ring;
+	UniformBufferAllocation m_Allocation;
 	unsigned char* m_ProxyMemory;
 	unsigned char* m_VectorState;
 	size_t m_Size;
+
+	// Proxy memory as it was when changes were last looked for, the user interface writes into the proxy directly.
+	std::vector<unsigned char> m_ShadowMemory;
+
+	// Indexed by swapchain image.
+	std::vector<DirtyRange> m_DirtyRanges;
+	std::vector<VkDescriptorBufferInfo> m_DescriptorInfos;
 };
 
 FT_END_NAMESPACE
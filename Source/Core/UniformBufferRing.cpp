@@ -0,0 +1,168 @@
+#include "UniformBufferRing.h"
+#include "Device.h"
+#include "Swapchain.h"
+#include "Buffer.h"
+
+FT_BEGIN_NAMESPACE
+
+// Fits dozens of typical blocks, larger ones get a page of their own.
+static const VkDeviceSize DefaultRegionSize = 64 * 1024;
+
+static VkDeviceSize AlignSize(const VkDeviceSize inSize, const VkDeviceSize inAlignment)
+{
+	return (inSize + inAlignment - 1) / inAlignment * inAlignment;
+}
+
+UniformBufferRing::UniformBufferRing(const Device* inDevice, const Swapchain* inSwapchain)
+	: m_Device(inDevice)
+	, m_RegionCount(inSwapchain->GetImageCount())
+	, m_Alignment(std::max<VkDeviceSize>(inDevice->GetMinUniformBufferOffsetAlignment(), 1))
+{
+}
+
+UniformBufferRing::~UniformBufferRing()
+{
+	for (Page& page : m_Pages)
+	{
+		FT_CHECK(page.AllocationCount == 0, "Uniform buffers have to be destroyed before the ring.");
+		delete(page.RegionBuffer);
+	}
+}
+
+UniformBufferAllocation UniformBufferRing::Allocate(const size_t inSize)
+{
+	const VkDeviceSize size = AlignSize(std::max<VkDeviceSize>(inSize, 1), m_Alignment);
+
+	UniformBufferAllocation allocation;
+	allocation.Size = inSize;
+
+	// First fit, blocks are few and mostly allocated in bulk when a shader is loaded.
+	for (uint32_t pageIndex = 0; pageIndex < m_Pages.size(); ++pageIndex)
+	{
+		Page& page = m_Pages[pageIndex];
+		for (auto freeRangeIterator = page.FreeRanges.begin(); freeRangeIterator != page.FreeRanges.end(); ++freeRangeIterator)
+		{
+			if (freeRangeIterator->second < size)
+			{
+				continue;
+			}
+
+			allocation.PageIndex = pageIndex;
+			allocation.Offset = freeRangeIterator->first;
+
+			const VkDeviceSize remainingSize = freeRangeIterator->second - size;
+			page.FreeRanges.erase(freeRangeIterator);
+			if (remainingSize > 0)
+			{
+				page.FreeRanges[allocation.Offset + size] = remainingSize;
+			}
+
+			++page.AllocationCount;
+			return allocation;
+		}
+	}
+
+	uint32_t pageIndex = 0;
+	while (pageIndex < m_Pages.size() && m_Pages[pageIndex].RegionBuffer != nullptr)
+	{
+		++pageIndex;
+	}
+
+	if (pageIndex == m_Pages.size())
+	{
+		m_Pages.push_back(Page());
+	}
+
+	Page& page = m_Pages[pageIndex];
+	page.RegionSize = std::max(DefaultRegionSize, size);
+	page.AllocationCount = 1;
+	page.FreeRanges.clear();
+	if (page.RegionSize > size)
+	{
+		page.FreeRanges[size] = page.RegionSize - size;
+	}
+
+	CreatePageBuffer(page);
+
+	allocation.PageIndex = pageIndex;
+	allocation.Offset = 0;
+	return allocation;
+}
+
+void UniformBufferRing::Free(const UniformBufferAllocation& inAllocation)
+{
+	FT_CHECK(inAllocation.PageIndex < m_Pages.size(), "Uniform buffer page index is out of bounds.");
+
+	Page& page = m_Pages[inAllocation.PageIndex];
+	FT_CHECK(page.AllocationCount > 0, "Uniform buffer page has no allocations.");
+
+	VkDeviceSize offset = inAllocation.Offset;
+	VkDeviceSize size = AlignSize(std::max<VkDeviceSize>(inAllocation.Size, 1), m_Alignment);
+
+	auto nextIterator = page.FreeRanges.lower_bound(offset);
+	if (nextIterator != page.FreeRanges.end() && nextIterator->first == offset + size)
+	{
+		size += nextIterator->second;
+		nextIterator = page.FreeRanges.erase(nextIterator);
+	}
+
+	if (nextIterator != page.FreeRanges.begin())
+	{
+		const auto previousIterator = std::prev(nextIterator);
+		if (previousIterator->first + previousIterator->second == offset)
+		{
+			offset = previousIterator->first;
+			size += previousIterator->second;
+			page.FreeRanges.erase(previousIterator);
+		}
+	}
+
+	page.FreeRanges[offset] = size;
+
+	// Oversized pages only hold a single large block, so they are released right away instead of being kept around.
+	if (--page.AllocationCount == 0 && page.RegionSize > DefaultRegionSize)
+	{
+		delete(page.RegionBuffer);
+		page = Page();
+	}
+}
+
+void UniformBufferRing::Recreate(const Swapchain* inSwapchain)
+{
+	// Allocations keep their offsets, only the number of regions changes. Contents are lost, so buffers upload everything again.
+	m_RegionCount = inSwapchain->GetImageCount();
+	for (Page& page : m_Pages)
+	{
+		if (page.RegionBuffer != nullptr)
+		{
+			delete(page.RegionBuffer);
+			CreatePageBuffer(page);
+		}
+	}
+}
+
+VkBuffer UniformBufferRing::GetBuffer(const UniformBufferAllocation& inAllocation) const
+{
+	return m_Pages[inAllocation.PageIndex].RegionBuffer->GetBuffer();
+}
+
+VkDeviceSize UniformBufferRing::GetRegionSize(const UniformBufferAllocation& inAllocation) const
+{
+	return m_Pages[inAllocation.PageIndex].RegionSize;
+}
+
+unsigned char* UniformBufferRing::GetHostVisibleData(const UniformBufferAllocation& inAllocation, const uint32_t inRegionIndex) const
+{
+	const Page& page = m_Pages[inAllocation.PageIndex];
+	unsigned char* hostVisibleData = static_cast<unsigned char*>(page.RegionBuffer->GetHostVisibleData());
+	return hostVisibleData + inRegionIndex * page.RegionSize + inAllocation.Offset;
+}
+
+void UniformBufferRing::CreatePageBuffer(Page& inOutPage) const
+{
+	// Persistently mapped, host coherent memory needs no flushes, writes are visible to the next submission.
+	inOutPage.RegionBuffer = new Buffer(m_Device, m_RegionCount * inOutPage.RegionSize, BufferUsageFlags::Uniform);
+	inOutPage.RegionBuffer->Map();
+}
+
+FT_END_NAMESPACE
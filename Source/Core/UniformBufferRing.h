@@ -0,0 +1,60 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+class Device;
+class Swapchain;
+class Buffer;
+
+// Range of a page which is reserved in every region, so the same offset is valid for each swapchain image.
+struct UniformBufferAllocation
+{
+	uint32_t PageIndex = 0;
+	VkDeviceSize Offset = 0;
+	VkDeviceSize Size = 0;
+};
+
+// Uniform buffers are suballocated from a few persistently mapped pages instead of having buffers of their own. Every page is
+// split into one region per swapchain image, so a buffer is written into the region of the acquired image while frames in
+// flight read the others, and its descriptor only differs by a dynamic offset between images.
+class UniformBufferRing
+{
+public:
+	UniformBufferRing(const Device* inDevice, const Swapchain* inSwapchain);
+	~UniformBufferRing();
+	FT_DELETE_COPY_AND_MOVE(UniformBufferRing)
+
+public:
+	UniformBufferAllocation Allocate(const size_t inSize);
+	void Free(const UniformBufferAllocation& inAllocation);
+	void Recreate(const Swapchain* inSwapchain);
+
+public:
+	uint32_t GetRegionCount() const { return m_RegionCount; }
+	VkBuffer GetBuffer(const UniformBufferAllocation& inAllocation) const;
+	VkDeviceSize GetRegionSize(const UniformBufferAllocation& inAllocation) const;
+	unsigned char* GetHostVisibleData(const UniformBufferAllocation& inAllocation, const uint32_t inRegionIndex) const;
+
+private:
+	struct Page
+	{
+		Buffer* RegionBuffer = nullptr;
+		VkDeviceSize RegionSize = 0;
+		uint32_t AllocationCount = 0;
+
+		// Free ranges of a region by their offset, neighbouring ones are merged when freed.
+		std::map<VkDeviceSize, VkDeviceSize> FreeRanges;
+	};
+
+	void CreatePageBuffer(Page& inOutPage) const;
+
+private:
+	const Device* m_Device;
+	uint32_t m_RegionCount;
+	VkDeviceSize m_Alignment;
+
+	// Emptied pages are released and their slot is reused, so indices of live allocations stay valid.
+	std::vector<Page> m_Pages;
+};
+
+FT_END_NAMESPACE
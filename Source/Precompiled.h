@@ -17,7 +17,21 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <cstdio>
+#include <cstdarg>
 #include <chrono>
+#include <ctime>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <list>
+#include <map>
+#include <set>
+#include <tuple>
+#include <algorithm>
 
 #define FT_BEGIN_NAMESPACE namespace FT \
 	{
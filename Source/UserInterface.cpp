@@ -8,6 +8,10 @@
 #include "Core/Image.h"
 #include "Core/Sampler.h"
 #include "Core/UniformBuffer.h"
+#include "Core/StorageBuffer.h"
+#include "Core/TextureArray.h"
+#include "Core/MemoryAllocator.h"
+#include "Compiler/ShaderOptimizer.h"
 #include "Utility/ShaderFile.h"
 #include "Utility/FileExplorer.h"
 #include "Utility/FilePath.h"
@@ -66,7 +70,7 @@ UserInterface::UserInterface(Application* inApplication)
 	vulkanImplementationInitInfo.Device = device->GetDevice();
 	vulkanImplementationInitInfo.QueueFamily = device->GetGraphicsQueueFamilyIndex();
 	vulkanImplementationInitInfo.Queue = device->GetGraphicsQueue();
-	vulkanImplementationInitInfo.PipelineCache = VK_NULL_HANDLE;
+	vulkanImplementationInitInfo.PipelineCache = device->GetPipelineCache();
 	vulkanImplementationInitInfo.DescriptorPool = imguiDescPool;
 	vulkanImplementationInitInfo.Allocator = nullptr;
 	vulkanImplementationInitInfo.MinImageCount = swapchain->GetImageCount();
@@ -133,7 +137,7 @@ void UserInterface::ImguiNewFrame()
 
 		if (m_ShowOutput)
 		{
-			ImGuiLogger::Draw("Log");
+			ImguiLogWindow();
 		}
 
 		if (m_ShowBindings)
@@ -160,8 +164,38 @@ void UserInterface::SetEditorText(const std::string& inText)
 	return m_Editor.SetText(inText);
 }
 
+// Only highlights the disassembly, which is never edited.
+static const TextEditor::LanguageDefinition& GetSpirvLanguageDefinition()
+{
+	static TextEditor::LanguageDefinition languageDefinition;
+	if (!languageDefinition.mName.empty())
+	{
+		return languageDefinition;
+	}
+
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("Op[a-zA-Z0-9]+", TextEditor::PaletteIndex::Keyword));
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("%[a-zA-Z0-9_]+", TextEditor::PaletteIndex::Identifier));
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("L?\\\"(\\\\.|[^\\\"])*\\\"", TextEditor::PaletteIndex::String));
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("[+-]?[0-9]+[.]?[0-9]*([eE][+-]?[0-9]+)?", TextEditor::PaletteIndex::Number));
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("0[xX][0-9a-fA-F]+", TextEditor::PaletteIndex::Number));
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("[a-zA-Z_][a-zA-Z0-9_]*", TextEditor::PaletteIndex::Identifier));
+	languageDefinition.mTokenRegexStrings.push_back(std::make_pair<std::string, TextEditor::PaletteIndex>("[=|]", TextEditor::PaletteIndex::Punctuation));
+
+	languageDefinition.mCommentStart = "/*";
+	languageDefinition.mCommentEnd = "*/";
+	languageDefinition.mSingleLineComment = ";";
+	languageDefinition.mCaseSensitive = true;
+	languageDefinition.mAutoIndentation = false;
+	languageDefinition.mName = "SPIR-V";
+
+	return languageDefinition;
+}
+
 void UserInterface::SetEditorLanguage(const ShaderLanguage inLanguage)
 {
+	// Precompiled shaders are shown as a disassembly, which can't be compiled back.
+	m_Editor.SetReadOnly(inLanguage == ShaderLanguage::SPIRV);
+
 	switch (inLanguage)
 	{
 	case ShaderLanguage::GLSL:
@@ -172,6 +206,10 @@ void UserInterface::SetEditorLanguage(const ShaderLanguage inLanguage)
 		m_Editor.SetLanguageDefinition(TextEditor::LanguageDefinition::HLSL());
 		return;
 
+	case ShaderLanguage::SPIRV:
+		m_Editor.SetLanguageDefinition(GetSpirvLanguageDefinition());
+		return;
+
 	default:
 		FT_FAIL("Unsupported ShaderLanguage.");
 	}
@@ -400,11 +438,27 @@ void UserInterface::ImguiMenuBar()
 
 			ImGui::Separator();
 
-			if (ImGui::MenuItem("Compile", "Ctrl-R", nullptr))
+			if (ImGui::MenuItem(m_Application->GetRenderer()->GetFragmentShaderFile()->IsPrecompiled() ? "Reload" : "Compile", "Ctrl-R", nullptr))
 			{
 				m_Application->RecompileFragmentShader();
 			}
 
+			// Precompiled shaders are loaded as they are, they were already optimized when they were built.
+			if (ImGui::BeginMenu("Optimization", !m_Application->GetRenderer()->GetFragmentShaderFile()->IsPrecompiled()))
+			{
+				const ShaderOptimizationLevel currentOptimizationLevel = m_Application->GetRenderer()->GetFragmentShaderFile()->GetOptimizationLevel();
+				for (uint8_t levelIndex = 0; levelIndex < static_cast<uint8_t>(ShaderOptimizationLevel::Count); ++levelIndex)
+				{
+					const ShaderOptimizationLevel optimizationLevel = static_cast<ShaderOptimizationLevel>(levelIndex);
+					if (ImGui::MenuItem(ShaderOptimizer::GetLevelText(optimizationLevel), nullptr, optimizationLevel == currentOptimizationLevel))
+					{
+						m_Application->SetOptimizationLevel(optimizationLevel);
+					}
+				}
+
+				ImGui::EndMenu();
+			}
+
 			ImGui::Separator();
 
 			if (ImGui::MenuItem("Select all", "Ctrl-A", nullptr))
@@ -931,9 +985,7 @@ void UserInterface::DrawImage(const Descriptor& inDescriptor, bool inDraw)
 		std::string imagePath;
 		if (FileExplorer::OpenImageDialog(imagePath))
 		{
-			m_Renderer->WaitQueueToFinish();
 			m_Renderer->UpdateImageDescriptor(inDescriptor.Index, imagePath);
-			m_Renderer->RecreateDescriptorSet();
 		}
 	}
 
@@ -1042,12 +1094,107 @@ void UserInterface::DrawSampler(const SamplerInfo& inSamplerInfo, const Descript
 
 	if (inSamplerInfo != newSamplerInfo)
 	{
-		m_Renderer->WaitQueueToFinish();
 		m_Renderer->UpdateSamplerDescriptor(inDescriptor.Index, newSamplerInfo);
-		m_Renderer->RecreateDescriptorSet();
 	}
 }
 
+void UserInterface::DrawStorageBuffer(const Descriptor& inDescriptor, bool inDraw)
+{
+	if (!inDraw)
+	{
+		return;
+	}
+
+	const StorageBuffer* storageBuffer = inDescriptor.Resource.Handle.StorageBuffer;
+
+	ImGui::PushID(inDescriptor.Binding.DescriptorSetBinding.binding);
+
+	if (storageBuffer->HasData())
+	{
+		ImGui::Text("%s", ExtractFileName(storageBuffer->GetDataPath()).c_str());
+		ImGui::Text("Size: %.2f MB", storageBuffer->GetSize() / (1024.0 * 1024.0));
+	}
+	else
+	{
+		ImGui::TextDisabled("No data, %u zeroed bytes.", static_cast<uint32_t>(storageBuffer->GetSize()));
+	}
+
+	std::string dataPath;
+	if (ImGui::Button(" Load Data ") && FileExplorer::OpenDataDialog(dataPath))
+	{
+		m_Renderer->UpdateStorageBufferDescriptor(inDescriptor.Index, dataPath);
+	}
+	else if (storageBuffer->HasData())
+	{
+		ImGui::SameLine();
+		if (ImGui::Button(" Reload "))
+		{
+			// Path is copied, the storage buffer owning it is replaced by the update.
+			dataPath = storageBuffer->GetDataPath();
+
+			m_Renderer->UpdateStorageBufferDescriptor(inDescriptor.Index, dataPath);
+		}
+		else if (storageBuffer->IsDataModified())
+		{
+			ImGui::SameLine();
+			ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "Modified on disk");
+		}
+	}
+
+	ImGui::PopID();
+}
+
+void UserInterface::DrawTextureArray(const Descriptor& inDescriptor, bool inDraw)
+{
+	if (!inDraw)
+	{
+		return;
+	}
+
+	const TextureArray* textureArray = inDescriptor.Resource.Handle.TextureArray;
+
+	ImGui::PushID(inDescriptor.Binding.DescriptorSetBinding.binding);
+
+	ImGui::Text("Images: %u / %u", textureArray->GetCount(), textureArray->GetCapacity());
+
+	std::string path;
+	if (ImGui::Button(" Load Folder ") && FileExplorer::OpenFolderDialog(path))
+	{
+		m_Renderer->UpdateTextureArrayFolderDescriptor(inDescriptor.Index, path);
+	}
+
+	if (textureArray->GetCount() < textureArray->GetCapacity())
+	{
+		ImGui::SameLine();
+		if (ImGui::Button(" Add Image ") && FileExplorer::OpenImageDialog(path))
+		{
+			m_Renderer->UpdateTextureArrayImageDescriptor(inDescriptor.Index, textureArray->GetCount(), path);
+		}
+	}
+
+	if (textureArray->GetCount() > 0 && ImGui::TreeNode("Slots"))
+	{
+		for (uint32_t slot = 0; slot < textureArray->GetCount(); ++slot)
+		{
+			ImGui::PushID(slot);
+
+			if (ImGui::Button(" Replace ") && FileExplorer::OpenImageDialog(path))
+			{
+				m_Renderer->UpdateTextureArrayImageDescriptor(inDescriptor.Index, slot, path);
+			}
+
+			ImGui::SameLine();
+			ImGui::Text("[%u] %s", slot, ExtractFileName(textureArray->GetImage(slot)->GetPath()).c_str());
+
+			ImGui::PopID();
+		}
+
+		ImGui::TreePop();
+	}
+
+	ImGui::PopID();
+}
+
 void UserInterface::DrawUniformBufferInput(const SpvReflectBlockVariable* inReflectBlock, unsigned char* inProxyMemory, unsigned char* inVectorState, bool inDraw, const uint32_t inArrayDimension, const char* inArrayNameSuffix)
 {
 	if (inReflectBlock == nullptr)
@@ -1161,6 +1308,266 @@ void UserInterface::DrawUniformBufferInput(const SpvReflectBlockVariable* inRefl
 	}
 }
 
+void UserInterface::DrawShaderVariants()
+{
+	const std::vector<ShaderVariantDefine>& variantDefines = m_Renderer->GetFragmentShaderFile()->GetVariantDefines();
+	if (variantDefines.empty())
+	{
+		return;
+	}
+
+	if (!ImGui::CollapsingHeader("Variants"))
+	{
+		return;
+	}
+
+	ImGui::Indent();
+	ImGui::Text("%u compiled variants, %u unique modules", m_Renderer->GetShaderVariantCount(), m_Renderer->GetUniqueShaderVariantCount());
+	ImGui::Spacing();
+
+	for (uint32_t defineIndex = 0; defineIndex < variantDefines.size(); ++defineIndex)
+	{
+		const ShaderVariantDefine& variantDefine = variantDefines[defineIndex];
+
+		ImGui::PushID(defineIndex);
+
+		int selectedValue = static_cast<int>(variantDefine.SelectedValue);
+		const bool valueChanged = ImGui::Combo(variantDefine.Name.c_str(), &selectedValue, [](void* inData, int inIndex, const char** outText)
+			{
+				*outText = static_cast<const std::vector<std::string>*>(inData)->at(inIndex).c_str();
+				return true;
+			}, const_cast<std::vector<std::string>*>(&variantDefine.Values), static_cast<int>(variantDefine.Values.size()));
+
+		ImGui::PopID();
+
+		if (valueChanged)
+		{
+			m_Application->SelectShaderVariant(defineIndex, static_cast<uint32_t>(selectedValue));
+		}
+	}
+
+	ImGui::Unindent();
+	ImGui::Spacing();
+}
+
+void UserInterface::DrawSpecializationConstants()
+{
+	std::vector<SpecializationConstant> specializationConstants = m_Renderer->GetSpecializationConstants();
+	if (specializationConstants.empty())
+	{
+		return;
+	}
+
+	if (!ImGui::CollapsingHeader("Specialization Constants"))
+	{
+		return;
+	}
+
+	ImGui::Indent();
+
+	for (SpecializationConstant& specializationConstant : specializationConstants)
+	{
+		ImGui::PushID(specializationConstant.ConstantId);
+
+		bool valueChanged = false;
+		switch (specializationConstant.Type)
+		{
+		case SpecializationConstantType::Bool:
+		{
+			bool value = specializationConstant.Value != 0;
+			valueChanged = ImGui::Checkbox(specializationConstant.Name.c_str(), &value);
+			specializationConstant.Value = value ? 1 : 0;
+			break;
+		}
+
+		case SpecializationConstantType::Int:
+			valueChanged = ImGui::DragScalar(specializationConstant.Name.c_str(), ImGuiDataType_S32, &specializationConstant.Value, 0.1f);
+			break;
+
+		case SpecializationConstantType::UInt:
+			valueChanged = ImGui::DragScalar(specializationConstant.Name.c_str(), ImGuiDataType_U32, &specializationConstant.Value, 0.1f);
+			break;
+
+		case SpecializationConstantType::Float:
+			valueChanged = ImGui::DragScalar(specializationConstant.Name.c_str(), ImGuiDataType_Float, &specializationConstant.Value, 0.01f);
+			break;
+
+		default:
+			FT_FAIL("Unsupported SpecializationConstantType.");
+		}
+
+		if (valueChanged)
+		{
+			m_Renderer->UpdateSpecializationConstant(specializationConstant);
+		}
+
+		// Dragging only stores the value, the pipeline is specialized again once the edit is done instead of every frame.
+		// Only the pipeline is rebuilt, the shader isn't recompiled.
+		if (ImGui::IsItemDeactivatedAfterEdit())
+		{
+			m_Renderer->ApplySpecializationConstants();
+		}
+
+		ImGui::PopID();
+	}
+
+	if (ImGui::Button("Reset to Defaults"))
+	{
+		m_Renderer->ResetSpecializationConstants();
+	}
+
+	ImGui::Unindent();
+	ImGui::Spacing();
+}
+
+void UserInterface::DrawPrecisionComparison()
+{
+	static const char* PrecisionViewNames[] = { "Reference", "Relaxed", "Error" };
+	static_assert(sizeof(PrecisionViewNames) / sizeof(PrecisionViewNames[0]) == static_cast<size_t>(PrecisionView::Count), "Missing precision view name.");
+
+	if (!ImGui::CollapsingHeader("Precision"))
+	{
+		return;
+	}
+
+	ImGui::Indent();
+
+	bool compareEnabled = m_Renderer->GetPrecisionComparison() != nullptr;
+	if (ImGui::Checkbox("Compare Relaxed Precision", &compareEnabled))
+	{
+		m_Renderer->SetPrecisionComparison(compareEnabled);
+	}
+
+	const PrecisionComparison* precisionComparison = m_Renderer->GetPrecisionComparison();
+	if (precisionComparison)
+	{
+		ImGui::Text("Mode: %s", m_Renderer->GetDevice()->IsShaderFloat16Supported() ? "FP16" : "RelaxedPrecision");
+
+		if (!m_Renderer->HasRelaxedPipeline())
+		{
+			ImGui::TextDisabled(m_Renderer->IsRelaxedPipelineBuildPending() ? "Relaxed variant is being built." : "Relaxed variant failed, see output.");
+		}
+		else if (!m_Renderer->GetDevice()->AreTimestampsSupported())
+		{
+			ImGui::TextDisabled("GPU timestamps aren't supported.");
+		}
+		else if (precisionComparison->HasTimings())
+		{
+			const double referenceTime = precisionComparison->GetReferenceTime();
+			const double relaxedTime = precisionComparison->GetRelaxedTime();
+			const double deltaTime = relaxedTime - referenceTime;
+
+			ImGui::Text("Reference: %.3f ms", referenceTime);
+			ImGui::Text("Relaxed: %.3f ms", relaxedTime);
+			ImGui::Text("Delta: %+.3f ms (%+.1f%%)", deltaTime, referenceTime > 0.0 ? 100.0 * deltaTime / referenceTime : 0.0);
+		}
+
+		int selectedView = static_cast<int>(m_Renderer->GetPrecisionView());
+		if (ImGui::Combo("View", &selectedView, PrecisionViewNames, static_cast<int>(PrecisionView::Count)))
+		{
+			m_Renderer->SetPrecisionView(static_cast<PrecisionView>(selectedView));
+		}
+
+		float errorScale = m_Renderer->GetPrecisionErrorScale();
+		if (ImGui::DragFloat("Error Scale", &errorScale, 0.5f, 1.0f, 1024.0f, "%.1f"))
+		{
+			m_Renderer->SetPrecisionErrorScale(errorScale);
+		}
+	}
+
+	ImGui::Unindent();
+	ImGui::Spacing();
+}
+
+void UserInterface::DrawMemoryStatistics()
+{
+	static const double BytesPerMegabyte = 1024.0 * 1024.0;
+
+	if (!ImGui::CollapsingHeader("Memory"))
+	{
+		return;
+	}
+
+	ImGui::Indent();
+
+	const MemoryAllocator* memoryAllocator = m_Renderer->GetDevice()->GetMemoryAllocator();
+	const MemoryStatistics statistics = memoryAllocator->GetStatistics();
+
+	// Device allocations are limited, every block counts against the limit while resources within it don't.
+	ImGui::Text("Device Allocations: %u (limit %u)", statistics.DeviceAllocationCount, memoryAllocator->GetMaxAllocationCount());
+	ImGui::Text("Blocks: %u, Resources: %u", statistics.BlockCount, statistics.AllocationCount);
+	ImGui::Text("Used: %.2f / %.2f MB", statistics.UsedSize / BytesPerMegabyte, statistics.BlockSize / BytesPerMegabyte);
+
+	for (const MemoryPoolStatistics& poolStatistics : memoryAllocator->GetPoolStatistics())
+	{
+		ImGui::BulletText("Type %u %s %s: %u blocks, %u resources, %.2f / %.2f MB", poolStatistics.MemoryTypeIndex,
+			(poolStatistics.PropertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ? "DeviceLocal" : "HostVisible",
+			poolStatistics.ResourceKind == MemoryResourceKind::Linear ? "Linear" : "Optimal",
+			poolStatistics.BlockCount, poolStatistics.AllocationCount, poolStatistics.UsedSize / BytesPerMegabyte, poolStatistics.BlockSize / BytesPerMegabyte);
+	}
+
+	ImGui::Unindent();
+	ImGui::Spacing();
+}
+
+void UserInterface::DrawPushConstants()
+{
+	const SpvReflectBlockVariable* pushConstantBlock = m_Renderer->GetPushConstantBlock();
+	if (pushConstantBlock == nullptr)
+	{
+		return;
+	}
+
+	const bool isHeaderOpen = ImGui::CollapsingHeader("Push Constants");
+
+	if (isHeaderOpen)
+	{
+		ImGui::Indent();
+		ImGui::Text("Size: %u / %u bytes", pushConstantBlock->padded_size, m_Renderer->GetDevice()->GetMaxPushConstantsSize());
+	}
+
+	// Values are pushed while recording every frame, so editing them doesn't touch any buffer or descriptor.
+	ImGui::PushID("PushConstants");
+	DrawUniformBufferInput(pushConstantBlock, m_Renderer->GetPushConstantMemory(), m_Renderer->GetPushConstantVectorState(), isHeaderOpen);
+	ImGui::PopID();
+
+	if (isHeaderOpen)
+	{
+		ImGui::Unindent();
+		ImGui::Spacing();
+	}
+}
+
+void UserInterface::ImguiLogWindow()
+{
+	if (!ImGui::Begin("Log"))
+	{
+		ImGui::End();
+		return;
+	}
+
+	ImGui::SameLine();
+	ImGui::SetWindowFontScale(1.25f);
+	ImGui::Text("Output");
+	ImGui::SetWindowFontScale(1.0f);
+
+	ImGui::Separator();
+	ImGui::BeginChild("scrolling", ImVec2(0, 0), false,
+		ImGuiWindowFlags_AlwaysHorizontalScrollbar | ImGuiWindowFlags_AlwaysVerticalScrollbar);
+
+	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+	Logger::ReadText([](const char* inText) { ImGui::TextUnformatted(inText); });
+	ImGui::PopStyleVar();
+
+	if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+	{
+		ImGui::SetScrollHereY(1.0f);
+	}
+
+	ImGui::EndChild();
+	ImGui::End();
+}
+
 void UserInterface::ImguiBindingsWindow()
 {
 	static const ImVec2 DefaultWindowSize = ImVec2(400, 400);
@@ -1172,6 +1579,13 @@ void UserInterface::ImguiBindingsWindow()
 	ImGui::SetWindowFontScale(1.0f);
 	ImGui::Separator();
 
+	// Switching a variant can change the bindings, so it has to happen before descriptors are gathered.
+	DrawShaderVariants();
+	DrawSpecializationConstants();
+	DrawPrecisionComparison();
+	DrawMemoryStatistics();
+	DrawPushConstants();
+
 	auto& descriptors = m_Renderer->GetDescriptors();
 
 	for (uint32_t descriptorIndex = 0; descriptorIndex < descriptors.size(); ++descriptorIndex)
@@ -1246,6 +1660,30 @@ void UserInterface::ImguiBindingsWindow()
 			break;
 		}
 
+		case ResourceType::StorageBuffer:
+		{
+			DrawStorageBuffer(descriptor, isHeaderOpen);
+
+			break;
+		}
+
+		case ResourceType::TextureArray:
+		{
+			DrawTextureArray(descriptor, isHeaderOpen);
+
+			if (isHeaderOpen)
+			{
+				ImGui::Spacing();
+				ImGui::Separator();
+				ImGui::Spacing();
+			}
+
+			SamplerInfo samplerInfo = descriptor.Resource.Handle.TextureArray->GetSampler()->GetInfo();
+			DrawSampler(samplerInfo, descriptor, isHeaderOpen);
+
+			break;
+		}
+
 		default:
 			FT_FAIL("Unsupported ResourceType.");
 		}
@@ -1262,17 +1700,28 @@ void UserInterface::ImguiBindingsWindow()
 
 void UserInterface::DisplayErrorMarkers(const std::string& message)
 {
-	char line[10];
-	int j = 0;
-	const uint32_t ignoreCharacterCount = 9;
-	for (int i = ignoreCharacterCount; message[i] != ':'; ++i)
+	// Messages look like "ERROR: <source>:<line>: ...", where source is 0 for the edited shader and a path for includes.
+	const std::string errorPrefix = "ERROR: ";
+	const size_t sourceStart = message.find(errorPrefix);
+	if (sourceStart == std::string::npos)
 	{
-		line[j++] = message[i];
+		return;
 	}
 
-	line[j] = '\0';
+	const size_t lineEnd = message.find(": ", sourceStart + errorPrefix.length());
+	const size_t lineStart = lineEnd == std::string::npos ? std::string::npos : message.rfind(':', lineEnd - 1);
+	if (lineStart == std::string::npos || lineStart < sourceStart + errorPrefix.length())
+	{
+		return;
+	}
+
+	const std::string source = message.substr(sourceStart + errorPrefix.length(), lineStart - sourceStart - errorPrefix.length());
+	if (source != "0")
+	{
+		return;
+	}
 
-	int lineInt = atoi(line);
+	int lineInt = atoi(message.substr(lineStart + 1, lineEnd - lineStart - 1).c_str());
 
 	TextEditor::ErrorMarkers ems;
 	ems[lineInt] = message;
@@ -42,11 +42,19 @@ private:
 	void ImguiMenuBar();
 	void ImguiDockSpace();
 	void ImguiBindingsWindow();
+	void ImguiLogWindow();
+	void DrawShaderVariants();
+	void DrawSpecializationConstants();
+	void DrawPrecisionComparison();
+	void DrawMemoryStatistics();
+	void DrawPushConstants();
 	void DrawVectorInput(const SpvReflectTypeDescription* inReflectTypeDescription, unsigned char* inProxyMemory, unsigned char* inVectorState, const char* inName, bool inDraw);
 	void DrawStruct(const SpvReflectBlockVariable* inReflectBlock, unsigned char* inProxyMemory, unsigned char* inVectorState, const char* inName, bool inDraw);
 	void DrawMatrix(const SpvReflectBlockVariable* inReflectBlock, unsigned char* inProxyMemory, unsigned char* inVectorState, const char* inName, bool inDraw);
 	void DrawImage(const Descriptor& inDescriptor, bool inDraw);
 	void DrawSampler(const SamplerInfo& inSamplerInfo, const Descriptor& inDescriptor, bool inDraw);
+	void DrawStorageBuffer(const Descriptor& inDescriptor, bool inDraw);
+	void DrawTextureArray(const Descriptor& inDescriptor, bool inDraw);
 	void DrawUniformBufferInput(const SpvReflectBlockVariable* inReflectBlock, unsigned char* inProxyMemory, unsigned char* inVectorState, bool inDraw, const uint32_t inArrayDimension = 0, const char* inArrayNameSuffix = "");
 
 private:
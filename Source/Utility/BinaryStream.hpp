@@ -0,0 +1,46 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+// Helpers for flat binary payloads, values are written in native byte order and strings are length prefixed.
+template<typename T>
+inline void WriteBinaryValue(std::string& outBuffer, const T& inValue)
+{
+	outBuffer.append(reinterpret_cast<const char*>(&inValue), sizeof(T));
+}
+
+inline void WriteBinaryString(std::string& outBuffer, const std::string& inString)
+{
+	WriteBinaryValue(outBuffer, static_cast<uint32_t>(inString.length()));
+	outBuffer.append(inString);
+}
+
+template<typename T>
+inline bool ReadBinaryValue(const std::string& inBuffer, size_t& inOutOffset, T& outValue)
+{
+	if (inOutOffset + sizeof(T) > inBuffer.size())
+	{
+		return false;
+	}
+
+	memcpy(&outValue, inBuffer.data() + inOutOffset, sizeof(T));
+	inOutOffset += sizeof(T);
+
+	return true;
+}
+
+inline bool ReadBinaryString(const std::string& inBuffer, size_t& inOutOffset, std::string& outString)
+{
+	uint32_t length = 0;
+	if (!ReadBinaryValue(inBuffer, inOutOffset, length) || inOutOffset + length > inBuffer.size())
+	{
+		return false;
+	}
+
+	outString.assign(inBuffer.data() + inOutOffset, length);
+	inOutOffset += length;
+
+	return true;
+}
+
+FT_END_NAMESPACE
@@ -34,12 +34,17 @@ static nfdfilteritem_t GetShaderFileExtensionFilter(const ShaderFileExtension& i
 	return filterItem;
 }
 
-static std::vector<nfdfilteritem_t> GetShaderFileExtensionFilters()
+static std::vector<nfdfilteritem_t> GetShaderFileExtensionFilters(const bool inIncludePrecompiled)
 {
 	std::vector<nfdfilteritem_t> filterItems;
 
 	for (const auto& shaderFileExtension : g_SupportedShaderFileExtensions)
 	{
+		if (!inIncludePrecompiled && shaderFileExtension.Language == ShaderLanguage::SPIRV)
+		{
+			continue;
+		}
+
 		filterItems.push_back(GetShaderFileExtensionFilter(shaderFileExtension));
 	}
 
@@ -90,6 +95,13 @@ static bool OpenFileDialog(const std::vector<nfdfilteritem_t>& inFilterItems, st
 	const nfdresult_t result = NFD::OpenDialog(filePath, inFilterItems.data(), inFilterItems.size());
 	if (filePath && (result == NFD_OKAY || result == NFD_CANCEL))
 	{
+		// Without filters every file is accepted.
+		if (inFilterItems.empty())
+		{
+			outFilePath = filePath.get();
+			return true;
+		}
+
 		std::string extension = ExtractFileExtension(filePath.get());
 		for (const nfdfilteritem_t& filterItem : inFilterItems)
 		{
@@ -133,13 +145,14 @@ static bool SaveFileDialog(const std::vector<nfdfilteritem_t>& inFilterItems, st
 
 bool FileExplorer::OpenShaderDialog(std::string& outFilePath)
 {
-	const auto shaderFilters = GetShaderFileExtensionFilters();
+	const auto shaderFilters = GetShaderFileExtensionFilters(true);
 	return OpenFileDialog(shaderFilters, outFilePath);
 }
 
 bool FileExplorer::SaveShaderDialog(std::string& outFilePath)
 {
-	const std::vector<nfdfilteritem_t> shaderFilters = GetShaderFileExtensionFilters();
+	// New shaders start from the default source code, which only exists for the source languages.
+	const std::vector<nfdfilteritem_t> shaderFilters = GetShaderFileExtensionFilters(false);
 	return SaveFileDialog(shaderFilters, outFilePath);
 }
 
@@ -161,4 +174,40 @@ bool FileExplorer::SaveImageDialog(std::string& outFilePath)
 	return SaveFileDialog(imageFilters, outFilePath);
 }
 
+bool FileExplorer::OpenFolderDialog(std::string& outFolderPath)
+{
+	FT_CHECK(FileExplorer::s_NFDHandle != nullptr, "File dialog not initialized.");
+
+	NFD::UniquePath folderPath;
+
+	const nfdresult_t result = NFD::PickFolder(folderPath);
+	if (folderPath && result == NFD_OKAY)
+	{
+		outFolderPath = folderPath.get();
+		return true;
+	}
+
+	return false;
+}
+
+bool FileExplorer::IsImageFile(const std::string& inFilePath)
+{
+	const std::string extension = ExtractFileExtension(inFilePath);
+	for (const auto& imageFileExtension : SupportedImageFileExtensions)
+	{
+		if (imageFileExtension.Extension.compare(extension) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FileExplorer::OpenDataDialog(std::string& outFilePath)
+{
+	// Data files are raw binary blobs, their extension says nothing about the contents.
+	return OpenFileDialog(std::vector<nfdfilteritem_t>(), outFilePath);
+}
+
 FT_END_NAMESPACE
@@ -28,6 +28,11 @@ public:
 public:
 	static bool OpenImageDialog(std::string& outFilePath);
 	static bool SaveImageDialog(std::string& outFilePath);
+	static bool OpenFolderDialog(std::string& outFolderPath);
+	static bool IsImageFile(const std::string& inFilePath);
+
+public:
+	static bool OpenDataDialog(std::string& outFilePath);
 };
 
 FT_END_NAMESPACE
@@ -1,5 +1,18 @@
 #include "FilePath.h"
 
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#	include <direct.h>
+#	include <sys/utime.h>
+#else
+#	include <dirent.h>
+#	include <utime.h>
+#endif // _WIN32
+
 FT_BEGIN_NAMESPACE
 
 static void ConvertToWindowsPath(std::string& outPath)
@@ -207,4 +220,294 @@ std::string ExtractFileName(const std::string inFileName)
 	return ExtractLastWord(inFileName, '\\');
 }
 
+std::string ExtractDirectory(const std::string& inPath)
+{
+	const size_t lastSeparatorPosition = inPath.find_last_of("\\/");
+	if (lastSeparatorPosition == std::string::npos)
+	{
+		return "";
+	}
+
+	return inPath.substr(0, lastSeparatorPosition);
+}
+
+std::string CombinePath(const std::string& inDirectory, const std::string& inName)
+{
+	if (inDirectory.empty())
+	{
+		return inName;
+	}
+
+	const char lastCharacter = inDirectory[inDirectory.length() - 1];
+	if (lastCharacter == '\\' || lastCharacter == '/')
+	{
+		return inDirectory + inName;
+	}
+
+	return inDirectory + FOLDER_SEP + inName;
+}
+
+std::string NormalizePath(std::string inPath)
+{
+	ConvertToWindowsPath(inPath);
+
+	const bool isRooted = !inPath.empty() && inPath[0] == '\\';
+
+	// Unlike TokenizePath, this doesn't depend on the root path, so it also works for paths outside of it.
+	std::vector<std::string> pathTokens;
+	size_t tokenStart = 0;
+	while (tokenStart <= inPath.length())
+	{
+		size_t tokenEnd = inPath.find('\\', tokenStart);
+		if (tokenEnd == std::string::npos)
+		{
+			tokenEnd = inPath.length();
+		}
+
+		const std::string token = inPath.substr(tokenStart, tokenEnd - tokenStart);
+		if (token == "..")
+		{
+			if (!pathTokens.empty() && pathTokens.back() != "..")
+			{
+				pathTokens.pop_back();
+			}
+			else if (!isRooted)
+			{
+				pathTokens.push_back(token);
+			}
+		}
+		else if (!token.empty() && token != ".")
+		{
+			pathTokens.push_back(token);
+		}
+
+		tokenStart = tokenEnd + 1;
+	}
+
+	std::string normalizedPath = isRooted ? FOLDER_SEP : "";
+	for (uint32_t i = 0; i < pathTokens.size(); ++i)
+	{
+		normalizedPath += pathTokens[i];
+		if (i < (pathTokens.size() - 1))
+		{
+			normalizedPath += FOLDER_SEP;
+		}
+	}
+
+	return normalizedPath;
+}
+
+bool ReadBinaryFile(std::string inPath, std::string& outBuffer)
+{
+	ConvertToPlatformPath(inPath);
+
+	FILE* file = fopen(inPath.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fseek(file, 0L, SEEK_END);
+	const size_t fileByteCount = static_cast<size_t>(ftell(file));
+	fseek(file, 0L, SEEK_SET);
+
+	outBuffer.resize(fileByteCount);
+	const size_t bytesRead = fileByteCount > 0 ? fread(&outBuffer[0], sizeof(char), fileByteCount, file) : 0;
+	fclose(file);
+
+	return bytesRead == fileByteCount;
+}
+
+bool WriteBinaryFile(std::string inPath, const std::string& inBuffer)
+{
+	ConvertToPlatformPath(inPath);
+
+	FILE* file = fopen(inPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	const size_t bytesWritten = fwrite(inBuffer.data(), sizeof(char), inBuffer.size(), file);
+	const bool closed = fclose(file) == 0;
+
+	return closed && bytesWritten == inBuffer.size();
+}
+
+bool QueryFileInfo(std::string inPath, FileInfo& outFileInfo)
+{
+	outFileInfo.Path = inPath;
+	ConvertToPlatformPath(inPath);
+
+#ifdef _WIN32
+	struct _stat64 fileStatus;
+	if (_stat64(inPath.c_str(), &fileStatus) != 0)
+	{
+		return false;
+	}
+
+	// Stat only reports whole seconds, last write time is in 100 ns ticks since 1601.
+	WIN32_FILE_ATTRIBUTE_DATA fileAttributes;
+	if (!GetFileAttributesExA(inPath.c_str(), GetFileExInfoStandard, &fileAttributes))
+	{
+		return false;
+	}
+
+	const uint64_t lastWriteTicks = (static_cast<uint64_t>(fileAttributes.ftLastWriteTime.dwHighDateTime) << 32) | fileAttributes.ftLastWriteTime.dwLowDateTime;
+	outFileInfo.PreciseModificationTime = (static_cast<int64_t>(lastWriteTicks) - 116444736000000000ll) * 100;
+#else
+	struct stat fileStatus;
+	if (stat(inPath.c_str(), &fileStatus) != 0)
+	{
+		return false;
+	}
+
+	outFileInfo.PreciseModificationTime = static_cast<int64_t>(fileStatus.st_mtim.tv_sec) * 1000000000ll + static_cast<int64_t>(fileStatus.st_mtim.tv_nsec);
+#endif // _WIN32
+
+	outFileInfo.Size = static_cast<uint64_t>(fileStatus.st_size);
+	outFileInfo.ModificationTime = static_cast<int64_t>(fileStatus.st_mtime);
+
+	return true;
+}
+
+bool ListFiles(std::string inDirectoryPath, std::vector<FileInfo>& outFiles)
+{
+	std::string platformDirectoryPath = inDirectoryPath;
+	ConvertToPlatformPath(platformDirectoryPath);
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((platformDirectoryPath + "\\*").c_str(), &findData);
+	if (findHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	do
+	{
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			continue;
+		}
+
+		FileInfo fileInfo;
+		if (QueryFileInfo(CombinePath(inDirectoryPath, findData.cFileName), fileInfo))
+		{
+			outFiles.push_back(fileInfo);
+		}
+	}
+	while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+#else
+	DIR* directory = opendir(platformDirectoryPath.c_str());
+	if (directory == nullptr)
+	{
+		return false;
+	}
+
+	while (const dirent* entry = readdir(directory))
+	{
+		FileInfo fileInfo;
+		if (entry->d_type != DT_DIR && QueryFileInfo(CombinePath(inDirectoryPath, entry->d_name), fileInfo))
+		{
+			outFiles.push_back(fileInfo);
+		}
+	}
+
+	closedir(directory);
+#endif // _WIN32
+
+	return true;
+}
+
+bool ListDirectories(std::string inDirectoryPath, std::vector<std::string>& outDirectories)
+{
+	std::string platformDirectoryPath = inDirectoryPath;
+	ConvertToPlatformPath(platformDirectoryPath);
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((platformDirectoryPath + "\\*").c_str(), &findData);
+	if (findHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	do
+	{
+		const std::string directoryName = findData.cFileName;
+		if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && directoryName != "." && directoryName != "..")
+		{
+			outDirectories.push_back(CombinePath(inDirectoryPath, directoryName));
+		}
+	}
+	while (FindNextFileA(findHandle, &findData));
+
+	FindClose(findHandle);
+#else
+	DIR* directory = opendir(platformDirectoryPath.c_str());
+	if (directory == nullptr)
+	{
+		return false;
+	}
+
+	while (const dirent* entry = readdir(directory))
+	{
+		const std::string directoryName = entry->d_name;
+		if (entry->d_type == DT_DIR && directoryName != "." && directoryName != "..")
+		{
+			outDirectories.push_back(CombinePath(inDirectoryPath, directoryName));
+		}
+	}
+
+	closedir(directory);
+#endif // _WIN32
+
+	return true;
+}
+
+bool MakeDirectory(std::string inPath)
+{
+	ConvertToPlatformPath(inPath);
+
+#ifdef _WIN32
+	const int result = _mkdir(inPath.c_str());
+#else
+	const int result = mkdir(inPath.c_str(), 0755);
+#endif // _WIN32
+
+	return result == 0 || errno == EEXIST;
+}
+
+bool RemoveFile(std::string inPath)
+{
+	ConvertToPlatformPath(inPath);
+	return remove(inPath.c_str()) == 0;
+}
+
+bool RenameFile(std::string inOldPath, std::string inNewPath)
+{
+	ConvertToPlatformPath(inOldPath);
+	ConvertToPlatformPath(inNewPath);
+
+#ifdef _WIN32
+	return MoveFileExA(inOldPath.c_str(), inNewPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(inOldPath.c_str(), inNewPath.c_str()) == 0;
+#endif // _WIN32
+}
+
+void TouchFile(std::string inPath)
+{
+	ConvertToPlatformPath(inPath);
+
+#ifdef _WIN32
+	_utime(inPath.c_str(), nullptr);
+#else
+	utime(inPath.c_str(), nullptr);
+#endif // _WIN32
+}
+
 FT_END_NAMESPACE
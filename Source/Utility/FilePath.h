@@ -2,11 +2,33 @@
 
 FT_BEGIN_NAMESPACE
 
+struct FileInfo
+{
+	std::string Path;
+	uint64_t Size = 0;
+	int64_t ModificationTime = 0;
+
+	// Same time with the precision of the file system, in nanoseconds since the Unix epoch.
+	int64_t PreciseModificationTime = 0;
+};
+
 extern std::string ReadFile(std::string inPath);
 extern void WriteFile(std::string inPath, const std::string& inBuffer);
+extern bool ReadBinaryFile(std::string inPath, std::string& outBuffer);
+extern bool WriteBinaryFile(std::string inPath, const std::string& inBuffer);
+extern bool QueryFileInfo(std::string inPath, FileInfo& outFileInfo);
+extern bool ListFiles(std::string inDirectoryPath, std::vector<FileInfo>& outFiles);
+extern bool ListDirectories(std::string inDirectoryPath, std::vector<std::string>& outDirectories);
+extern bool MakeDirectory(std::string inPath);
+extern bool RemoveFile(std::string inPath);
+extern bool RenameFile(std::string inOldPath, std::string inNewPath);
+extern void TouchFile(std::string inPath);
 extern std::string GetAbsolutePath(std::string inRelativePath);
 extern std::string GetRelativePath(std::string inFullPath);
 extern std::string ExtractFileExtension(const std::string inFileName);
 extern std::string ExtractFileName(const std::string inFileName);
+extern std::string ExtractDirectory(const std::string& inPath);
+extern std::string CombinePath(const std::string& inDirectory, const std::string& inName);
+extern std::string NormalizePath(std::string inPath);
 
 FT_END_NAMESPACE
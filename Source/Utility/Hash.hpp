@@ -0,0 +1,43 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+// 64-bit FNV-1a, good enough for content addressing of shader sources and binaries.
+const uint64_t g_DefaultHashSeed = 14695981039346656037ull;
+
+inline uint64_t HashBytes(const void* inData, const size_t inSize, const uint64_t inSeed = g_DefaultHashSeed)
+{
+	const static uint64_t FnvPrime = 1099511628211ull;
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(inData);
+	uint64_t hash = inSeed;
+	for (size_t byteIndex = 0; byteIndex < inSize; ++byteIndex)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= FnvPrime;
+	}
+
+	return hash;
+}
+
+inline uint64_t HashString(const std::string& inString, const uint64_t inSeed = g_DefaultHashSeed)
+{
+	// Length is hashed as well, so concatenated strings can't collide by moving characters between them.
+	const uint64_t length = inString.length();
+	return HashBytes(inString.data(), inString.length(), HashBytes(&length, sizeof(length), inSeed));
+}
+
+template<typename T>
+inline uint64_t HashValue(const T& inValue, const uint64_t inSeed = g_DefaultHashSeed)
+{
+	return HashBytes(&inValue, sizeof(T), inSeed);
+}
+
+inline std::string HashToString(const uint64_t inHash)
+{
+	char hashText[17];
+	snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(inHash));
+	return std::string(hashText);
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,229 @@
+#include "LocalSocket.h"
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <winsock2.h>
+#	include <afunix.h>
+#else
+#	include <sys/socket.h>
+#	include <sys/time.h>
+#	include <sys/un.h>
+#	include <unistd.h>
+#	ifndef MSG_NOSIGNAL
+#		define MSG_NOSIGNAL 0
+#	endif // MSG_NOSIGNAL
+#endif // _WIN32
+
+FT_BEGIN_NAMESPACE
+
+#ifdef _WIN32
+static const LocalSocketHandle InvalidSocketHandle = static_cast<LocalSocketHandle>(INVALID_SOCKET);
+
+static void CloseSocketHandle(const LocalSocketHandle inHandle)
+{
+	closesocket(static_cast<SOCKET>(inHandle));
+}
+#else
+static const LocalSocketHandle InvalidSocketHandle = -1;
+
+static void CloseSocketHandle(const LocalSocketHandle inHandle)
+{
+	close(inHandle);
+}
+#endif // _WIN32
+
+static bool InitializeSockets()
+{
+#ifdef _WIN32
+	static std::once_flag s_InitializeFlag;
+	static bool s_Initialized = false;
+	std::call_once(s_InitializeFlag, []()
+		{
+			WSADATA data;
+			s_Initialized = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		});
+
+	return s_Initialized;
+#else
+	return true;
+#endif // _WIN32
+}
+
+static bool FillAddress(std::string inPath, sockaddr_un& outAddress)
+{
+	// Socket path is not a regular file, so it isn't converted by the file helpers.
+#ifdef _WIN32
+	std::replace(inPath.begin(), inPath.end(), '/', '\\');
+#else
+	std::replace(inPath.begin(), inPath.end(), '\\', '/');
+#endif // _WIN32
+
+	memset(&outAddress, 0, sizeof(outAddress));
+	outAddress.sun_family = AF_UNIX;
+
+	if (inPath.empty() || inPath.size() >= sizeof(outAddress.sun_path))
+	{
+		return false;
+	}
+
+	memcpy(outAddress.sun_path, inPath.c_str(), inPath.size());
+
+	return true;
+}
+
+LocalSocket::LocalSocket()
+	: m_Handle(InvalidSocketHandle) {}
+
+LocalSocket::~LocalSocket()
+{
+	Close();
+}
+
+bool LocalSocket::Create()
+{
+	Close();
+
+	if (!InitializeSockets())
+	{
+		return false;
+	}
+
+	m_Handle = static_cast<LocalSocketHandle>(socket(AF_UNIX, SOCK_STREAM, 0));
+
+	return IsValid();
+}
+
+bool LocalSocket::Connect(const std::string& inPath)
+{
+	sockaddr_un address;
+	if (!FillAddress(inPath, address) || !Create())
+	{
+		return false;
+	}
+
+	if (connect(m_Handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool LocalSocket::Listen(const std::string& inPath)
+{
+	sockaddr_un address;
+	if (!FillAddress(inPath, address) || !Create())
+	{
+		return false;
+	}
+
+	// Socket file of a server which didn't shut down cleanly would make bind fail.
+	RemoveFile(inPath);
+
+	const static int ConnectionBacklog = 16;
+	if (bind(m_Handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+		listen(m_Handle, ConnectionBacklog) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+LocalSocket* LocalSocket::Accept()
+{
+	const LocalSocketHandle handle = static_cast<LocalSocketHandle>(accept(m_Handle, nullptr, nullptr));
+	if (handle == InvalidSocketHandle)
+	{
+		return nullptr;
+	}
+
+	LocalSocket* acceptedSocket = new LocalSocket();
+	acceptedSocket->m_Handle = handle;
+
+	return acceptedSocket;
+}
+
+bool LocalSocket::SendAll(const void* inData, const size_t inSize)
+{
+	const char* data = static_cast<const char*>(inData);
+
+	size_t sentSize = 0;
+	while (sentSize < inSize)
+	{
+#ifdef _WIN32
+		const int result = send(m_Handle, data + sentSize, static_cast<int>(inSize - sentSize), 0);
+#else
+		const ssize_t result = send(m_Handle, data + sentSize, inSize - sentSize, MSG_NOSIGNAL);
+#endif // _WIN32
+
+		if (result <= 0)
+		{
+			return false;
+		}
+
+		sentSize += static_cast<size_t>(result);
+	}
+
+	return true;
+}
+
+bool LocalSocket::ReceiveAll(void* outData, const size_t inSize)
+{
+	char* data = static_cast<char*>(outData);
+
+	size_t receivedSize = 0;
+	while (receivedSize < inSize)
+	{
+#ifdef _WIN32
+		const int result = recv(m_Handle, data + receivedSize, static_cast<int>(inSize - receivedSize), 0);
+#else
+		const ssize_t result = recv(m_Handle, data + receivedSize, inSize - receivedSize, 0);
+#endif // _WIN32
+
+		// Zero means the other side closed the connection.
+		if (result <= 0)
+		{
+			return false;
+		}
+
+		receivedSize += static_cast<size_t>(result);
+	}
+
+	return true;
+}
+
+// Blocking sends and receives fail once nothing moves for the given time, so a hung peer can't block the caller forever.
+bool LocalSocket::SetTimeout(const uint32_t inMilliseconds)
+{
+#ifdef _WIN32
+	const DWORD timeout = static_cast<DWORD>(inMilliseconds);
+#else
+	timeval timeout{};
+	timeout.tv_sec = static_cast<time_t>(inMilliseconds / 1000);
+	timeout.tv_usec = static_cast<suseconds_t>((inMilliseconds % 1000) * 1000);
+#endif // _WIN32
+
+	const char* timeoutValue = reinterpret_cast<const char*>(&timeout);
+	return setsockopt(m_Handle, SOL_SOCKET, SO_RCVTIMEO, timeoutValue, sizeof(timeout)) == 0 &&
+		setsockopt(m_Handle, SOL_SOCKET, SO_SNDTIMEO, timeoutValue, sizeof(timeout)) == 0;
+}
+
+void LocalSocket::Close()
+{
+	if (IsValid())
+	{
+		CloseSocketHandle(m_Handle);
+		m_Handle = InvalidSocketHandle;
+	}
+}
+
+bool LocalSocket::IsValid() const
+{
+	return m_Handle != InvalidSocketHandle;
+}
+
+FT_END_NAMESPACE
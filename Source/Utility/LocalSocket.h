@@ -0,0 +1,39 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+#ifdef _WIN32
+typedef uintptr_t LocalSocketHandle;
+#else
+typedef int LocalSocketHandle;
+#endif // _WIN32
+
+// Stream socket bound to a file system path (AF_UNIX), for talking to other processes on the same machine.
+// Windows supports these sockets since Windows 10 version 1803.
+class LocalSocket
+{
+public:
+	LocalSocket();
+	~LocalSocket();
+	FT_DELETE_COPY_AND_MOVE(LocalSocket)
+
+public:
+	bool Connect(const std::string& inPath);
+	bool Listen(const std::string& inPath);
+	LocalSocket* Accept();
+	bool SendAll(const void* inData, const size_t inSize);
+	bool ReceiveAll(void* outData, const size_t inSize);
+	bool SetTimeout(const uint32_t inMilliseconds);
+	void Close();
+
+public:
+	bool IsValid() const;
+
+private:
+	bool Create();
+
+private:
+	LocalSocketHandle m_Handle;
+};
+
+FT_END_NAMESPACE
@@ -2,50 +2,58 @@
 
 FT_BEGIN_NAMESPACE
 
-ImGuiTextBuffer ImGuiLogger::s_TextBuffer;
+std::string Logger::s_Text;
+FILE* Logger::s_OutputStream = nullptr;
+std::mutex Logger::s_Mutex;
 
-void ImGuiLogger::Log(const char* inFormat, ...) IM_FMTARGS(2)
+void Logger::Log(const char* inFormat, ...)
 {
-	int oldSize = s_TextBuffer.size();
+	// Shaders are compiled on a background thread, which logs as well.
+	std::lock_guard<std::mutex> lock(s_Mutex);
+
 	va_list arguments;
 	va_start(arguments, inFormat);
-	s_TextBuffer.appendfv(inFormat, arguments);
-	va_end(arguments);
-}
-
-void ImGuiLogger::Clear()
-{
-	s_TextBuffer.clear();
-}
 
-void ImGuiLogger::Draw(const char* title)
-{
-	if (!ImGui::Begin(title))
+	if (s_OutputStream)
 	{
-		ImGui::End();
+		vfprintf(s_OutputStream, inFormat, arguments);
+		va_end(arguments);
 		return;
 	}
 
-	ImGui::SameLine();
-	ImGui::SetWindowFontScale(1.25f);
-	ImGui::Text("Output");
-	ImGui::SetWindowFontScale(1.0f);
-
-	ImGui::Separator();
-	ImGui::BeginChild("scrolling", ImVec2(0, 0), false,
-		ImGuiWindowFlags_AlwaysHorizontalScrollbar | ImGuiWindowFlags_AlwaysVerticalScrollbar);
+	va_list lengthArguments;
+	va_copy(lengthArguments, arguments);
+	const int length = vsnprintf(nullptr, 0, inFormat, lengthArguments);
+	va_end(lengthArguments);
 
-	ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-	ImGui::TextUnformatted(s_TextBuffer.begin());
-	ImGui::PopStyleVar();
-
-	if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+	if (length > 0)
 	{
-		ImGui::SetScrollHereY(1.0f);
+		// Formatted in place, including the terminator which is dropped right after.
+		const size_t offset = s_Text.size();
+		s_Text.resize(offset + length + 1);
+		vsnprintf(&s_Text[offset], length + 1, inFormat, arguments);
+		s_Text.resize(offset + length);
 	}
 
-	ImGui::EndChild();
-	ImGui::End();
+	va_end(arguments);
+}
+
+void Logger::Clear()
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_Text.clear();
+}
+
+void Logger::SetOutputStream(FILE* inOutputStream)
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_OutputStream = inOutputStream;
+}
+
+void Logger::ReadText(const std::function<void(const char*)>& inReader)
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	inReader(s_Text.c_str());
 }
 
 FT_END_NAMESPACE
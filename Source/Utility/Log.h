@@ -1,18 +1,23 @@
 #pragma once
 
-#define FT_LOG(fmt, ...) do { ImGuiLogger::Log(fmt, __VA_ARGS__); } while(0)
+#define FT_LOG(fmt, ...) do { Logger::Log(fmt, __VA_ARGS__); } while(0)
 
 FT_BEGIN_NAMESPACE
 
-class ImGuiLogger
+// Plain text log, so the compiler code shared with the headless tools doesn't depend on ImGui. Application draws the kept
+// text in its log window, tools without a window print every line to an output stream instead of keeping it.
+class Logger
 {
 public:
-	static void Log(const char* inFormat, ...) IM_FMTARGS(2);
+	static void Log(const char* inFormat, ...);
 	static void Clear();
-	static void Draw(const char* inTitle);
+	static void SetOutputStream(FILE* inOutputStream);
+	static void ReadText(const std::function<void(const char*)>& inReader);
 
 private:
-	static ImGuiTextBuffer s_TextBuffer;
+	static std::string s_Text;
+	static FILE* s_OutputStream;
+	static std::mutex s_Mutex;
 };
 
 FT_END_NAMESPACE
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif // _WIN32
+
+FT_BEGIN_NAMESPACE
+
+MappedFile::MappedFile(const std::string& inPath)
+	: m_Data(nullptr)
+	, m_Size(0)
+	, m_Path(inPath)
+#ifdef _WIN32
+	, m_FileHandle(INVALID_HANDLE_VALUE)
+	, m_MappingHandle(nullptr)
+#endif // _WIN32
+{
+#ifdef _WIN32
+	m_FileHandle = CreateFileA(m_Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_FileHandle == INVALID_HANDLE_VALUE)
+	{
+		FT_LOG("Failed opening %s for mapping.\n", m_Path.c_str());
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_FileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		FT_LOG("Failed mapping %s, file is empty.\n", m_Path.c_str());
+		return;
+	}
+
+	m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_MappingHandle == nullptr)
+	{
+		FT_LOG("Failed creating a file mapping of %s.\n", m_Path.c_str());
+		return;
+	}
+
+	const void* data = MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		FT_LOG("Failed mapping %s.\n", m_Path.c_str());
+		return;
+	}
+
+	m_Data = static_cast<const unsigned char*>(data);
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fileDescriptor = open(m_Path.c_str(), O_RDONLY);
+	if (fileDescriptor == -1)
+	{
+		FT_LOG("Failed opening %s for mapping.\n", m_Path.c_str());
+		return;
+	}
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		FT_LOG("Failed mapping %s, file is empty.\n", m_Path.c_str());
+		close(fileDescriptor);
+		return;
+	}
+
+	// Mapping keeps its own reference to the file, so the descriptor isn't needed afterwards.
+	void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+
+	if (data == MAP_FAILED)
+	{
+		FT_LOG("Failed mapping %s.\n", m_Path.c_str());
+		return;
+	}
+
+	// Data is read front to back exactly once while it's streamed to the GPU.
+	madvise(data, static_cast<size_t>(fileStatus.st_size), MADV_SEQUENTIAL);
+
+	m_Data = static_cast<const unsigned char*>(data);
+	m_Size = static_cast<size_t>(fileStatus.st_size);
+#endif // _WIN32
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (m_Data != nullptr)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+
+	if (m_MappingHandle != nullptr)
+	{
+		CloseHandle(m_MappingHandle);
+	}
+
+	if (m_FileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_FileHandle);
+	}
+#else
+	if (m_Data != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(m_Data), m_Size);
+	}
+#endif // _WIN32
+}
+
+FT_END_NAMESPACE
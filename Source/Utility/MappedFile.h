@@ -0,0 +1,31 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+// Read-only view of a whole file mapped into memory, pages are loaded by the OS only when they are touched.
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& inPath);
+
+public:
+	~MappedFile();
+	FT_DELETE_COPY_AND_MOVE(MappedFile)
+
+public:
+	bool IsValid() const { return m_Data != nullptr; }
+	const unsigned char* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+	const std::string& GetPath() const { return m_Path; }
+
+private:
+	const unsigned char* m_Data;
+	size_t m_Size;
+	std::string m_Path;
+#ifdef _WIN32
+	void* m_FileHandle;
+	void* m_MappingHandle;
+#endif // _WIN32
+};
+
+FT_END_NAMESPACE
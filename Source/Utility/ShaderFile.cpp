@@ -1,4 +1,5 @@
 #include "ShaderFile.h"
+#include "Compiler/ShaderOptimizer.h"
 
 FT_BEGIN_NAMESPACE
 
@@ -17,16 +18,154 @@ static ShaderLanguage ExtractShaderLanguage(const std::string inFileName)
 	FT_FAIL("Unsupported shader file extension.");
 }
 
+static ShaderOptimizationLevel ReadOptimizationLevel(const std::string& inPath, const rapidjson::Document& inDocumentJson)
+{
+	if (!inDocumentJson.HasMember("OptimizationLevel"))
+	{
+		return ShaderOptimizationLevel::None;
+	}
+
+	const rapidjson::Value& optimizationLevelJson = inDocumentJson["OptimizationLevel"];
+	if (!optimizationLevelJson.IsInt() ||
+		optimizationLevelJson.GetInt() < 0 ||
+		optimizationLevelJson.GetInt() >= static_cast<int>(ShaderOptimizationLevel::Count))
+	{
+		FT_LOG("Failed parsing OptimizationLevel from meta data of %s.\n", inPath.c_str());
+		return ShaderOptimizationLevel::None;
+	}
+
+	return ShaderOptimizationLevel(optimizationLevelJson.GetInt());
+}
+
+static std::vector<ShaderVariantDefine> ReadVariantDefines(const std::string& inPath, const rapidjson::Document& inDocumentJson)
+{
+	std::vector<ShaderVariantDefine> variantDefines;
+
+	if (!inDocumentJson.HasMember("Variants"))
+	{
+		return variantDefines;
+	}
+
+	const rapidjson::Value& variantsJson = inDocumentJson["Variants"];
+	if (!variantsJson.IsArray())
+	{
+		FT_LOG("Failed parsing Variants from meta data of %s.\n", inPath.c_str());
+		return variantDefines;
+	}
+
+	for (const rapidjson::Value& defineJson : variantsJson.GetArray())
+	{
+		if (!defineJson.IsObject() ||
+			!defineJson.HasMember("Name") || !defineJson["Name"].IsString() ||
+			!defineJson.HasMember("Values") || !defineJson["Values"].IsArray() ||
+			defineJson["Values"].Empty())
+		{
+			FT_LOG("Skipping invalid variant define in meta data of %s.\n", inPath.c_str());
+			continue;
+		}
+
+		ShaderVariantDefine variantDefine;
+		variantDefine.Name = defineJson["Name"].GetString();
+
+		for (const rapidjson::Value& valueJson : defineJson["Values"].GetArray())
+		{
+			// Plain numbers are the common case, so they are accepted next to strings.
+			if (valueJson.IsString())
+			{
+				variantDefine.Values.push_back(valueJson.GetString());
+			}
+			else if (valueJson.IsInt())
+			{
+				variantDefine.Values.push_back(std::to_string(valueJson.GetInt()));
+			}
+		}
+
+		if (variantDefine.Values.empty())
+		{
+			FT_LOG("Skipping variant define %s without valid values in meta data of %s.\n", variantDefine.Name.c_str(), inPath.c_str());
+			continue;
+		}
+
+		if (defineJson.HasMember("Selected") && defineJson["Selected"].IsUint() &&
+			defineJson["Selected"].GetUint() < variantDefine.Values.size())
+		{
+			variantDefine.SelectedValue = defineJson["Selected"].GetUint();
+		}
+
+		variantDefines.push_back(variantDefine);
+	}
+
+	return variantDefines;
+}
+
 ShaderFile::ShaderFile(const std::string& inPath)
 	: m_Path(inPath)
-	, m_SourceCode(ReadFile(inPath))
 	, m_Name(ExtractFileName(inPath))
-	, m_Language(ExtractShaderLanguage(inPath)) {}
+	, m_Language(ExtractShaderLanguage(inPath))
+	, m_OptimizationLevel(ShaderOptimizationLevel::None)
+{
+	if (IsPrecompiled())
+	{
+		ReloadSpvCode();
+		return;
+	}
+
+	m_SourceCode = ReadFile(inPath);
+	ReadCompileSettings();
+}
 
 void ShaderFile::UpdateSourceCode(const std::string& inSourceCode)
 {
+	FT_CHECK(!IsPrecompiled(), "SPIR-V shader files are read-only.");
+
 	m_SourceCode = inSourceCode;
 	WriteFile(m_Path, m_SourceCode);
 }
 
+void ShaderFile::SelectVariantValue(const uint32_t inDefineIndex, const uint32_t inValueIndex)
+{
+	FT_CHECK(inDefineIndex < m_VariantDefines.size() && inValueIndex < m_VariantDefines[inDefineIndex].Values.size(), "Variant value out of range.");
+	m_VariantDefines[inDefineIndex].SelectedValue = inValueIndex;
+}
+
+// Build systems overwrite SPIR-V files in place, so the previous module is kept when the new one can't be read.
+bool ShaderFile::ReloadSpvCode()
+{
+	FT_CHECK(IsPrecompiled(), "Only SPIR-V shader files can be reloaded.");
+
+	std::string spvBinary;
+	if (!ReadBinaryFile(m_Path, spvBinary) || spvBinary.empty() || spvBinary.size() % sizeof(uint32_t) != 0)
+	{
+		FT_LOG("Failed reading SPIR-V module from %s.\n", m_Path.c_str());
+		return false;
+	}
+
+	m_SpvCode.resize(spvBinary.size() / sizeof(uint32_t));
+	memcpy(m_SpvCode.data(), spvBinary.data(), spvBinary.size());
+	m_SourceCode = ShaderOptimizer::Disassemble(m_SpvCode);
+
+	return true;
+}
+
+// Compile settings have to be known before the first compilation, unlike the rest of the meta data,
+// which is applied to already reflected bindings.
+void ShaderFile::ReadCompileSettings()
+{
+	std::string metaDataJson;
+	if (!ReadBinaryFile(m_Path + ".meta", metaDataJson) || metaDataJson.empty())
+	{
+		return;
+	}
+
+	rapidjson::Document documentJson;
+	documentJson.Parse(metaDataJson.c_str());
+	if (!documentJson.IsObject())
+	{
+		return;
+	}
+
+	m_OptimizationLevel = ReadOptimizationLevel(m_Path, documentJson);
+	m_VariantDefines = ReadVariantDefines(m_Path, documentJson);
+}
+
 FT_END_NAMESPACE
@@ -7,6 +7,7 @@ enum class ShaderLanguage : uint8_t
 	None,
 	GLSL,
 	HLSL,
+	SPIRV,
 
 	Count
 };
@@ -21,11 +22,22 @@ struct ShaderFileExtension
 const ShaderFileExtension g_SupportedShaderFileExtensions[] =
 {
 	{ ShaderLanguage::GLSL, "glsl", "GLSL"},
-	{ ShaderLanguage::HLSL, "hlsl", "HLSL"}
+	{ ShaderLanguage::HLSL, "hlsl", "HLSL"},
+	{ ShaderLanguage::SPIRV, "spv", "SPIR-V"}
+};
+
+// Single axis of the shader permutation matrix, every combination of define values is a separate variant.
+struct ShaderVariantDefine
+{
+	std::string Name;
+	std::vector<std::string> Values;
+	uint32_t SelectedValue = 0;
 };
 
 class ResourceContainer;
+enum class ShaderOptimizationLevel : uint8_t;
 
+// Precompiled SPIR-V files are used as they are, their source code is a read-only disassembly of the module.
 class ShaderFile
 {
 public:
@@ -36,18 +48,31 @@ public:
 
 public:
 	void UpdateSourceCode(const std::string& inSourceCode);
+	void SetOptimizationLevel(const ShaderOptimizationLevel inOptimizationLevel) { m_OptimizationLevel = inOptimizationLevel; }
+	void SelectVariantValue(const uint32_t inDefineIndex, const uint32_t inValueIndex);
+	bool ReloadSpvCode();
 
 public:
 	const std::string& GetPath() const { return m_Path; }
 	const std::string& GetName() const { return m_Name; }
 	const std::string& GetSourceCode() const { return m_SourceCode; }
 	ShaderLanguage GetLanguage() const { return m_Language; }
+	bool IsPrecompiled() const { return m_Language == ShaderLanguage::SPIRV; }
+	const std::vector<uint32_t>& GetSpvCode() const { return m_SpvCode; }
+	ShaderOptimizationLevel GetOptimizationLevel() const { return m_OptimizationLevel; }
+	const std::vector<ShaderVariantDefine>& GetVariantDefines() const { return m_VariantDefines; }
+
+private:
+	void ReadCompileSettings();
 
 private:
 	std::string m_Path;
 	std::string m_SourceCode;
+	std::vector<uint32_t> m_SpvCode;
 	std::string m_Name;
 	ShaderLanguage m_Language;
+	ShaderOptimizationLevel m_OptimizationLevel;
+	std::vector<ShaderVariantDefine> m_VariantDefines;
 };
 
 FT_END_NAMESPACE
@@ -0,0 +1,392 @@
+#include "BatchCompiler.h"
+#include "Compiler/ShaderCompiler.h"
+#include "Compiler/ShaderCache.h"
+#include "Compiler/ShaderFileIncluder.h"
+#include "Core/Shader.h"
+#include "Utility/ShaderFile.h"
+
+#include <rapidjson/prettywriter.h>
+
+FT_BEGIN_NAMESPACE
+
+namespace BatchCompiler
+{
+	static const uint64_t ShaderCacheMaxSize = 1024ull * 1024ull * 1024ull;
+
+	struct Job
+	{
+		std::string SourcePath;
+		std::string RelativePath;
+		std::string OutputPath;
+	};
+
+	struct JobResult
+	{
+		ShaderCompileStatus Status = ShaderCompileStatus::Count;
+		std::string InfoLog;
+		double CompileTime = 0.0;
+		uint64_t ModuleSize = 0;
+		double ColdCompileTime = 0.0;
+		double WarmCompileTime = 0.0;
+		bool CacheHit = false;
+		bool OutputFailed = false;
+	};
+
+	static bool IsSupportedShaderFile(const std::string& inPath)
+	{
+		const std::string fileExtension = ExtractFileExtension(inPath);
+		for (const auto& supportedShaderFileExtension : g_SupportedShaderFileExtensions)
+		{
+			if (fileExtension == supportedShaderFileExtension.Extension)
+			{
+				// Precompiled modules have nothing to compile, and output directories are full of them.
+				return supportedShaderFileExtension.Language != ShaderLanguage::SPIRV;
+			}
+		}
+
+		return false;
+	}
+
+	// Output root is skipped when it lies inside the input tree, otherwise compiled outputs of earlier runs would be walked as input.
+	static bool CollectJobs(const std::string& inInputDirectory, const std::string& inOutputDirectory, const std::string& inRelativeDirectory,
+		const std::string& inOutputRootDirectory, std::vector<Job>& outJobs)
+	{
+		if (!MakeDirectory(inOutputDirectory))
+		{
+			fprintf(stderr, "Failed creating output directory %s.\n", inOutputDirectory.c_str());
+			return false;
+		}
+
+		std::vector<FileInfo> files;
+		if (!ListFiles(inInputDirectory, files))
+		{
+			fprintf(stderr, "Failed listing input directory %s.\n", inInputDirectory.c_str());
+			return false;
+		}
+
+		for (const FileInfo& file : files)
+		{
+			if (!IsSupportedShaderFile(file.Path))
+			{
+				continue;
+			}
+
+			const std::string fileName = ExtractFileName(file.Path);
+
+			Job job;
+			job.SourcePath = file.Path;
+			job.RelativePath = CombinePath(inRelativeDirectory, fileName);
+			job.OutputPath = CombinePath(inOutputDirectory, fileName);
+			outJobs.push_back(job);
+		}
+
+		std::vector<std::string> directories;
+		ListDirectories(inInputDirectory, directories);
+
+		for (const std::string& directory : directories)
+		{
+			if (NormalizePath(directory) == inOutputRootDirectory)
+			{
+				continue;
+			}
+
+			const std::string directoryName = ExtractFileName(directory);
+			if (!CollectJobs(directory, CombinePath(inOutputDirectory, directoryName), CombinePath(inRelativeDirectory, directoryName), inOutputRootDirectory, outJobs))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static const char* GetDescriptorTypeText(const VkDescriptorType inDescriptorType)
+	{
+		switch (inDescriptorType)
+		{
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			return "CombinedImageSampler";
+
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			return "UniformBuffer";
+
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			return "StorageBuffer";
+
+		case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			return "Image";
+
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			return "Sampler";
+
+		default:
+			return "Unknown";
+		}
+	}
+
+	static rapidjson::Value SerializeBlock(const SpvReflectBlockVariable& inBlock, rapidjson::Document::AllocatorType& inAllocator)
+	{
+		rapidjson::Value blockJson(rapidjson::kObjectType);
+
+		rapidjson::Value nameJson(inBlock.name != nullptr ? inBlock.name : "", inAllocator);
+		blockJson.AddMember("Name", nameJson, inAllocator);
+		blockJson.AddMember("Offset", inBlock.offset, inAllocator);
+		blockJson.AddMember("Size", inBlock.size, inAllocator);
+
+		rapidjson::Value membersJson(rapidjson::kArrayType);
+		for (uint32_t memberIndex = 0; memberIndex < inBlock.member_count; ++memberIndex)
+		{
+			membersJson.PushBack(SerializeBlock(inBlock.members[memberIndex], inAllocator), inAllocator);
+		}
+		blockJson.AddMember("Members", membersJson, inAllocator);
+
+		return blockJson;
+	}
+
+	static std::string SerializeReflection(const std::vector<uint32_t>& inSpvCode, const ShaderCompileResult& inCompileResult)
+	{
+		rapidjson::Document documentJson(rapidjson::kObjectType);
+		rapidjson::Document::AllocatorType& allocator = documentJson.GetAllocator();
+
+		SpvReflectShaderModule spvModule;
+		const std::vector<Binding> bindings = ReflectShader(inSpvCode, VK_SHADER_STAGE_FRAGMENT_BIT, spvModule);
+
+		rapidjson::Value bindingsJson(rapidjson::kArrayType);
+		for (const Binding& binding : bindings)
+		{
+			const SpvReflectDescriptorBinding& reflectBinding = binding.ReflectDescriptorBinding;
+
+			rapidjson::Value bindingJson(rapidjson::kObjectType);
+			rapidjson::Value nameJson(reflectBinding.name != nullptr ? reflectBinding.name : "", allocator);
+			bindingJson.AddMember("Name", nameJson, allocator);
+			bindingJson.AddMember("Set", reflectBinding.set, allocator);
+			bindingJson.AddMember("Binding", reflectBinding.binding, allocator);
+			bindingJson.AddMember("Count", reflectBinding.count, allocator);
+			bindingJson.AddMember("Type", rapidjson::StringRef(GetDescriptorTypeText(binding.DescriptorSetBinding.descriptorType)), allocator);
+
+			if (binding.DescriptorSetBinding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+			{
+				bindingJson.AddMember("Block", SerializeBlock(reflectBinding.block, allocator), allocator);
+			}
+
+			bindingsJson.PushBack(bindingJson, allocator);
+		}
+		documentJson.AddMember("Bindings", bindingsJson, allocator);
+
+		spvReflectDestroyShaderModule(&spvModule);
+
+		rapidjson::Value includedFilesJson(rapidjson::kArrayType);
+		for (const std::string& includedFile : inCompileResult.IncludedFiles)
+		{
+			rapidjson::Value includedFileJson(includedFile.c_str(), allocator);
+			includedFilesJson.PushBack(includedFileJson, allocator);
+		}
+		documentJson.AddMember("IncludedFiles", includedFilesJson, allocator);
+
+		rapidjson::StringBuffer buffer;
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		documentJson.Accept(writer);
+
+		return buffer.GetString();
+	}
+
+	// Cold compilations throw the thread's compiler context away first, so they register optimizer passes again. Glslang's
+	// built-in symbol tables are shared by the process and built when the compiler is initialized, so they are part of neither measurement.
+	static double MeasureCompileTime(const ShaderFile& inShaderFile, const ShaderCompileOptions& inCompileOptions, const uint32_t inIterations, const bool inResetContext)
+	{
+		double totalTime = 0.0;
+		for (uint32_t iteration = 0; iteration < inIterations; ++iteration)
+		{
+			if (inResetContext)
+			{
+				ShaderCompiler::ResetThreadContext();
+			}
+
+			const auto compileStartTime = std::chrono::high_resolution_clock::now();
+			ShaderCompiler::Compile(inShaderFile.GetLanguage(), ShaderStage::Fragment, inShaderFile.GetSourceCode(), inCompileOptions);
+			const auto compileEndTime = std::chrono::high_resolution_clock::now();
+
+			totalTime += std::chrono::duration<double, std::milli>(compileEndTime - compileStartTime).count();
+		}
+
+		return totalTime / inIterations;
+	}
+
+	static void ExecuteJob(const BatchCompilerOptions& inOptions, const Job& inJob, JobResult& outJobResult)
+	{
+		const ShaderFile shaderFile(inJob.SourcePath);
+
+		ShaderCompileOptions compileOptions;
+		compileOptions.SourcePath = inJob.SourcePath;
+		compileOptions.OptimizationLevel = inOptions.OverrideOptimizationLevel ? inOptions.OptimizationLevel : shaderFile.GetOptimizationLevel();
+
+		const auto compileStartTime = std::chrono::high_resolution_clock::now();
+		const ShaderCompileResult compileResult = ShaderCompiler::Compile(shaderFile.GetLanguage(), ShaderStage::Fragment, shaderFile.GetSourceCode(), compileOptions);
+		const auto compileEndTime = std::chrono::high_resolution_clock::now();
+
+		outJobResult.Status = compileResult.Status;
+		outJobResult.InfoLog = compileResult.InfoLog;
+		outJobResult.CompileTime = std::chrono::duration<double, std::milli>(compileEndTime - compileStartTime).count();
+		outJobResult.CacheHit = compileResult.CacheHit;
+
+		if (compileResult.Status != ShaderCompileStatus::Success)
+		{
+			return;
+		}
+
+		if (inOptions.BenchmarkIterations > 0)
+		{
+			outJobResult.ColdCompileTime = MeasureCompileTime(shaderFile, compileOptions, inOptions.BenchmarkIterations, true);
+			outJobResult.WarmCompileTime = MeasureCompileTime(shaderFile, compileOptions, inOptions.BenchmarkIterations, false);
+		}
+
+		outJobResult.ModuleSize = sizeof(uint32_t) * compileResult.SpvCode.size();
+
+		const std::string spvBuffer(reinterpret_cast<const char*>(compileResult.SpvCode.data()), outJobResult.ModuleSize);
+		outJobResult.OutputFailed =
+			!WriteBinaryFile(inJob.OutputPath + ".spv", spvBuffer) ||
+			!WriteBinaryFile(inJob.OutputPath + ".json", SerializeReflection(compileResult.SpvCode, compileResult));
+	}
+
+	static void PrintReport(const BatchCompilerOptions& inOptions, const std::vector<Job>& inJobs, const std::vector<JobResult>& inJobResults, const uint32_t inThreadCount, const double inTotalTime)
+	{
+		rapidjson::Document documentJson(rapidjson::kObjectType);
+		rapidjson::Document::AllocatorType& allocator = documentJson.GetAllocator();
+
+		uint32_t succeededCount = 0;
+		uint32_t failedCount = 0;
+		double totalColdCompileTime = 0.0;
+		double totalWarmCompileTime = 0.0;
+
+		rapidjson::Value filesJson(rapidjson::kArrayType);
+		for (size_t jobIndex = 0; jobIndex < inJobs.size(); ++jobIndex)
+		{
+			const JobResult& jobResult = inJobResults[jobIndex];
+			if (jobResult.Status == ShaderCompileStatus::Success && !jobResult.OutputFailed)
+			{
+				++succeededCount;
+			}
+			else
+			{
+				++failedCount;
+			}
+
+			rapidjson::Value fileJson(rapidjson::kObjectType);
+			rapidjson::Value pathJson(inJobs[jobIndex].RelativePath.c_str(), allocator);
+			fileJson.AddMember("Path", pathJson, allocator);
+			fileJson.AddMember("Status", rapidjson::StringRef(jobResult.OutputFailed ? "Output" : ShaderCompiler::GetStatusText(jobResult.Status)), allocator);
+			fileJson.AddMember("TimeMs", jobResult.CompileTime, allocator);
+			fileJson.AddMember("ModuleSize", static_cast<uint64_t>(jobResult.ModuleSize), allocator);
+			fileJson.AddMember("CacheHit", jobResult.CacheHit, allocator);
+
+			if (inOptions.BenchmarkIterations > 0)
+			{
+				fileJson.AddMember("ColdCompileTimeMs", jobResult.ColdCompileTime, allocator);
+				fileJson.AddMember("WarmCompileTimeMs", jobResult.WarmCompileTime, allocator);
+				totalColdCompileTime += jobResult.ColdCompileTime;
+				totalWarmCompileTime += jobResult.WarmCompileTime;
+			}
+
+			if (!jobResult.InfoLog.empty())
+			{
+				rapidjson::Value infoLogJson(jobResult.InfoLog.c_str(), allocator);
+				fileJson.AddMember("InfoLog", infoLogJson, allocator);
+			}
+
+			filesJson.PushBack(fileJson, allocator);
+		}
+
+		documentJson.AddMember("Files", filesJson, allocator);
+		documentJson.AddMember("Succeeded", succeededCount, allocator);
+		documentJson.AddMember("Failed", failedCount, allocator);
+		documentJson.AddMember("Threads", inThreadCount, allocator);
+		documentJson.AddMember("TotalTimeMs", inTotalTime, allocator);
+
+		if (inOptions.BenchmarkIterations > 0)
+		{
+			const double benchmarkedFileCount = std::max(static_cast<double>(succeededCount), 1.0);
+
+			rapidjson::Value benchmarkJson(rapidjson::kObjectType);
+			benchmarkJson.AddMember("Iterations", inOptions.BenchmarkIterations, allocator);
+			benchmarkJson.AddMember("ColdAverageCompileTimeMs", totalColdCompileTime / benchmarkedFileCount, allocator);
+			benchmarkJson.AddMember("WarmAverageCompileTimeMs", totalWarmCompileTime / benchmarkedFileCount, allocator);
+			documentJson.AddMember("Benchmark", benchmarkJson, allocator);
+		}
+
+		rapidjson::StringBuffer buffer;
+		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+		documentJson.Accept(writer);
+
+		fprintf(stdout, "%s\n", buffer.GetString());
+	}
+
+	BatchCompilerExitCode Run(const BatchCompilerOptions& inOptions)
+	{
+		std::vector<Job> jobs;
+		if (!CollectJobs(inOptions.InputDirectory, inOptions.OutputDirectory, "", NormalizePath(inOptions.OutputDirectory), jobs))
+		{
+			return BatchCompilerExitCode::OutputFailed;
+		}
+
+		ShaderCompiler::Initialize();
+		ShaderIncludes::SetSearchPaths(inOptions.IncludeDirectories);
+
+		// Cache hits would hide the compiler, and other threads would add noise to the measurements.
+		const bool benchmark = inOptions.BenchmarkIterations > 0;
+		if (!inOptions.CacheDirectory.empty() && !benchmark)
+		{
+			ShaderCache::Initialize(inOptions.CacheDirectory, ShaderCacheMaxSize);
+		}
+
+		const uint32_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		const uint32_t requestedThreadCount = benchmark ? 1u : inOptions.ThreadCount > 0 ? inOptions.ThreadCount : hardwareThreadCount;
+		const uint32_t threadCount = std::max(std::min(requestedThreadCount, static_cast<uint32_t>(jobs.size())), 1u);
+
+		// Jobs are handed out one at a time, so a few slow shaders don't leave the other threads idle.
+		std::vector<JobResult> jobResults(jobs.size());
+		std::atomic<size_t> nextJobIndex(0);
+		const auto workerFunction = [&]()
+		{
+			for (size_t jobIndex = nextJobIndex++; jobIndex < jobs.size(); jobIndex = nextJobIndex++)
+			{
+				ExecuteJob(inOptions, jobs[jobIndex], jobResults[jobIndex]);
+			}
+		};
+
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		std::vector<std::thread> threads;
+		for (uint32_t threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+		{
+			threads.push_back(std::thread(workerFunction));
+		}
+
+		workerFunction();
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		const auto endTime = std::chrono::high_resolution_clock::now();
+		PrintReport(inOptions, jobs, jobResults, threadCount, std::chrono::duration<double, std::milli>(endTime - startTime).count());
+
+		ShaderCache::Finalize();
+		ShaderCompiler::Finalize();
+
+		bool compilationFailed = false;
+		for (const JobResult& jobResult : jobResults)
+		{
+			if (jobResult.OutputFailed)
+			{
+				return BatchCompilerExitCode::OutputFailed;
+			}
+
+			compilationFailed |= jobResult.Status != ShaderCompileStatus::Success;
+		}
+
+		return compilationFailed ? BatchCompilerExitCode::CompilationFailed : BatchCompilerExitCode::Success;
+	}
+}
+
+FT_END_NAMESPACE
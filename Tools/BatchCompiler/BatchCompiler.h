@@ -0,0 +1,35 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+enum class ShaderOptimizationLevel : uint8_t;
+
+struct BatchCompilerOptions
+{
+	std::string InputDirectory;
+	std::string OutputDirectory;
+	std::string CacheDirectory;
+	std::vector<std::string> IncludeDirectories;
+	uint32_t ThreadCount = 0;
+	uint32_t BenchmarkIterations = 0;
+	bool OverrideOptimizationLevel = false;
+	ShaderOptimizationLevel OptimizationLevel;
+};
+
+// Process exit codes, so CI can tell failing shaders apart from a misconfigured invocation.
+enum class BatchCompilerExitCode : int
+{
+	Success = 0,
+	CompilationFailed = 1,
+	InvalidArguments = 2,
+	OutputFailed = 3
+};
+
+// Compiles every supported shader in a directory tree in parallel, writes .spv and reflection .json files
+// mirroring the input tree and prints a JSON report to the standard output.
+namespace BatchCompiler
+{
+	extern BatchCompilerExitCode Run(const BatchCompilerOptions& inOptions);
+}
+
+FT_END_NAMESPACE
@@ -0,0 +1,79 @@
+#include "BatchCompiler.h"
+#include "Compiler/ShaderOptimizer.h"
+
+static void PrintUsage()
+{
+	fprintf(stderr,
+		"Usage: FotonBatchCompiler <input directory> <output directory> [options]\n"
+		"Options:\n"
+		"  -O0, -O, -Os    Optimization level for all shaders, instead of the one from their .meta files.\n"
+		"  -I <directory>  Additional include search directory, can be repeated.\n"
+		"  -j <count>      Number of compile threads, all hardware threads are used by default.\n"
+		"  --cache <path>  Shader cache directory, caching is disabled by default.\n"
+		"  --benchmark <n> Compile every shader n times with a fresh and with a reused compiler context\n"
+		"                  on a single thread, without the cache, and report the average compile times.\n");
+}
+
+static std::string GetArgumentPath(const char* inArgument)
+{
+	const std::string path = FT::NormalizePath(inArgument);
+	return path.empty() ? "." : path;
+}
+
+int main(int argc, char** argv)
+{
+	// There's no log window, compiler messages go next to the rest of the diagnostics.
+	FT::Logger::SetOutputStream(stderr);
+
+	FT::BatchCompilerOptions options;
+
+	std::vector<std::string> positionalArguments;
+	for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+	{
+		const std::string argument = argv[argumentIndex];
+		const bool hasValue = argumentIndex + 1 < argc;
+
+		if (argument == "-O0" || argument == "-O" || argument == "-Os")
+		{
+			options.OverrideOptimizationLevel = true;
+			options.OptimizationLevel = argument == "-O0" ? FT::ShaderOptimizationLevel::None :
+				argument == "-O" ? FT::ShaderOptimizationLevel::Performance : FT::ShaderOptimizationLevel::Size;
+		}
+		else if (argument == "-I" && hasValue)
+		{
+			options.IncludeDirectories.push_back(GetArgumentPath(argv[++argumentIndex]));
+		}
+		else if (argument == "-j" && hasValue)
+		{
+			options.ThreadCount = static_cast<uint32_t>(atoi(argv[++argumentIndex]));
+		}
+		else if (argument == "--benchmark" && hasValue)
+		{
+			options.BenchmarkIterations = static_cast<uint32_t>(atoi(argv[++argumentIndex]));
+		}
+		else if (argument == "--cache" && hasValue)
+		{
+			options.CacheDirectory = GetArgumentPath(argv[++argumentIndex]);
+		}
+		else if (!argument.empty() && argument[0] != '-')
+		{
+			positionalArguments.push_back(GetArgumentPath(argument.c_str()));
+		}
+		else
+		{
+			PrintUsage();
+			return static_cast<int>(FT::BatchCompilerExitCode::InvalidArguments);
+		}
+	}
+
+	if (positionalArguments.size() != 2)
+	{
+		PrintUsage();
+		return static_cast<int>(FT::BatchCompilerExitCode::InvalidArguments);
+	}
+
+	options.InputDirectory = positionalArguments[0];
+	options.OutputDirectory = positionalArguments[1];
+
+	return static_cast<int>(FT::BatchCompiler::Run(options));
+}
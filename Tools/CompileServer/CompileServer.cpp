@@ -0,0 +1,175 @@
+#include "CompileServer.h"
+#include "Compiler/ShaderCompiler.h"
+#include "Compiler/ShaderCompileProtocol.h"
+#include "Compiler/ShaderCache.h"
+#include "Compiler/ShaderFileIncluder.h"
+#include "Utility/LocalSocket.h"
+
+#include <deque>
+
+FT_BEGIN_NAMESPACE
+
+namespace CompileServer
+{
+	static const uint64_t ShaderCacheMaxSize = 1024ull * 1024ull * 1024ull;
+
+	struct Connection
+	{
+		std::unique_ptr<LocalSocket> Socket;
+
+		// Workers finish requests of the same connection in any order, messages must not interleave.
+		std::mutex SendMutex;
+	};
+
+	struct Job
+	{
+		std::shared_ptr<Connection> Client;
+		uint64_t RequestId = 0;
+		ShaderCompileRequest Request;
+	};
+
+	static std::mutex s_JobMutex;
+	static std::condition_variable s_JobCondition;
+	static std::deque<Job> s_Jobs;
+	static std::atomic<uint64_t> s_CompilationCount(0);
+	static bool s_Verbose = false;
+
+	static void PushJob(Job& inJob)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_JobMutex);
+			s_Jobs.push_back(std::move(inJob));
+		}
+
+		s_JobCondition.notify_one();
+	}
+
+	static Job PopJob()
+	{
+		std::unique_lock<std::mutex> lock(s_JobMutex);
+		s_JobCondition.wait(lock, []() { return !s_Jobs.empty(); });
+
+		Job job = std::move(s_Jobs.front());
+		s_Jobs.pop_front();
+
+		return job;
+	}
+
+	static void RunWorker()
+	{
+		while (true)
+		{
+			Job job = PopJob();
+
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			const ShaderCompileResult result = ShaderCompiler::Compile(job.Request.Language, job.Request.Stage, job.Request.SourceCode, job.Request.Options);
+			const auto endTime = std::chrono::high_resolution_clock::now();
+
+			const uint64_t compilationIndex = ++s_CompilationCount;
+			if (s_Verbose)
+			{
+				fprintf(stdout, "[%llu] %s: %s%s in %.2fms\n", static_cast<unsigned long long>(compilationIndex),
+					job.Request.Options.SourcePath.empty() ? "<unnamed>" : job.Request.Options.SourcePath.c_str(),
+					ShaderCompiler::GetStatusText(result.Status), result.CacheHit ? " (cache hit)" : "",
+					std::chrono::duration<double, std::milli>(endTime - startTime).count());
+				fflush(stdout);
+			}
+
+			// Failing to send means the client went away, its reader thread notices that as well and closes the connection.
+			std::lock_guard<std::mutex> lock(job.Client->SendMutex);
+			ShaderCompileProtocol::WriteMessage(*job.Client->Socket, ShaderCompileMessageType::CompileResult, job.RequestId, ShaderCompileProtocol::SerializeResult(result));
+		}
+	}
+
+	static void RunReader(std::shared_ptr<Connection> inClient)
+	{
+		while (true)
+		{
+			ShaderCompileMessageType messageType = ShaderCompileMessageType::Count;
+			uint64_t requestId = 0;
+			std::string payload;
+			if (!ShaderCompileProtocol::ReadMessage(*inClient->Socket, messageType, requestId, payload))
+			{
+				break;
+			}
+
+			Job job;
+			job.Client = inClient;
+			job.RequestId = requestId;
+			if (messageType != ShaderCompileMessageType::CompileRequest || !ShaderCompileProtocol::DeserializeRequest(payload, job.Request))
+			{
+				fprintf(stderr, "Received a malformed message, closing the connection.\n");
+				break;
+			}
+
+			PushJob(job);
+		}
+
+		// Pending jobs keep the connection alive, their results fail to send and get dropped.
+		std::lock_guard<std::mutex> lock(inClient->SendMutex);
+		inClient->Socket->Close();
+	}
+
+	CompileServerExitCode Run(const CompileServerOptions& inOptions)
+	{
+		// Listening removes a stale socket file, which must not happen while another server is still using it.
+		{
+			LocalSocket probe;
+			if (probe.Connect(inOptions.SocketPath))
+			{
+				fprintf(stderr, "Another compile server is already listening on %s.\n", inOptions.SocketPath.c_str());
+				return CompileServerExitCode::SocketFailed;
+			}
+		}
+
+		LocalSocket listener;
+		if (!listener.Listen(inOptions.SocketPath))
+		{
+			fprintf(stderr, "Failed listening on %s.\n", inOptions.SocketPath.c_str());
+			return CompileServerExitCode::SocketFailed;
+		}
+
+		s_Verbose = inOptions.Verbose;
+
+		ShaderCompiler::Initialize();
+		ShaderIncludes::SetSearchPaths(inOptions.IncludeDirectories);
+
+		if (!inOptions.CacheDirectory.empty())
+		{
+			ShaderCache::Initialize(inOptions.CacheDirectory, ShaderCacheMaxSize);
+			ShaderCache::SetMemoryBudget(inOptions.MemoryCacheSize);
+		}
+
+		const uint32_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		const uint32_t threadCount = inOptions.ThreadCount > 0 ? inOptions.ThreadCount : hardwareThreadCount;
+
+		// Workers and readers live as long as the process, the server is stopped by terminating it.
+		for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+		{
+			std::thread(RunWorker).detach();
+		}
+
+		fprintf(stdout, "Listening on %s with %u compile threads.\n", inOptions.SocketPath.c_str(), threadCount);
+		fflush(stdout);
+
+		while (listener.IsValid())
+		{
+			LocalSocket* acceptedSocket = listener.Accept();
+			if (acceptedSocket == nullptr)
+			{
+				continue;
+			}
+
+			std::shared_ptr<Connection> client = std::make_shared<Connection>();
+			client->Socket.reset(acceptedSocket);
+			std::thread(RunReader, client).detach();
+		}
+
+		ShaderCache::Finalize();
+		ShaderCompiler::Finalize();
+
+		return CompileServerExitCode::Success;
+	}
+}
+
+FT_END_NAMESPACE
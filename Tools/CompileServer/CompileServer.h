@@ -0,0 +1,29 @@
+#pragma once
+
+FT_BEGIN_NAMESPACE
+
+struct CompileServerOptions
+{
+	std::string SocketPath;
+	std::string CacheDirectory;
+	std::vector<std::string> IncludeDirectories;
+	uint32_t ThreadCount = 0;
+	uint64_t MemoryCacheSize = 0;
+	bool Verbose = false;
+};
+
+enum class CompileServerExitCode : int
+{
+	Success = 0,
+	InvalidArguments = 2,
+	SocketFailed = 3
+};
+
+// Long running process which compiles shaders for Foton instances on the same machine, so compiler contexts,
+// the in-memory cache and the on-disk cache stay warm across application restarts and are shared between instances.
+namespace CompileServer
+{
+	extern CompileServerExitCode Run(const CompileServerOptions& inOptions);
+}
+
+FT_END_NAMESPACE
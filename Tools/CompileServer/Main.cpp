@@ -0,0 +1,76 @@
+#include "CompileServer.h"
+#include "Compiler/ShaderCompileProtocol.h"
+
+static void PrintUsage()
+{
+	fprintf(stderr,
+		"Usage: FotonCompileServer [options]\n"
+		"Options:\n"
+		"  --socket <path>        Socket path to listen on, the same default path as Foton is used by default.\n"
+		"  -I <directory>         Additional include search directory, can be repeated.\n"
+		"  -j <count>             Number of compile threads, all hardware threads are used by default.\n"
+		"  --cache <path>         Shader cache directory, the ShaderCache directory next to the executable by default.\n"
+		"  --memory-cache <MB>    Size of the in-memory shader cache, 256MB by default.\n"
+		"  -v                     Print a line for every compilation.\n");
+}
+
+static std::string GetArgumentPath(const char* inArgument)
+{
+	const std::string path = FT::NormalizePath(inArgument);
+	return path.empty() ? "." : path;
+}
+
+int main(int argc, char** argv)
+{
+	// There's no log window, compiler messages go next to the rest of the diagnostics.
+	FT::Logger::SetOutputStream(stderr);
+
+	FT::CompileServerOptions options;
+	options.SocketPath = FT::ShaderCompileProtocol::GetDefaultSocketPath();
+	options.CacheDirectory = FT::GetAbsolutePath("ShaderCache");
+	options.MemoryCacheSize = 256ull * 1024ull * 1024ull;
+
+	for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+	{
+		const std::string argument = argv[argumentIndex];
+		const bool hasValue = argumentIndex + 1 < argc;
+
+		if (argument == "--socket" && hasValue)
+		{
+			options.SocketPath = argv[++argumentIndex];
+		}
+		else if (argument == "-I" && hasValue)
+		{
+			options.IncludeDirectories.push_back(GetArgumentPath(argv[++argumentIndex]));
+		}
+		else if (argument == "-j" && hasValue)
+		{
+			options.ThreadCount = static_cast<uint32_t>(atoi(argv[++argumentIndex]));
+		}
+		else if (argument == "--cache" && hasValue)
+		{
+			options.CacheDirectory = GetArgumentPath(argv[++argumentIndex]);
+		}
+		else if (argument == "--memory-cache" && hasValue)
+		{
+			options.MemoryCacheSize = static_cast<uint64_t>(atoi(argv[++argumentIndex])) * 1024ull * 1024ull;
+		}
+		else if (argument == "-v")
+		{
+			options.Verbose = true;
+		}
+		else
+		{
+			PrintUsage();
+			return static_cast<int>(FT::CompileServerExitCode::InvalidArguments);
+		}
+	}
+
+	if (options.SocketPath.empty())
+	{
+		PrintUsage();
+		return static_cast<int>(FT::CompileServerExitCode::InvalidArguments);
+	}
+
+	return static_cast<int>(FT::CompileServer::Run(options));
+}